@@ -593,6 +593,42 @@ start_perftest_daemon() {
 	eval "$3=$dmn_port"
 }
 
+#
+# Compare the shared memory latency of processes running on the same NUMA node
+# and on different nodes
+#
+run_ucx_perftest_numa() {
+	num_nodes=$(ls -d /sys/devices/system/node/node[0-9]* 2>/dev/null | wc -l)
+	if [ ${num_nodes} -lt 2 ]
+	then
+		echo "==== Not running NUMA latency test, found ${num_nodes} NUMA node(s) ===="
+		return
+	fi
+
+	ucx_perftest="$ucx_inst/bin/ucx_perftest"
+	uct_test_args="-d memory -x posix -t am_lat -s 64 -n 100000 -w 1000"
+
+	node0_cpus=($(expand_cpulist $(cat /sys/devices/system/node/node0/cpulist)))
+	node1_cpus=($(expand_cpulist $(cat /sys/devices/system/node/node1/cpulist)))
+	server_cpu=${node0_cpus[0]}
+
+	for client_cpu in ${node0_cpus[1]} ${node1_cpus[0]}
+	do
+		echo "==== Running posix latency test on cpus ${server_cpu} and ${client_cpu} ===="
+		server_port_arg="-p $server_port"
+		step_server_port
+
+		taskset -c ${server_cpu} ${ucx_perftest} ${uct_test_args} ${server_port_arg} &
+		server_pid=$!
+
+		sleep 5
+
+		taskset -c ${client_cpu} ${ucx_perftest} ${uct_test_args} \
+			$(hostname) ${server_port_arg}
+		wait ${server_pid}
+	done
+}
+
 #
 # Run UCX performance daemon test
 #
@@ -1179,6 +1215,7 @@ run_tests() {
 	do_distributed_task 1 4 run_uct_hello
 	do_distributed_task 2 4 run_ucx_perftest
 	do_distributed_task 3 4 run_io_demo
+	do_distributed_task 0 4 run_ucx_perftest_numa
 
 	# all are running gtest
 	run_gtest "default"
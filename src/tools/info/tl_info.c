@@ -214,6 +214,7 @@ static void print_iface_info(uct_worker_h worker, uct_md_h md,
             printf("#            am header: %s\n",
                    size_limit_to_str(0, iface_attr.cap.am.max_hdr));
         }
+        PRINT_CAP(AM_BCAST,  iface_attr.cap.flags, iface_attr.cap.am.max_bcopy);
 
         PRINT_CAP(TAG_EAGER_SHORT, iface_attr.cap.flags,
                   iface_attr.cap.tag.eager.max_short);
@@ -283,6 +284,9 @@ static void print_iface_info(uct_worker_h worker, uct_md_h md,
 
         printf("#      device priority: %d\n", iface_attr.priority);
         printf("#     device num paths: %d\n", iface_attr.dev_num_paths);
+        if (iface_attr.numa_node != UCS_NUMA_NODE_UNDEFINED) {
+            printf("#            numa node: %d\n", iface_attr.numa_node);
+        }
         printf("#              max eps: %s\n",
                ucs_memunits_to_str(iface_attr.max_num_eps, max_eps_str,
                                    sizeof(max_eps_str)));
@@ -19,12 +19,20 @@
 #include <stdint.h>
 #include <sched.h>
 #include <dirent.h>
+#include <unistd.h>
+#include <sys/syscall.h>
 
 #define UCS_NUMA_MIN_DISTANCE       10
 #define UCS_NUMA_NODE_MAX           INT16_MAX
 #define UCS_NUMA_CORE_DIR_PATH      UCS_SYS_FS_CPUS_PATH "/cpu%d"
 #define UCS_NUMA_NODES_DIR_PATH     UCS_SYS_FS_SYSTEM_PATH "/node"
 #define UCS_NUMA_NODE_DISTANCE_PATH UCS_NUMA_NODES_DIR_PATH "/node%d/distance"
+#define UCS_NUMA_MEM_MAX_NODES      1024
+#define UCS_NUMA_MEM_MASK_BITS      (8 * sizeof(unsigned long))
+
+/* Memory policy definitions from linux/mempolicy.h */
+#define UCS_NUMA_MPOL_PREFERRED     1
+#define UCS_NUMA_MPOL_MF_MOVE       UCS_BIT(1)
 
 
 KHASH_MAP_INIT_INT(numa_distance, ucs_numa_distance_t);
@@ -151,6 +159,31 @@ ucs_numa_node_t ucs_numa_node_of_cpu(int cpu)
     return cpu_numa_node[cpu] - 1;
 }
 
+ucs_numa_node_t ucs_numa_node_of_cpuset(const ucs_cpu_set_t *cpuset)
+{
+    unsigned num_cpus    = ucs_min(ucs_numa_num_configured_cpus(),
+                                   UCS_CPU_SETSIZE);
+    ucs_numa_node_t node = UCS_NUMA_NODE_UNDEFINED;
+    ucs_numa_node_t cpu_node;
+    unsigned cpu;
+
+    for (cpu = 0; cpu < num_cpus; ++cpu) {
+        if (!ucs_cpu_is_set(cpu, cpuset)) {
+            continue;
+        }
+
+        cpu_node = ucs_numa_node_of_cpu(cpu);
+        if ((cpu_node == UCS_NUMA_NODE_UNDEFINED) ||
+            ((node != UCS_NUMA_NODE_UNDEFINED) && (cpu_node != node))) {
+            return UCS_NUMA_NODE_UNDEFINED;
+        }
+
+        node = cpu_node;
+    }
+
+    return node;
+}
+
 ucs_numa_node_t ucs_numa_node_of_device(const char *dev_path)
 {
     long parsed_node;
@@ -253,6 +286,36 @@ ucs_numa_distance(ucs_numa_node_t node1, ucs_numa_node_t node2)
     return distance;
 }
 
+ucs_status_t
+ucs_numa_mem_set_node(void *address, size_t length, ucs_numa_node_t node)
+{
+#ifdef SYS_mbind
+    unsigned long nodemask[UCS_NUMA_MEM_MAX_NODES / UCS_NUMA_MEM_MASK_BITS];
+    long ret;
+
+    if ((node < 0) || (node >= UCS_NUMA_MEM_MAX_NODES)) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    memset(nodemask, 0, sizeof(nodemask));
+    nodemask[node / UCS_NUMA_MEM_MASK_BITS] = UCS_BIT(node %
+                                                      UCS_NUMA_MEM_MASK_BITS);
+
+    /* The kernel ignores the last bit of the mask, so pass one more */
+    ret = syscall(SYS_mbind, address, length, UCS_NUMA_MPOL_PREFERRED,
+                  nodemask, UCS_NUMA_MEM_MAX_NODES + 1, UCS_NUMA_MPOL_MF_MOVE);
+    if (ret < 0) {
+        ucs_debug("mbind(address=%p length=%zu node=%d) failed: %m", address,
+                  length, node);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    return UCS_OK;
+#else
+    return UCS_ERR_UNSUPPORTED;
+#endif
+}
+
 void ucs_numa_init()
 {
     ucs_spinlock_init(&ucs_numa_global_ctx.lock, 0);
@@ -8,6 +8,9 @@
 #define UCS_NUMA_H_
 
 #include <ucs/sys/compiler_def.h>
+#include <ucs/type/cpu_set.h>
+#include <ucs/type/status.h>
+#include <stddef.h>
 #include <stdint.h>
 
 BEGIN_C_DECLS
@@ -50,6 +53,15 @@ unsigned ucs_numa_num_configured_nodes();
 ucs_numa_node_t ucs_numa_node_of_cpu(int cpu);
 
 
+/**
+ * @param [in]  cpuset CPU set to query.
+ *
+ * @return The NUMA node that all CPUs in the set belong to, or
+ *         UCS_NUMA_NODE_UNDEFINED if the set is empty or spans several nodes.
+ */
+ucs_numa_node_t ucs_numa_node_of_cpuset(const ucs_cpu_set_t *cpuset);
+
+
 /**
  * @param [in]  dev_path sysfs path of the device.
  *
@@ -69,6 +81,20 @@ ucs_numa_node_t ucs_numa_node_of_device(const char *dev_path);
 ucs_numa_distance_t
 ucs_numa_distance(ucs_numa_node_t node1, ucs_numa_node_t node2);
 
+
+/**
+ * Set the preferred NUMA node of a memory range, and move the pages of the
+ * range which are already allocated on other nodes.
+ *
+ * @param [in]  address Page-aligned start address of the memory range.
+ * @param [in]  length  Length of the memory range.
+ * @param [in]  node    NUMA node to place the memory on.
+ *
+ * @return UCS_OK if the memory policy was set, or an error code otherwise.
+ */
+ucs_status_t
+ucs_numa_mem_set_node(void *address, size_t length, ucs_numa_node_t node);
+
 END_C_DECLS
 
 #endif
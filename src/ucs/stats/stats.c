@@ -107,15 +107,6 @@ static ucs_stats_class_t ucs_stats_root_node_class = {
     }
 };
 
-#ifdef HAVE_LINUX_FUTEX_H
-static inline int
-ucs_sys_futex(volatile void *addr1, int op, int val1, struct timespec *timeout,
-              void *uaddr2, int val3)
-{
-    return syscall(SYS_futex, addr1, op, val1, timeout, uaddr2, val3);
-}
-#endif
-
 static void ucs_stats_clean_node(ucs_stats_node_t *node) {
     ucs_stats_filter_node_t * temp_filter_node;
     ucs_stats_filter_node_t * filter_node;
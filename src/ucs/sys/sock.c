@@ -308,6 +308,10 @@ static ucs_status_t ucs_socket_check_errno(int io_errno)
     } else if (io_errno == EPIPE) {
         /* The local end has been shut down */
         return UCS_ERR_CONNECTION_RESET;
+    } else if (io_errno == ENOBUFS) {
+        /* Not enough memory for the socket buffers, or for tracking the
+         * zero-copy send operations */
+        return UCS_ERR_NO_MEMORY;
     }
 
     return UCS_ERR_IO_ERROR;
@@ -531,7 +535,7 @@ int ucs_socket_max_conn()
     }
 }
 
-static ucs_status_t
+ucs_status_t
 ucs_socket_handle_io_error(int fd, const char *name, ssize_t io_retval, int io_errno)
 {
     ucs_status_t status;
@@ -622,8 +626,9 @@ ucs_socket_do_io_b(int fd, void *data, size_t length,
 }
 
 static inline ucs_status_t
-ucs_socket_do_iov_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p,
-                     ucs_socket_iov_func_t iov_func, const char *name)
+ucs_socket_do_iov_nb(int fd, struct iovec *iov, size_t iov_cnt, int flags,
+                     size_t *length_p, ucs_socket_iov_func_t iov_func,
+                     const char *name)
 {
     struct msghdr msg = {
         .msg_iov    = iov,
@@ -631,7 +636,7 @@ ucs_socket_do_iov_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p
     };
     ssize_t ret;
 
-    ret = iov_func(fd, &msg, MSG_NOSIGNAL);
+    ret = iov_func(fd, &msg, flags | MSG_NOSIGNAL);
     return ucs_socket_handle_io(fd, iov, iov_cnt, length_p, 1, ret, errno, name);
 }
 
@@ -667,7 +672,16 @@ ucs_status_t ucs_socket_recv(int fd, void *data, size_t length)
 ucs_status_t
 ucs_socket_sendv_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p)
 {
-    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, length_p, sendmsg, "sendv");
+    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, 0, length_p, sendmsg,
+                                "sendv");
+}
+
+ucs_status_t ucs_socket_sendv_flags_nb(int fd, struct iovec *iov,
+                                       size_t iov_cnt, int flags,
+                                       size_t *length_p)
+{
+    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, flags, length_p, sendmsg,
+                                "sendv");
 }
 
 ucs_status_t ucs_sockaddr_sizeof(const struct sockaddr *addr, size_t *size_p)
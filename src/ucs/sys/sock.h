@@ -288,6 +288,25 @@ ucs_status_t ucs_socket_send_nb(int fd, const void *data, size_t *length_p);
 ucs_status_t ucs_socket_recv_nb(int fd, void *data, size_t *length_p);
 
 
+/**
+ * Convert the result of a failed send/recv operation, which was issued
+ * outside of @ref ucs_socket_send_nb or @ref ucs_socket_recv_nb, to a status.
+ *
+ * @param [in]  fd          Socket fd.
+ * @param [in]  name        Name of the operation, "recv" if @a io_retval
+ *                          may be 0.
+ * @param [in]  io_retval   Value returned by the operation: 0 if the
+ *                          connection was closed by the peer, negative
+ *                          otherwise.
+ * @param [in]  io_errno    Error code of the operation.
+ *
+ * @return UCS_ERR_NO_PROGRESS if the operation has to be retried, or an
+ *         error code which describes the failure.
+ */
+ucs_status_t ucs_socket_handle_io_error(int fd, const char *name,
+                                        ssize_t io_retval, int io_errno);
+
+
 /**
  * Blocking send operation sends data on the connected (or bound connectionless)
  * socket referred to by the file descriptor `fd`.
@@ -320,6 +339,26 @@ ucs_status_t ucs_socket_sendv_nb(int fd, struct iovec *iov, size_t iov_cnt,
                                  size_t *length_p);
 
 
+/**
+ * Same as @ref ucs_socket_sendv_nb, but passes additional flags to sendmsg().
+ *
+ * @param [in]      fd              Socket fd.
+ * @param [in]      iov             A pointer to an array of iovec buffers.
+ * @param [in]      iov_cnt         The number of buffers pointed to by
+ *                                  the iov parameter.
+ * @param [in]      flags           Flags to pass to sendmsg(), e.g. MSG_MORE
+ *                                  or MSG_ZEROCOPY.
+ * @param [out]     length_p        The amount of data transmitted is written to
+ *                                  this argument.
+ *
+ * @return UCS_OK on success or an error code on failure. UCS_ERR_NO_MEMORY is
+ *         returned if the kernel could not allocate the socket buffers.
+ */
+ucs_status_t ucs_socket_sendv_flags_nb(int fd, struct iovec *iov,
+                                       size_t iov_cnt, int flags,
+                                       size_t *length_p);
+
+
 /**
  * Blocking receive operation receives data from the connected (or bound
  * connectionless) socket referred to by the file descriptor `fd`.
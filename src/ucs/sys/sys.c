@@ -1520,6 +1520,17 @@ ucs_status_t ucs_sys_check_fd_limit_per_process()
     return UCS_OK;
 }
 
+int ucs_sys_futex(volatile void *addr1, int op, int val1,
+                  struct timespec *timeout, void *uaddr2, int val3)
+{
+#ifdef SYS_futex
+    return syscall(SYS_futex, addr1, op, val1, timeout, uaddr2, val3);
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
 ucs_status_t ucs_pthread_create(pthread_t *thread_id_p,
                                 void *(*start_routine)(void*), void *arg,
                                 const char *fmt, ...)
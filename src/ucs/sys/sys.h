@@ -642,6 +642,23 @@ ucs_status_t ucs_sys_enum_threads(ucs_sys_enum_threads_cb_t cb, void *arg);
 ucs_status_t ucs_sys_check_fd_limit_per_process();
 
 
+/**
+ * Invoke the futex system call.
+ *
+ * @param [in]  addr1      Address of the futex word.
+ * @param [in]  op         Futex operation, e.g FUTEX_WAIT or FUTEX_WAKE.
+ * @param [in]  val1       Operation-specific value.
+ * @param [in]  timeout    Timeout for wait operations, or NULL.
+ * @param [in]  uaddr2     Second futex word, for operations which need it.
+ * @param [in]  val3       Operation-specific value.
+ *
+ * @return The system call return value; -1 with errno set to ENOSYS if futex
+ *         is not supported on this platform.
+ */
+int ucs_sys_futex(volatile void *addr1, int op, int val1,
+                  struct timespec *timeout, void *uaddr2, int val3);
+
+
 /*
  * Create a named thread.
  *
@@ -18,6 +18,7 @@
 #include <ucs/datastruct/callbackq_compat.h>
 #include <ucs/datastruct/linear_func.h>
 #include <ucs/memory/memory_type.h>
+#include <ucs/memory/numa.h>
 #include <ucs/type/status.h>
 #include <ucs/type/thread_mode.h>
 #include <ucs/type/cpu_set.h>
@@ -437,6 +438,8 @@ typedef enum uct_atomic_op {
 
         /* Interface capability */
 #define UCT_IFACE_FLAG_INTER_NODE      UCS_BIT(54) /**< Interface is inter-node capable */
+#define UCT_IFACE_FLAG_AM_BCAST        UCS_BIT(55) /**< Broadcast active message, see
+                                                         @ref uct_iface_am_bcast_bcopy */
 /**
  * @}
  */
@@ -1175,6 +1178,10 @@ struct uct_iface_attr {
                                                 achieve higher total bandwidth
                                                 compared to using only a single
                                                 endpoint. */
+    ucs_numa_node_t          numa_node;    /**< NUMA node which the interface
+                                                receive resources are placed on,
+                                                or UCS_NUMA_NODE_UNDEFINED if
+                                                they are not bound to a node. */
 };
 
 
@@ -1057,6 +1057,39 @@ int uct_iface_is_reachable_v2(uct_iface_h iface,
                               const uct_iface_is_reachable_params_t *params);
 
 
+/**
+ * @ingroup UCT_AM
+ * @brief Broadcast a buffered active message.
+ *
+ * Send an active message to every interface which has an endpoint connected
+ * to @a iface. The message is written once, to a ring which the receivers
+ * read in place, so the cost of the send does not depend on the number of
+ * receivers. A receiver gets the messages which were sent after its first
+ * endpoint to @a iface was created, in the order they were sent, and until
+ * its last endpoint to @a iface is destroyed. The receive callback is invoked
+ * without @ref UCT_CB_PARAM_FLAG_DESC. Broadcast messages are not ordered
+ * with respect to the messages sent on endpoints, and do not generate
+ * wakeup events on the receivers.
+ *
+ * The interface must support @ref UCT_IFACE_FLAG_AM_BCAST.
+ *
+ * @param [in]  iface    Interface to broadcast the message from.
+ * @param [in]  id       Active message id. Must be in range
+ *                       0..UCT_AM_ID_MAX-1.
+ * @param [in]  pack_cb  User callback to pack the data, up to
+ *                       @ref uct_iface_attr_t::cap::am::max_bcopy bytes.
+ * @param [in]  arg      Custom argument to @a pack_cb.
+ * @param [in]  flags    Reserved for future use, must be 0.
+ *
+ * @return Size of the data packed by @a pack_cb, or UCS_ERR_NO_RESOURCE if
+ *         one of the receivers did not consume the previous messages yet.
+ *         Otherwise, an error code as defined by @ref ucs_status_t.
+ */
+ssize_t uct_iface_am_bcast_bcopy(uct_iface_h iface, uint8_t id,
+                                 uct_pack_callback_t pack_cb, void *arg,
+                                 unsigned flags);
+
+
 /**
  * @ingroup UCT_RESOURCE
  * @brief Connect endpoint to a remote endpoint.
@@ -373,6 +373,16 @@ int uct_ep_is_connected(uct_ep_h ep, const uct_ep_is_connected_params_t *params)
     return iface->internal_ops->ep_is_connected(ep, params);
 }
 
+ssize_t uct_iface_am_bcast_bcopy(uct_iface_h tl_iface, uint8_t id,
+                                 uct_pack_callback_t pack_cb, void *arg,
+                                 unsigned flags)
+{
+    const uct_base_iface_t *iface = ucs_derived_of(tl_iface, uct_base_iface_t);
+
+    return iface->internal_ops->iface_am_bcast_bcopy(tl_iface, id, pack_cb,
+                                                     arg, flags);
+}
+
 ucs_status_t uct_ep_check(const uct_ep_h ep, unsigned flags,
                           uct_completion_t *comp)
 {
@@ -504,6 +514,7 @@ void uct_base_iface_query(uct_base_iface_t *iface, uct_iface_attr_t *iface_attr)
 
     iface_attr->max_num_eps   = iface->config.max_num_eps;
     iface_attr->dev_num_paths = 1;
+    iface_attr->numa_node     = UCS_NUMA_NODE_UNDEFINED;
 }
 
 ucs_status_t
@@ -654,6 +665,7 @@ UCS_CLASS_INIT_FUNC(uct_base_iface_t, uct_iface_ops_t *ops,
     ucs_assert(internal_ops->iface_vfs_refresh != NULL);
     ucs_assert(internal_ops->ep_query != NULL);
     ucs_assert(internal_ops->ep_invalidate != NULL);
+    ucs_assert(internal_ops->iface_am_bcast_bcopy != NULL);
 
     self->md                = md;
     self->internal_ops      = internal_ops;
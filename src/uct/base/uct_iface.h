@@ -302,6 +302,12 @@ typedef int (*uct_ep_is_connected_func_t)(
         uct_ep_h ep, const uct_ep_is_connected_params_t *params);
 
 
+/* Broadcast a buffered active message to the connected peers */
+typedef ssize_t (*uct_iface_am_bcast_bcopy_func_t)(
+        uct_iface_h iface, uint8_t id, uct_pack_callback_t pack_cb, void *arg,
+        unsigned flags);
+
+
 /* Internal operations, not exposed by the external API */
 typedef struct uct_iface_internal_ops {
     uct_iface_estimate_perf_func_t   iface_estimate_perf;
@@ -311,6 +317,7 @@ typedef struct uct_iface_internal_ops {
     uct_ep_connect_to_ep_v2_func_t   ep_connect_to_ep_v2;
     uct_iface_is_reachable_v2_func_t iface_is_reachable_v2;
     uct_ep_is_connected_func_t       ep_is_connected;
+    uct_iface_am_bcast_bcopy_func_t  iface_am_bcast_bcopy;
 } uct_iface_internal_ops_t;
 
 
@@ -28,3 +28,17 @@ AC_CHECK_DECLS([IPPROTO_TCP, SOL_SOCKET, SO_KEEPALIVE,
                 [#include <netinet/in.h>]])
 AS_IF([test "x$tcp_keepalive_happy" != "xno"],
       [AC_DEFINE([UCT_TCP_EP_KEEPALIVE], 1, [Enable TCP keepalive configuration])]);
+AC_CHECK_DECLS([__NR_io_uring_setup, __NR_io_uring_enter, IORING_OP_RECV],
+               [],
+               [tcp_io_uring_happy=no],
+               [[#include <sys/syscall.h>]
+                [#include <linux/io_uring.h>]])
+AS_IF([test "x$tcp_io_uring_happy" != "xno"],
+      [AC_DEFINE([UCT_TCP_IO_URING], 1, [Enable TCP io_uring receive])]);
+AC_CHECK_DECLS([SO_ZEROCOPY, MSG_ZEROCOPY, SO_EE_ORIGIN_ZEROCOPY],
+               [],
+               [tcp_msg_zerocopy_happy=no],
+               [[#include <sys/socket.h>]
+                [#include <linux/errqueue.h>]])
+AS_IF([test "x$tcp_msg_zerocopy_happy" != "xno"],
+      [AC_DEFINE([UCT_TCP_MSG_ZEROCOPY], 1, [Enable TCP zero-copy send])]);
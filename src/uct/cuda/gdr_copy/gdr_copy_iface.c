@@ -213,7 +213,8 @@ static uct_iface_internal_ops_t uct_gdr_copy_iface_internal_ops = {
     .ep_invalidate         = (uct_ep_invalidate_func_t)ucs_empty_function_return_unsupported,
     .ep_connect_to_ep_v2   = ucs_empty_function_return_unsupported,
     .iface_is_reachable_v2 = uct_gdr_copy_iface_is_reachable_v2,
-    .ep_is_connected       = uct_base_ep_is_connected
+    .ep_is_connected       = uct_base_ep_is_connected,
+    .iface_am_bcast_bcopy  = (uct_iface_am_bcast_bcopy_func_t)ucs_empty_function_return_unsupported
 };
 
 static UCS_CLASS_INIT_FUNC(uct_gdr_copy_iface_t, uct_md_h md, uct_worker_h worker,
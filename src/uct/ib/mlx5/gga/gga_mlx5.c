@@ -631,7 +631,8 @@ static uct_rc_iface_ops_t uct_gga_mlx5_iface_ops = {
             .ep_invalidate         = uct_rc_mlx5_base_ep_invalidate,
             .ep_connect_to_ep_v2   = uct_gga_mlx5_ep_connect_to_ep_v2,
             .iface_is_reachable_v2 = uct_gga_mlx5_iface_is_reachable_v2,
-            .ep_is_connected       = ucs_empty_function_do_assert
+            .ep_is_connected       = ucs_empty_function_do_assert,
+            .iface_am_bcast_bcopy  = (uct_iface_am_bcast_bcopy_func_t)ucs_empty_function_return_unsupported
         },
         .create_cq      = uct_rc_mlx5_iface_common_create_cq,
         .destroy_cq     = uct_rc_mlx5_iface_common_destroy_cq,
@@ -0,0 +1,355 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2024. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "mm_iface.h"
+
+#include <ucs/arch/atomic.h>
+#include <signal.h>
+
+
+#define UCT_MM_BCAST_READERS_SIZE \
+    (UCT_MM_BCAST_MAX_READERS * sizeof(uct_mm_bcast_reader_t))
+
+
+static UCS_F_ALWAYS_INLINE uct_mm_bcast_elem_t*
+uct_mm_bcast_elem(uct_mm_bcast_ctl_t *ctl, void *elems, uint64_t sn)
+{
+    return UCS_PTR_BYTE_OFFSET(elems, (sn & (ctl->fifo_size - 1)) *
+                                      ctl->elem_size);
+}
+
+/* Set the FIFO pointers according to the beginning of the segment */
+static void uct_mm_bcast_set_ptrs(void *address, uct_mm_bcast_ctl_t **ctl_p,
+                                  uct_mm_bcast_reader_t **readers_p,
+                                  void **elems_p)
+{
+    uct_mm_bcast_ctl_t *ctl = (uct_mm_bcast_ctl_t*)
+            ucs_align_up_pow2((uintptr_t)address, UCS_SYS_CACHE_LINE_SIZE);
+
+    *ctl_p     = ctl;
+    *readers_p = (uct_mm_bcast_reader_t*)(ctl + 1);
+    *elems_p   = UCS_PTR_BYTE_OFFSET(ctl + 1, UCT_MM_BCAST_READERS_SIZE);
+}
+
+ucs_status_t uct_mm_iface_bcast_init(uct_mm_iface_t *iface, unsigned fifo_size)
+{
+    uct_mm_bcast_reader_t *readers;
+    uct_mm_bcast_elem_t *elem;
+    ucs_status_t status;
+    size_t elem_size;
+    size_t size;
+    unsigned i;
+
+    iface->bcast.ctl      = NULL;
+    iface->bcast.elems    = NULL;
+    iface->bcast.min_tail = 0;
+    iface->bcast.dispatch = NULL;
+    ucs_list_head_init(&iface->bcast.sources);
+
+    iface->recv_fifo_ctl->bcast_seg_id   = 0;
+    iface->recv_fifo_ctl->bcast_seg_size = 0;
+
+    if (fifo_size == 0) {
+        return UCS_OK;
+    }
+
+    if ((fifo_size <= 1) || !ucs_is_pow2(fifo_size)) {
+        ucs_error("The MM broadcast FIFO size must be a power of two and "
+                  "bigger than 1.");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    elem_size = ucs_align_up(sizeof(uct_mm_bcast_elem_t) +
+                             iface->config.seg_size, UCS_SYS_CACHE_LINE_SIZE);
+    size      = sizeof(uct_mm_bcast_ctl_t) + UCT_MM_BCAST_READERS_SIZE +
+                (fifo_size * elem_size) + (UCS_SYS_CACHE_LINE_SIZE - 1);
+
+    status = uct_iface_mem_alloc(&iface->super.super.super, size,
+                                 UCT_MD_MEM_ACCESS_ALL, "mm_bcast_fifo",
+                                 &iface->bcast.mem);
+    if (status != UCS_OK) {
+        ucs_error("mm_iface failed to allocate broadcast FIFO");
+        return status;
+    }
+
+    uct_mm_bcast_set_ptrs(iface->bcast.mem.address, &iface->bcast.ctl,
+                          &readers, &iface->bcast.elems);
+    iface->bcast.ctl->head        = 0;
+    iface->bcast.ctl->fifo_size   = fifo_size;
+    iface->bcast.ctl->elem_size   = elem_size;
+    iface->bcast.ctl->num_readers = UCT_MM_BCAST_MAX_READERS;
+    memset(readers, 0, UCT_MM_BCAST_READERS_SIZE);
+
+    /* the elements of the first round are not ready */
+    for (i = 0; i < fifo_size; ++i) {
+        elem     = uct_mm_bcast_elem(iface->bcast.ctl, iface->bcast.elems, i);
+        elem->sn = i - fifo_size;
+    }
+
+    iface->recv_fifo_ctl->bcast_seg_id   =
+            ((uct_mm_seg_t*)iface->bcast.mem.memh)->seg_id;
+    iface->recv_fifo_ctl->bcast_seg_size = size;
+    return UCS_OK;
+}
+
+void uct_mm_iface_bcast_cleanup(uct_mm_iface_t *iface)
+{
+    if (iface->bcast.ctl != NULL) {
+        uct_iface_mem_free(&iface->bcast.mem);
+    }
+}
+
+/* The writer releases the slot of a reader which exited without releasing it,
+ * so it would not wait for it forever */
+static int uct_mm_bcast_reader_is_alive(uct_mm_bcast_reader_t *reader)
+{
+    pid_t pid = reader->pid;
+
+    return (pid == 0) || (kill(pid, 0) == 0) || (errno != ESRCH);
+}
+
+static uint64_t uct_mm_bcast_min_tail(uct_mm_iface_t *iface, uint64_t head)
+{
+    uct_mm_bcast_ctl_t *ctl = iface->bcast.ctl;
+    uint64_t min_tail       = head;
+    uct_mm_bcast_reader_t *reader;
+    uint64_t tail;
+    unsigned i;
+
+    for (i = 0; i < ctl->num_readers; ++i) {
+        reader = &((uct_mm_bcast_reader_t*)(ctl + 1))[i];
+        if (!reader->active) {
+            continue;
+        }
+
+        tail = reader->tail;
+        if (((head - tail) >= ctl->fifo_size) &&
+            !uct_mm_bcast_reader_is_alive(reader)) {
+            ucs_debug("mm_iface %p: releasing broadcast reader %u of exited "
+                      "process %u", iface, i, reader->pid);
+            reader->active = 0;
+            ucs_memory_cpu_store_fence();
+            reader->pid    = 0;
+            continue;
+        }
+
+        if ((int64_t)(tail - min_tail) < 0) {
+            min_tail = tail;
+        }
+    }
+
+    /* read the elements only after the readers released them */
+    ucs_memory_cpu_load_fence();
+    return min_tail;
+}
+
+ssize_t uct_mm_iface_am_bcast_bcopy(uct_iface_h tl_iface, uint8_t id,
+                                    uct_pack_callback_t pack_cb, void *arg,
+                                    unsigned flags)
+{
+    uct_mm_iface_t *iface   = ucs_derived_of(tl_iface, uct_mm_iface_t);
+    uct_mm_bcast_ctl_t *ctl = iface->bcast.ctl;
+    uct_mm_bcast_elem_t *elem;
+    uint64_t head;
+    size_t length;
+
+    UCT_CHECK_AM_ID(id);
+
+    if (ctl == NULL) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    head = ctl->head;
+    if ((head - iface->bcast.min_tail) >= ctl->fifo_size) {
+        iface->bcast.min_tail = uct_mm_bcast_min_tail(iface, head);
+        if ((head - iface->bcast.min_tail) >= ctl->fifo_size) {
+            return UCS_ERR_NO_RESOURCE;
+        }
+    }
+
+    elem         = uct_mm_bcast_elem(ctl, iface->bcast.elems, head);
+    length       = pack_cb(elem + 1, arg);
+    elem->length = length;
+    elem->am_id  = id;
+
+    uct_iface_trace_am(&iface->super.super, UCT_AM_TRACE_TYPE_SEND, id,
+                       elem + 1, length, "TX BCAST [%lu]", head);
+
+    /* make sure the data is written before the readers see the element */
+    ucs_memory_cpu_store_fence();
+    elem->sn  = head;
+    ctl->head = head + 1;
+    return length;
+}
+
+void uct_mm_iface_bcast_subscribe(uct_mm_iface_t *iface,
+                                  uct_mm_iface_peer_t *peer)
+{
+    uct_mm_bcast_reader_t *readers;
+    uct_mm_bcast_source_t *source;
+    uct_mm_fifo_ctl_t *fifo_ctl;
+    uct_mm_seg_id_t seg_id;
+    ucs_status_t status;
+    void *fifo_elems;
+    uint64_t size;
+    unsigned i;
+
+    ucs_assert(peer->bcast == NULL);
+
+    uct_mm_iface_set_fifo_ptrs(iface, peer->fifo.super.address, 0, &fifo_ctl,
+                               &fifo_elems);
+    size   = fifo_ctl->bcast_seg_size;
+    seg_id = fifo_ctl->bcast_seg_id;
+    if (size == 0) {
+        return;
+    }
+
+    source = ucs_calloc(1, sizeof(*source), "mm_bcast_source");
+    if (source == NULL) {
+        ucs_error("failed to allocate mm broadcast FIFO descriptor");
+        return;
+    }
+
+    status = uct_mm_iface_mapper_call(iface, mem_attach, seg_id, size,
+                                      peer->iface_addr, &source->seg);
+    if (status != UCS_OK) {
+        ucs_diag("mm_iface %p: failed to attach broadcast FIFO id 0x%"PRIx64
+                 ": %s", iface, seg_id, ucs_status_string(status));
+        goto err_free;
+    }
+
+    uct_mm_bcast_set_ptrs(source->seg.address, &source->ctl, &readers,
+                          &source->elems);
+
+    /* claim a free reader slot */
+    for (i = 0; i < source->ctl->num_readers; ++i) {
+        if ((readers[i].pid == 0) &&
+            (ucs_atomic_cswap32(&readers[i].pid, 0, getpid()) == 0)) {
+            break;
+        }
+    }
+
+    if (i == source->ctl->num_readers) {
+        ucs_diag("mm_iface %p: no free reader slots in broadcast FIFO id "
+                 "0x%"PRIx64, iface, seg_id);
+        goto err_detach;
+    }
+
+    /* The writer may not see the slot as active yet, so start reading from the
+     * head which is read after activating it */
+    source->reader         = &readers[i];
+    source->reader->tail   = source->ctl->head;
+    source->reader->active = 1;
+    ucs_memory_cpu_fence();
+    source->tail           = source->ctl->head;
+    source->reader->tail   = source->tail;
+
+    ucs_list_add_tail(&iface->bcast.sources, &source->list);
+    peer->bcast = source;
+
+    ucs_debug("mm_iface %p: reading broadcast FIFO id 0x%"PRIx64" as reader "
+              "%u from %"PRIu64, iface, seg_id, i, source->tail);
+    return;
+
+err_detach:
+    uct_mm_iface_mapper_call(iface, mem_detach, &source->seg);
+err_free:
+    ucs_free(source);
+}
+
+static void
+uct_mm_bcast_source_destroy(uct_mm_iface_t *iface,
+                            uct_mm_bcast_source_t *source)
+{
+    ucs_list_del(&source->list);
+    uct_mm_iface_mapper_call(iface, mem_detach, &source->seg);
+    ucs_free(source);
+}
+
+void uct_mm_iface_bcast_unsubscribe(uct_mm_iface_t *iface,
+                                    uct_mm_iface_peer_t *peer)
+{
+    uct_mm_bcast_source_t *source = peer->bcast;
+
+    if (source == NULL) {
+        return;
+    }
+
+    peer->bcast            = NULL;
+    source->reader->active = 0;
+    ucs_memory_cpu_store_fence();
+    source->reader->pid    = 0;
+
+    if (source == iface->bcast.dispatch) {
+        /* released by the callback of its element, destroyed after it
+         * returns */
+        source->released = 1;
+    } else {
+        uct_mm_bcast_source_destroy(iface, source);
+    }
+}
+
+unsigned uct_mm_iface_bcast_progress(uct_mm_iface_t *iface)
+{
+    ucs_list_link_t *link = iface->bcast.sources.next;
+    uct_mm_bcast_source_t *source;
+    uct_mm_bcast_elem_t *elem;
+    unsigned count = 0;
+
+    while (link != &iface->bcast.sources) {
+        source = ucs_container_of(link, uct_mm_bcast_source_t, list);
+        elem   = uct_mm_bcast_elem(source->ctl, source->elems, source->tail);
+        if (elem->sn != source->tail) {
+            link = link->next;
+            continue;
+        }
+
+        ucs_memory_cpu_load_fence();
+        uct_iface_trace_am(&iface->super.super, UCT_AM_TRACE_TYPE_RECV,
+                           elem->am_id, elem + 1, elem->length,
+                           "RX BCAST [%lu]", source->tail);
+
+        /* the element is read in place, so it is released only after the
+         * callback returns */
+        iface->bcast.dispatch = source;
+        uct_iface_invoke_am(&iface->super.super, elem->am_id, elem + 1,
+                            elem->length, 0);
+        iface->bcast.dispatch = NULL;
+        ++count;
+
+        /* the callback may have destroyed other sources, but this one is still
+         * on the list, so it points to the next valid one */
+        link = link->next;
+        if (ucs_unlikely(source->released)) {
+            uct_mm_bcast_source_destroy(iface, source);
+            continue;
+        }
+
+        ucs_memory_cpu_store_fence();
+        source->reader->tail = ++source->tail;
+    }
+
+    return count;
+}
+
+int uct_mm_iface_bcast_has_data(uct_mm_iface_t *iface)
+{
+    uct_mm_bcast_source_t *source;
+    uct_mm_bcast_elem_t *elem;
+
+    ucs_list_for_each(source, &iface->bcast.sources, list) {
+        elem = uct_mm_bcast_elem(source->ctl, source->elems, source->tail);
+        if (elem->sn == source->tail) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -15,13 +15,18 @@
 
 #include <uct/base/uct_iov.inl>
 #include <ucs/arch/atomic.h>
+#ifdef HAVE_LINUX_FUTEX_H
+#include <linux/futex.h>
+#endif
 
 
 /* send modes */
 typedef enum {
     UCT_MM_SEND_AM_BCOPY,
     UCT_MM_SEND_AM_SHORT,
-    UCT_MM_SEND_AM_SHORT_IOV
+    UCT_MM_SEND_AM_SHORT_IOV,
+    UCT_MM_SEND_AM_BCOPY_IOV,
+    UCT_MM_SEND_AM_ZCOPY
 } uct_mm_send_op_t;
 
 
@@ -41,35 +46,9 @@ uct_mm_ep_attach_remote_seg(uct_mm_ep_t *ep, uct_mm_seg_id_t seg_id,
 {
     uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface,
                                            uct_mm_iface_t);
-    uct_mm_remote_seg_t *remote_seg;
-    ucs_status_t status;
-    khiter_t khiter;
-    int khret;
-
-    khiter = kh_put(uct_mm_remote_seg, &ep->remote_segs, seg_id, &khret);
-    if (khret == UCS_KH_PUT_FAILED) {
-        ucs_error("failed to add remote segment to mm ep hash");
-        return UCS_ERR_NO_MEMORY;
-    }
-
-    /* we expect the key would either be
-     * never used (BUCKET_EMPTY) or deleted (BUCKET_CLEAR) */
-    ucs_assert_always((khret == UCS_KH_PUT_BUCKET_EMPTY) ||
-                      (khret == UCS_KH_PUT_BUCKET_CLEAR));
-
-    remote_seg = &kh_val(&ep->remote_segs, khiter);
-
-    status = uct_mm_iface_mapper_call(iface, mem_attach, seg_id, length,
-                                      ep->remote_iface_addr, remote_seg);
-    if (status != UCS_OK) {
-        kh_del(uct_mm_remote_seg, &ep->remote_segs, khiter);
-        return status;
-    }
 
-    *address_p = remote_seg->address;
-    ucs_debug("mm_ep %p: attached remote segment id 0x%"PRIx64" at %p cookie %p",
-              ep, seg_id, remote_seg->address, remote_seg->cookie);
-    return UCS_OK;
+    return uct_mm_iface_rseg_attach(iface, ep->peer, seg_id, length,
+                                    address_p);
 }
 
 int uct_mm_ep_is_connected(const uct_ep_h tl_ep,
@@ -83,20 +62,25 @@ int uct_mm_ep_is_connected(const uct_ep_h tl_ep,
     }
 
     mm_addr = (uct_mm_iface_addr_t*)params->iface_addr;
-    return kh_get(uct_mm_remote_seg, &ep->remote_segs, mm_addr->fifo_seg_id) !=
-           kh_end(&ep->remote_segs);
+    return ep->peer->fifo.seg_id == mm_addr->fifo_seg_id;
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
 uct_mm_ep_get_remote_seg(uct_mm_ep_t *ep, uct_mm_seg_id_t seg_id, size_t length,
                          void **address_p)
 {
+    uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                           uct_mm_iface_t);
+    uct_mm_iface_rseg_t *rseg;
     khiter_t khiter;
 
     /* fast path - segment is already present */
-    khiter = kh_get(uct_mm_remote_seg, &ep->remote_segs, seg_id);
-    if (ucs_likely(khiter != kh_end(&ep->remote_segs))) {
-        *address_p = kh_val(&ep->remote_segs, khiter).address;
+    khiter = kh_get(uct_mm_iface_rseg, &ep->peer->segs, seg_id);
+    if (ucs_likely(khiter != kh_end(&ep->peer->segs))) {
+        rseg = kh_val(&ep->peer->segs, khiter);
+        uct_mm_iface_rseg_touch(iface, rseg);
+        ++iface->rseg_cache.hits;
+        *address_p = rseg->super.address;
         return UCS_OK;
     }
 
@@ -104,6 +88,26 @@ uct_mm_ep_get_remote_seg(uct_mm_ep_t *ep, uct_mm_seg_id_t seg_id, size_t length,
     return uct_mm_ep_attach_remote_seg(ep, seg_id, length, address_p);
 }
 
+/* wake up remote interface using the futex word in its FIFO control area */
+static void uct_mm_ep_wake_remote(uct_mm_ep_t *ep)
+{
+#ifdef HAVE_LINUX_FUTEX_H
+    uct_mm_fifo_ctl_t *ctl = ep->peer_ctl;
+
+    /* The atomic add is a full barrier, so the waiters flag is read after the
+     * new futex value is visible to the receiver */
+    ucs_atomic_add32(ucs_unaligned_ptr(&ctl->wakeup_seq), 1);
+    if (ctl->wakeup_waiters == 0) {
+        ucs_trace("ep %p: no remote waiters", ep);
+        return;
+    }
+
+    if (ucs_sys_futex(&ctl->wakeup_seq, FUTEX_WAKE, 1, NULL, NULL, 0) < 0) {
+        ucs_warn("failed to send futex wakeup: %m");
+    }
+#endif
+}
+
 /* send a signal to remote interface using Unix-domain socket */
 static void uct_mm_ep_signal_remote(uct_mm_ep_t *ep)
 {
@@ -113,10 +117,15 @@ static void uct_mm_ep_signal_remote(uct_mm_ep_t *ep)
 
     ucs_trace("ep %p: signal remote", ep);
 
+    if (ep->peer_ctl->wakeup_mode == UCT_MM_WAKEUP_MODE_FUTEX) {
+        uct_mm_ep_wake_remote(ep);
+        return;
+    }
+
     for (;;) {
         ret = sendto(iface->signal_fd, &dummy, sizeof(dummy), 0,
-                     (const struct sockaddr*)&ep->fifo_ctl->signal_sockaddr,
-                     ep->fifo_ctl->signal_addrlen);
+                     (const struct sockaddr*)&ep->peer_ctl->signal_sockaddr,
+                     ep->peer_ctl->signal_addrlen);
         if (ucs_unlikely(ret < 0)) {
             if (errno == EINTR) {
                 /* Interrupted system call - retry */
@@ -136,89 +145,255 @@ static void uct_mm_ep_signal_remote(uct_mm_ep_t *ep)
         } else {
             ucs_assert(ret == sizeof(dummy));
             ucs_trace("sent wakeup from socket %d to %s", iface->signal_fd,
-                      ep->fifo_ctl->signal_sockaddr.sun_path);
+                      ep->peer_ctl->signal_sockaddr.sun_path);
+            return;
+        }
+    }
+}
+
+/* Pick the remote FIFO lane for a new endpoint. Lanes are handed out in a
+ * round-robin order, so as long as there are no more senders than lanes, every
+ * sender writes to a ring of its own. The remote lane count is trimmed by the
+ * local one, since only that many lanes are covered by the local mapping. */
+static unsigned uct_mm_ep_assign_lane(uct_mm_ep_t *ep, uct_mm_iface_t *iface)
+{
+    unsigned num_lanes = ucs_min(ep->peer_ctl->num_lanes,
+                                 iface->config.fifo_lanes);
+
+    if (num_lanes <= 1) {
+        return 0;
+    }
+
+    return ucs_atomic_fadd32(ucs_unaligned_ptr(&ep->peer_ctl->next_lane), 1) %
+           num_lanes;
+}
+
+/* Check if the remote FIFO tail passed the element with the given sequence
+ * number, which means the receiver does not access the sender's buffer */
+static UCS_F_ALWAYS_INLINE int
+uct_mm_ep_zcopy_is_completed(uct_mm_ep_t *ep, uint64_t sn)
+{
+    uint64_t tail = ep->fifo_ctl->tail;
+
+    ucs_memory_cpu_load_fence();
+    return (int64_t)(tail - sn) > 0;
+}
+
+/* Prevent the receiver from reading the buffer of a zero-copy send which was
+ * not completed yet, so it could be released by the user. If the receiver
+ * already started reading it, wait until it is done. */
+static ucs_status_t
+uct_mm_ep_zcopy_cancel(uct_mm_ep_t *ep, uct_mm_iface_t *iface, uint64_t sn)
+{
+    uct_mm_fifo_element_t *elem;
+    uct_mm_zcopy_desc_t *zdesc;
+    uint32_t state;
+
+    if (uct_mm_ep_zcopy_is_completed(ep, sn)) {
+        return UCS_OK;
+    }
+
+    elem  = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo_elems,
+                                       sn & iface->fifo_mask);
+    zdesc = (uct_mm_zcopy_desc_t*)(elem + 1);
+    state = ucs_atomic_cswap32(ucs_unaligned_ptr(&zdesc->state),
+                               UCT_MM_ZCOPY_STATE_POSTED,
+                               UCT_MM_ZCOPY_STATE_CANCELED);
+    if (state != UCT_MM_ZCOPY_STATE_READING) {
+        return UCS_ERR_CANCELED;
+    }
+
+    /* the receiver may be in the same thread, calling us from its active
+     * message callback, so waiting for it is possible only in other process */
+    if (ep->peer_ctl->pid != getpid()) {
+        while (!uct_mm_ep_zcopy_is_completed(ep, sn) &&
+               !ep->peer_ctl->closed) {
+            sched_yield();
+        }
+    }
+
+    return UCS_OK;
+}
+
+/* Owner flag which passes a FIFO element with the given sequence number to the
+ * receiver. It flips after every FIFO wraparound */
+static UCS_F_ALWAYS_INLINE uint8_t
+uct_mm_ep_elem_owner_flag(uct_mm_iface_t *iface, uint64_t sn)
+{
+    return (sn & iface->config.fifo_size) ? UCT_MM_FIFO_ELEM_FLAG_OWNER : 0;
+}
+
+static UCS_F_ALWAYS_INLINE int uct_mm_ep_batch_has_elems(uct_mm_ep_t *ep)
+{
+    return ep->batch.next != ep->batch.end;
+}
+
+/* Reserve up to 'count' consecutive elements of the remote FIFO with a single
+ * update of its head */
+static void
+uct_mm_ep_batch_reserve(uct_mm_ep_t *ep, uct_mm_iface_t *iface, unsigned count)
+{
+    uint64_t head, prev_head;
+    int32_t num_free;
+
+    ucs_assert(!uct_mm_ep_batch_has_elems(ep));
+
+    head = ep->fifo_ctl->head;
+    for (;;) {
+        num_free = (int32_t)iface->config.fifo_size -
+                   (int32_t)(head - ep->cached_tail);
+        count    = ucs_min(count, ucs_max(num_free, 0));
+        if (count <= 1) {
+            /* not worth it, send using the regular path */
             return;
         }
+
+        prev_head = ucs_atomic_cswap64(ucs_unaligned_ptr(&ep->fifo_ctl->head),
+                                       head,
+                                       (head + count) &
+                                       ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED);
+        if (prev_head == head) {
+            break;
+        }
+
+        head = prev_head;
     }
+
+    ep->batch.start  = head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED;
+    ep->batch.next   = ep->batch.start;
+    ep->batch.end    = ep->batch.start + count;
+    ep->batch.signal = !!(head & UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED);
+    ucs_list_add_tail(&iface->batch_eps, &ep->batch.list);
+
+    ucs_trace_data("ep %p: reserved FIFO elements [%" PRIu64 "..%" PRIu64 ")",
+                   ep, ep->batch.start, ep->batch.end);
 }
 
-void uct_mm_ep_cleanup_remote_segs(uct_mm_ep_t *ep)
+/* Pass the reserved elements to the receiver, marking the ones which were not
+ * used as skipped */
+static void uct_mm_ep_batch_publish(uct_mm_ep_t *ep)
 {
     uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface,
                                            uct_mm_iface_t);
-    uct_mm_remote_seg_t remote_seg;
+    uct_mm_fifo_element_t *elem;
+    uint64_t sn;
+
+    ucs_trace_data("ep %p: publishing FIFO elements [%" PRIu64 "..%" PRIu64
+                   "), %" PRIu64 " unused", ep, ep->batch.start, ep->batch.end,
+                   ep->batch.end - ep->batch.next);
+
+    for (sn = ep->batch.next; sn != ep->batch.end; ++sn) {
+        elem        = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo_elems,
+                                                 sn & iface->fifo_mask);
+        elem->flags = UCT_MM_FIFO_ELEM_FLAG_NOP |
+                      (uct_mm_ep_elem_owner_flag(iface, sn) ^
+                       UCT_MM_FIFO_ELEM_FLAG_OWNER);
+    }
 
-    kh_foreach_value(&ep->remote_segs, remote_seg, {
-        uct_mm_iface_mapper_call(iface, mem_detach, &remote_seg);
-    })
+    /* one memory barrier for all the elements, before flipping their owner
+     * bits which the reader checks */
+    ucs_memory_cpu_store_fence();
+
+    for (sn = ep->batch.start; sn != ep->batch.end; ++sn) {
+        elem         = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo_elems,
+                                                  sn & iface->fifo_mask);
+        elem->flags ^= UCT_MM_FIFO_ELEM_FLAG_OWNER;
+    }
 
-    kh_destroy_inplace(uct_mm_remote_seg, &ep->remote_segs);
+    ep->batch.start = ep->batch.end;
+    ep->batch.next  = ep->batch.end;
+    ucs_list_del(&ep->batch.list);
+
+    if (ucs_unlikely(ep->batch.signal)) {
+        uct_mm_ep_signal_remote(ep);
+    }
+}
+
+void uct_mm_ep_batch_publish_all(uct_mm_iface_t *iface)
+{
+    uct_mm_ep_t *ep, *tmp;
+
+    ucs_list_for_each_safe(ep, tmp, &iface->batch_eps, batch.list) {
+        uct_mm_ep_batch_publish(ep);
+    }
 }
 
 static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, const uct_ep_params_t *params)
 {
     uct_mm_iface_t            *iface = ucs_derived_of(params->iface, uct_mm_iface_t);
-    uct_mm_md_t               *md    = ucs_derived_of(iface->super.super.md, uct_mm_md_t);
     const uct_mm_iface_addr_t *addr  = (const void *)params->iface_addr;
     ucs_status_t status;
-    void *fifo_ptr;
+    unsigned lane;
 
     UCT_EP_PARAMS_CHECK_DEV_IFACE_ADDRS(params);
     UCS_CLASS_CALL_SUPER_INIT(uct_base_ep_t, &iface->super.super);
 
-    kh_init_inplace(uct_mm_remote_seg, &self->remote_segs);
     ucs_arbiter_group_init(&self->arb_group);
 
-    /* save remote md address */
-    if (md->iface_addr_len > 0) {
-        self->remote_iface_addr = ucs_malloc(md->iface_addr_len, "mm_md_addr");
-        if (self->remote_iface_addr == NULL) {
-            status = UCS_ERR_NO_MEMORY;
-            goto err;
-        }
-
-        memcpy(self->remote_iface_addr, addr + 1, md->iface_addr_len);
-    } else {
-        self->remote_iface_addr = NULL;
-    }
-
-    /* Attach the remote FIFO, use the same method as bcopy descriptors */
-    status = uct_mm_ep_get_remote_seg(self, addr->fifo_seg_id,
-                                      UCT_MM_GET_FIFO_SIZE(iface), &fifo_ptr);
+    /* Attach the remote FIFO, or reuse it if it is already attached */
+    status = uct_mm_iface_peer_get(iface, addr, &self->peer);
     if (status != UCS_OK) {
         ucs_error("mm ep failed to connect to remote FIFO id 0x%"PRIx64": %s",
                   addr->fifo_seg_id, ucs_status_string(status));
-        goto err_free_md_addr;
+        goto err;
     }
 
     /* Initialize remote FIFO control structure */
-    uct_mm_iface_set_fifo_ptrs(fifo_ptr, &self->fifo_ctl, &self->fifo_elems);
-    self->cached_tail = self->fifo_ctl->tail;
+    uct_mm_iface_set_fifo_ptrs(iface, self->peer->fifo.super.address, 0,
+                               &self->peer_ctl, &self->fifo_elems);
+    lane = uct_mm_ep_assign_lane(self, iface);
+    uct_mm_iface_set_fifo_ptrs(iface, self->peer->fifo.super.address, lane,
+                               &self->fifo_ctl, &self->fifo_elems);
+    self->cached_tail   = self->fifo_ctl->tail;
+    self->zcopy_last_sn = self->cached_tail - 1;
+    self->pending_count = 0;
+    self->batch.start   = self->cached_tail;
+    self->batch.next    = self->cached_tail;
+    self->batch.end     = self->cached_tail;
     ucs_arbiter_elem_init(&self->arb_elem);
 
-    status = uct_ep_keepalive_init(&self->keepalive, self->fifo_ctl->pid);
+    status = uct_ep_keepalive_init(&self->keepalive, self->peer_ctl->pid);
     if (status != UCS_OK) {
-        goto err_free_segs;
+        goto err_put_peer;
     }
 
-    ucs_debug("created mm ep %p, connected to remote FIFO id 0x%"PRIx64,
-              self, addr->fifo_seg_id);
+    ucs_debug("created mm ep %p, connected to remote FIFO id 0x%"PRIx64
+              " lane %u", self, addr->fifo_seg_id, lane);
 
     return UCS_OK;
 
-err_free_segs:
-    uct_mm_ep_cleanup_remote_segs(self);
-err_free_md_addr:
-    ucs_free(self->remote_iface_addr);
+err_put_peer:
+    uct_mm_iface_peer_put(iface, self->peer);
 err:
     return status;
 }
 
 static UCS_CLASS_CLEANUP_FUNC(uct_mm_ep_t)
 {
+    uct_mm_iface_t *iface = ucs_derived_of(self->super.super.iface,
+                                           uct_mm_iface_t);
+    uct_mm_zcopy_op_t *op;
+    ucs_queue_iter_t iter;
+    ucs_status_t status;
+
+    /* complete or cancel the zero-copy operations of the endpoint */
+    ucs_queue_for_each_safe(op, iter, &iface->zcopy.ops, queue) {
+        if (op->ep == self) {
+            ucs_queue_del_iter(&iface->zcopy.ops, iter);
+            status = uct_mm_ep_zcopy_cancel(self, iface, op->sn);
+            if (op->comp != NULL) {
+                uct_invoke_completion(op->comp, status);
+            }
+            ucs_mpool_put(op);
+        }
+    }
+
     uct_mm_ep_pending_purge(&self->super.super, NULL, NULL);
-    uct_mm_ep_cleanup_remote_segs(self);
-    ucs_free(self->remote_iface_addr);
+    if (uct_mm_ep_batch_has_elems(self)) {
+        uct_mm_ep_batch_publish(self);
+    }
+
+    uct_mm_iface_peer_put(iface, self->peer);
 }
 
 UCS_CLASS_DEFINE(uct_mm_ep_t, uct_base_ep_t)
@@ -259,7 +434,7 @@ static UCS_F_ALWAYS_INLINE void uct_mm_ep_peer_check(uct_mm_ep_t *ep,
 {
     if (ucs_unlikely(flags & UCT_SEND_FLAG_PEER_CHECK)) {
         uct_ep_keepalive_check(&ep->super.super, &ep->keepalive,
-                               ep->fifo_ctl->pid, 0, NULL);
+                               ep->peer_ctl->pid, 0, NULL);
     }
 }
 
@@ -278,18 +453,30 @@ static UCS_F_ALWAYS_INLINE ssize_t uct_mm_ep_am_common_send(
         uct_mm_send_op_t send_op, uct_mm_ep_t *ep, uct_mm_iface_t *iface,
         uint8_t am_id, size_t length, uint64_t header, const void *payload,
         uct_pack_callback_t pack_cb, void *arg, const uct_iov_t *iov,
-        size_t iovcnt, unsigned flags)
+        size_t iovcnt, unsigned header_length, unsigned flags)
 {
+    uct_mm_zcopy_desc_t *zdesc;
     uct_mm_fifo_element_t *elem;
+    uct_mm_seg_t *seg;
     ucs_status_t status;
     void *base_address;
     uint8_t elem_flags;
     uint64_t head;
     ucs_iov_iter_t iov_iter;
     void *desc_data;
+    int batched;
 
     UCT_CHECK_AM_ID(am_id);
 
+    batched = uct_mm_ep_batch_has_elems(ep);
+    if (batched) {
+        /* use the next element which was reserved for the pending sends */
+        head = ep->batch.next++;
+        elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo_elems,
+                                          head & iface->fifo_mask);
+        goto write_elem;
+    }
+
 retry:
     head = ep->fifo_ctl->head;
     /* check if there is room in the remote process's receive FIFO to write */
@@ -318,6 +505,7 @@ retry:
         goto retry;
     }
 
+write_elem:
     switch (send_op) {
     case UCT_MM_SEND_AM_SHORT:
         /* write to the remote FIFO */
@@ -338,7 +526,7 @@ retry:
         status = uct_mm_ep_get_remote_seg(ep, elem->desc.seg_id,
                                           elem->desc.seg_size, &base_address);
         if (ucs_unlikely(status != UCS_OK)) {
-            return status;
+            goto err_release_elem;
         }
 
         desc_data    = UCS_PTR_BYTE_OFFSET(base_address, elem->desc.offset);
@@ -362,23 +550,75 @@ retry:
                               head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED);
         UCT_TL_EP_STAT_OP(&ep->super, AM, SHORT, elem->length);
         break;
+    case UCT_MM_SEND_AM_BCOPY_IOV:
+        /* copy the AM header and the payload to the remote descriptor */
+        status = uct_mm_ep_get_remote_seg(ep, elem->desc.seg_id,
+                                          elem->desc.seg_size, &base_address);
+        if (ucs_unlikely(status != UCS_OK)) {
+            goto err_release_elem;
+        }
+
+        desc_data    = UCS_PTR_BYTE_OFFSET(base_address, elem->desc.offset);
+        memcpy(desc_data, payload, header_length);
+        ucs_iov_iter_init(&iov_iter);
+        uct_iov_to_buffer(iov, iovcnt, &iov_iter,
+                          UCS_PTR_BYTE_OFFSET(desc_data, header_length),
+                          SIZE_MAX);
+        elem_flags   = 0;
+        elem->length = header_length + length;
+
+        uct_mm_iface_trace_am(iface, UCT_AM_TRACE_TYPE_SEND, elem_flags, am_id,
+                              desc_data, elem->length,
+                              head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED);
+        UCT_TL_EP_STAT_OP(&ep->super, AM, ZCOPY, elem->length);
+        break;
+    case UCT_MM_SEND_AM_ZCOPY:
+        /* write the descriptor of the sender's buffer, the mapper address
+         * needed to attach it, and the AM header to the remote FIFO */
+        seg                = iov->memh;
+        zdesc              = (uct_mm_zcopy_desc_t*)(elem + 1);
+        zdesc->state       = UCT_MM_ZCOPY_STATE_POSTED;
+        zdesc->seg_id      = seg->seg_id;
+        zdesc->uid         = seg->uid;
+        zdesc->seg_length  = seg->length;
+        zdesc->offset      = UCS_PTR_BYTE_DIFF(seg->address, iov->buffer);
+        zdesc->length      = length;
+        uct_mm_iface_mapper_call(iface, iface_addr_pack, zdesc + 1);
+        memcpy(UCS_PTR_BYTE_OFFSET(zdesc, iface->config.zcopy_hdr_offset),
+               payload, header_length);
+
+        elem_flags         = UCT_MM_FIFO_ELEM_FLAG_ZCOPY;
+        elem->length       = header_length;
+        *(uint64_t*)arg    = head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED;
+
+        uct_mm_iface_trace_am(iface, UCT_AM_TRACE_TYPE_SEND, elem_flags, am_id,
+                              payload, header_length,
+                              head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED);
+        UCT_TL_EP_STAT_OP(&ep->super, AM, ZCOPY, header_length + length);
+        break;
     }
 
     elem->am_id = am_id;
 
-    /* memory barrier - make sure that the memory is flushed before setting the
-     * 'writing is complete' flag which the reader checks */
-    ucs_memory_cpu_store_fence();
+    if (batched) {
+        /* reserved element - keep it owned by the sender until the whole
+         * batch is published */
+        elem->flags = elem_flags | (uct_mm_ep_elem_owner_flag(iface, head) ^
+                                    UCT_MM_FIFO_ELEM_FLAG_OWNER);
+        if (!uct_mm_ep_batch_has_elems(ep)) {
+            uct_mm_ep_batch_publish(ep);
+        }
+    } else {
+        /* memory barrier - make sure that the memory is flushed before
+         * setting the 'writing is complete' flag which the reader checks */
+        ucs_memory_cpu_store_fence();
 
-    /* set the owner bit to indicate that the writing is complete.
-     * the owner bit flips after every FIFO wraparound */
-    if (head & iface->config.fifo_size) {
-        elem_flags |= UCT_MM_FIFO_ELEM_FLAG_OWNER;
-    }
-    elem->flags = elem_flags;
+        /* set the owner bit to indicate that the writing is complete */
+        elem->flags = elem_flags | uct_mm_ep_elem_owner_flag(iface, head);
 
-    if (ucs_unlikely(head & UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED)) {
-        uct_mm_ep_signal_remote(ep);
+        if (ucs_unlikely(head & UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED)) {
+            uct_mm_ep_signal_remote(ep);
+        }
     }
 
     uct_mm_ep_peer_check(ep, flags);
@@ -386,12 +626,21 @@ retry:
     switch (send_op) {
     case UCT_MM_SEND_AM_SHORT:
     case UCT_MM_SEND_AM_SHORT_IOV:
+    case UCT_MM_SEND_AM_BCOPY_IOV:
         return UCS_OK;
     case UCT_MM_SEND_AM_BCOPY:
         return length;
+    case UCT_MM_SEND_AM_ZCOPY:
+        return UCS_INPROGRESS;
     default:
         return UCS_ERR_INVALID_PARAM;
     }
+
+err_release_elem:
+    if (batched) {
+        ep->batch.next = head;
+    }
+    return status;
 }
 
 ucs_status_t uct_mm_ep_am_short(uct_ep_h tl_ep, uint8_t id, uint64_t header,
@@ -407,7 +656,7 @@ ucs_status_t uct_mm_ep_am_short(uct_ep_h tl_ep, uint8_t id, uint64_t header,
     return (ucs_status_t)uct_mm_ep_am_common_send(UCT_MM_SEND_AM_SHORT, ep,
                                                   iface, id, length, header,
                                                   payload, NULL, NULL, NULL, 0,
-                                                  0);
+                                                  0, 0);
 }
 
 ucs_status_t uct_mm_ep_am_short_iov(uct_ep_h tl_ep, uint8_t id,
@@ -423,7 +672,7 @@ ucs_status_t uct_mm_ep_am_short_iov(uct_ep_h tl_ep, uint8_t id,
 
     return (ucs_status_t)uct_mm_ep_am_common_send(UCT_MM_SEND_AM_SHORT_IOV, ep,
                                                   iface, id, 0, 0, NULL, NULL,
-                                                  NULL, iov, iovcnt, 0);
+                                                  NULL, iov, iovcnt, 0, 0);
 }
 
 ssize_t uct_mm_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id, uct_pack_callback_t pack_cb,
@@ -433,7 +682,99 @@ ssize_t uct_mm_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id, uct_pack_callback_t pack_
     uct_mm_ep_t *ep = ucs_derived_of(tl_ep, uct_mm_ep_t);
 
     return uct_mm_ep_am_common_send(UCT_MM_SEND_AM_BCOPY, ep, iface, id, 0, 0,
-                                    NULL, pack_cb, arg, NULL, 0, flags);
+                                    NULL, pack_cb, arg, NULL, 0, 0, flags);
+}
+
+ucs_status_t uct_mm_ep_am_zcopy(uct_ep_h tl_ep, uint8_t id, const void *header,
+                                unsigned header_length, const uct_iov_t *iov,
+                                size_t iovcnt, unsigned flags,
+                                uct_completion_t *comp)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_mm_iface_t);
+    uct_mm_ep_t *ep       = ucs_derived_of(tl_ep, uct_mm_ep_t);
+    size_t length         = uct_iov_total_length(iov, iovcnt);
+    uct_mm_zcopy_op_t *op;
+    ucs_status_t status;
+
+    UCT_CHECK_AM_ID(id);
+    UCT_CHECK_IOV_SIZE(iovcnt, (unsigned long)UCT_SM_MAX_IOV,
+                       "uct_mm_ep_am_zcopy");
+    UCT_CHECK_LENGTH(header_length, 0,
+                     iface->config.fifo_elem_size -
+                     sizeof(uct_mm_fifo_element_t) -
+                     iface->config.zcopy_hdr_offset, "am_zcopy header");
+    UCT_CHECK_LENGTH(header_length + length, 0, iface->config.seg_size,
+                     "am_zcopy");
+    ucs_assert(iface->config.zcopy_hdr_offset != 0);
+
+    if ((iovcnt != 1) || (iov->memh == UCT_MEM_HANDLE_NULL)) {
+        /* the receiver attaches a single segment, and can't attach a buffer
+         * which is not in a segment of the memory domain, so copy it to the
+         * receive descriptor */
+        return (ucs_status_t)uct_mm_ep_am_common_send(UCT_MM_SEND_AM_BCOPY_IOV,
+                                                      ep, iface, id, length, 0,
+                                                      header, NULL, NULL, iov,
+                                                      iovcnt, header_length,
+                                                      flags);
+    }
+
+    ucs_assertv((iov->buffer >= ((uct_mm_seg_t*)iov->memh)->address) &&
+                (UCS_PTR_BYTE_OFFSET(iov->buffer, length) <=
+                 UCS_PTR_BYTE_OFFSET(((uct_mm_seg_t*)iov->memh)->address,
+                                     ((uct_mm_seg_t*)iov->memh)->length)),
+                "buffer %p length %zu is out of the memory handle range",
+                iov->buffer, length);
+
+    op = ucs_mpool_get(&iface->zcopy.op_mp);
+    if (ucs_unlikely(op == NULL)) {
+        ucs_error("failed to allocate mm zero-copy operation");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    status = (ucs_status_t)uct_mm_ep_am_common_send(UCT_MM_SEND_AM_ZCOPY, ep,
+                                                    iface, id, length, 0,
+                                                    header, NULL, &op->sn, iov,
+                                                    iovcnt, header_length,
+                                                    flags);
+    if (status != UCS_INPROGRESS) {
+        ucs_mpool_put(op);
+        return status;
+    }
+
+    op->ep            = ep;
+    op->comp          = comp;
+    ep->zcopy_last_sn = op->sn;
+    ucs_queue_push(&iface->zcopy.ops, &op->queue);
+    return UCS_INPROGRESS;
+}
+
+unsigned uct_mm_ep_zcopy_progress(uct_mm_iface_t *iface)
+{
+    unsigned count = 0;
+    ucs_queue_head_t completed;
+    uct_mm_zcopy_op_t *op;
+    ucs_queue_iter_t iter;
+
+    /* operations of different endpoints are not ordered, so check all of
+     * them. the completions are invoked after the queue is scanned, since
+     * they may send or destroy endpoints */
+    ucs_queue_head_init(&completed);
+    ucs_queue_for_each_safe(op, iter, &iface->zcopy.ops, queue) {
+        if (uct_mm_ep_zcopy_is_completed(op->ep, op->sn)) {
+            ucs_queue_del_iter(&iface->zcopy.ops, iter);
+            ucs_queue_push(&completed, &op->queue);
+        }
+    }
+
+    ucs_queue_for_each_extract(op, &completed, queue, 1) {
+        if (op->comp != NULL) {
+            uct_invoke_completion(op->comp, UCS_OK);
+        }
+        ucs_mpool_put(op);
+        ++count;
+    }
+
+    return count;
 }
 
 static inline int uct_mm_ep_has_tx_resources(uct_mm_ep_t *ep)
@@ -458,6 +799,7 @@ ucs_status_t uct_mm_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *n,
     UCS_STATIC_ASSERT(sizeof(uct_pending_req_priv_arb_t) <=
                       UCT_PENDING_REQ_PRIV_LEN);
     uct_pending_req_arb_group_push(&ep->arb_group, n);
+    ++ep->pending_count;
     /* add the ep's group to the arbiter */
     ucs_arbiter_group_schedule(&iface->arbiter, &ep->arb_group);
     UCT_TL_EP_STAT_PEND(&ep->super);
@@ -471,19 +813,33 @@ ucs_arbiter_cb_result_t uct_mm_ep_process_pending(ucs_arbiter_t *arbiter,
                                                   void *arg)
 {
     uct_mm_ep_t *ep        = ucs_container_of(group, uct_mm_ep_t, arb_group);
+    uct_mm_iface_t *iface  = ucs_derived_of(ep->super.super.iface,
+                                            uct_mm_iface_t);
     unsigned *count        = (unsigned*)arg;
     uct_pending_req_t *req;
     ucs_status_t status;
 
-    /* update the local tail with its actual value from the remote peer
-     * making sure that the pending sends would use the real tail value */
-    uct_mm_ep_update_cached_tail(ep);
+    if (!uct_mm_ep_batch_has_elems(ep)) {
+        /* update the local tail with its actual value from the remote peer
+         * making sure that the pending sends would use the real tail value */
+        uct_mm_ep_update_cached_tail(ep);
 
-    if (!uct_mm_ep_has_tx_resources(ep)) {
-        return UCS_ARBITER_CB_RESULT_RESCHED_GROUP;
-    }
+        if (!uct_mm_ep_has_tx_resources(ep)) {
+            return UCS_ARBITER_CB_RESULT_RESCHED_GROUP;
+        }
 
-    if (elem == &ep->arb_elem) {
+        if (elem == &ep->arb_elem) {
+            return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+        }
+
+        /* reserve FIFO elements for the following pending requests, to pay
+         * for a single update of the remote FIFO head */
+        if (iface->config.batch_size > 1) {
+            uct_mm_ep_batch_reserve(ep, iface,
+                                    ucs_min(iface->config.batch_size,
+                                            ep->pending_count));
+        }
+    } else if (elem == &ep->arb_elem) {
         return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
     }
 
@@ -496,6 +852,7 @@ ucs_arbiter_cb_result_t uct_mm_ep_process_pending(ucs_arbiter_t *arbiter,
 
     if (status == UCS_OK) {
         (*count)++;
+        --ep->pending_count;
         /* sent successfully. remove from the arbiter */
         return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
     } else if (status == UCS_INPROGRESS) {
@@ -525,6 +882,7 @@ static ucs_arbiter_cb_result_t uct_mm_ep_arbiter_purge_cb(ucs_arbiter_t *arbiter
     }
 
     req = ucs_container_of(elem, uct_pending_req_t, priv);
+    --ep->pending_count;
     if (cb != NULL) {
         cb(req, cb_args->arg);
     } else {
@@ -548,7 +906,14 @@ void uct_mm_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
 ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
                              uct_completion_t *comp)
 {
-    uct_mm_ep_t *ep = ucs_derived_of(tl_ep, uct_mm_ep_t);
+    uct_mm_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_mm_iface_t);
+    uct_mm_ep_t *ep       = ucs_derived_of(tl_ep, uct_mm_ep_t);
+    uct_mm_zcopy_op_t *op;
+
+    if (uct_mm_ep_batch_has_elems(ep)) {
+        /* flushed operations have to be visible to the receiver */
+        uct_mm_ep_batch_publish(ep);
+    }
 
     if (!uct_mm_ep_has_tx_resources(ep)) {
         if (!ucs_arbiter_group_is_empty(&ep->arb_group)) {
@@ -561,6 +926,25 @@ ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
         }
     }
 
+    if (!uct_mm_ep_zcopy_is_completed(ep, ep->zcopy_last_sn)) {
+        /* wait for the receiver to consume the last zero-copy send */
+        if (comp != NULL) {
+            op = ucs_mpool_get(&iface->zcopy.op_mp);
+            if (ucs_unlikely(op == NULL)) {
+                ucs_error("failed to allocate mm flush operation");
+                return UCS_ERR_NO_MEMORY;
+            }
+
+            op->ep   = ep;
+            op->sn   = ep->zcopy_last_sn;
+            op->comp = comp;
+            ucs_queue_push(&iface->zcopy.ops, &op->queue);
+        }
+
+        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
+        return UCS_INPROGRESS;
+    }
+
     ucs_memory_cpu_store_fence();
     UCT_TL_EP_STAT_FLUSH(&ep->super);
     return UCS_OK;
@@ -572,7 +956,7 @@ uct_mm_ep_check(uct_ep_h tl_ep, unsigned flags, uct_completion_t *comp)
     uct_mm_ep_t *ep = ucs_derived_of(tl_ep, uct_mm_ep_t);
 
     UCT_EP_KEEPALIVE_CHECK_PARAM(flags, comp);
-    uct_ep_keepalive_check(tl_ep, &ep->keepalive, ep->fifo_ctl->pid, flags,
+    uct_ep_keepalive_check(tl_ep, &ep->keepalive, ep->peer_ctl->pid, flags,
                            comp);
     return UCS_OK;
 }
@@ -10,36 +10,36 @@
 
 #include "mm_iface.h"
 
-#include <ucs/datastruct/khash.h>
 #include <uct/sm/base/sm_ep.h>
 
 
-KHASH_INIT(uct_mm_remote_seg, uintptr_t, uct_mm_remote_seg_t, 1,
-           kh_int64_hash_func, kh_int64_hash_equal)
-
-
 /**
  * MM transport endpoint
  */
 typedef struct uct_mm_ep {
     uct_base_ep_t              super;
 
-    /* pointer to the destination's ctl struct in the receive fifo */
+    /* pointer to the destination's ctl struct of the receive fifo lane
+       assigned to this endpoint */
     uct_mm_fifo_ctl_t          *fifo_ctl;
 
-    /* fifo elements (destination's receive fifo) */
+    /* fifo elements (destination's receive fifo lane) */
     void                       *fifo_elems;
 
+    /* pointer to the destination's ctl struct of the first receive fifo lane,
+       which holds the signaling address and the owner pid */
+    uct_mm_fifo_ctl_t          *peer_ctl;
+
     /* the sender's own copy of the remote FIFO's tail.
        it is not always updated with the actual remote tail value */
     uint64_t                   cached_tail;
 
-    /* mapped remote memory chunks to which remote descriptors belong to.
-     * (after attaching to them) */
-    khash_t(uct_mm_remote_seg) remote_segs;
+    /* sequence number of the last zero-copy send, it is completed when the
+       remote FIFO tail passes it */
+    uint64_t                   zcopy_last_sn;
 
-    /* remote md-specific address, can be NULL */
-    void                       *remote_iface_addr;
+    /* remote interface, holds the attached FIFO and descriptor segments */
+    uct_mm_iface_peer_t        *peer;
 
     /* group that holds this ep's pending operations */
     ucs_arbiter_group_t        arb_group;
@@ -48,6 +48,23 @@ typedef struct uct_mm_ep {
        the interface as long as one of the endpoints is unable to send */
     ucs_arbiter_elem_t         arb_elem;
 
+    /* number of requests in the pending group */
+    unsigned                   pending_count;
+
+    /* FIFO elements which were reserved by a single update of the remote FIFO
+       head while dispatching pending operations. they are written without
+       passing the ownership to the receiver, and published together */
+    struct {
+        uint64_t               start;     /* first reserved element */
+        uint64_t               next;      /* next element to write */
+        uint64_t               end;       /* end of the reserved elements */
+        int                    signal;    /* whether the receiver armed the
+                                             FIFO, so it should be signaled
+                                             after publishing */
+        ucs_list_link_t        list;      /* entry in the interface list of
+                                             endpoints with reserved elements */
+    } batch;
+
     uct_keepalive_info_t       keepalive; /* keepalive info */
 } uct_mm_ep_t;
 
@@ -64,6 +81,11 @@ ucs_status_t uct_mm_ep_am_short_iov(uct_ep_h tl_ep, uint8_t id,
 ssize_t uct_mm_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id, uct_pack_callback_t pack_cb,
                            void *arg, unsigned flags);
 
+ucs_status_t uct_mm_ep_am_zcopy(uct_ep_h tl_ep, uint8_t id, const void *header,
+                                unsigned header_length, const uct_iov_t *iov,
+                                size_t iovcnt, unsigned flags,
+                                uct_completion_t *comp);
+
 ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
                              uct_completion_t *comp);
 
@@ -81,6 +103,10 @@ ucs_arbiter_cb_result_t uct_mm_ep_process_pending(ucs_arbiter_t *arbiter,
                                                   ucs_arbiter_elem_t *elem,
                                                   void *arg);
 
+unsigned uct_mm_ep_zcopy_progress(uct_mm_iface_t *iface);
+
+void uct_mm_ep_batch_publish_all(uct_mm_iface_t *iface);
+
 int uct_mm_ep_is_connected(const uct_ep_h tl_ep,
                            const uct_ep_is_connected_params_t *params);
 
@@ -17,8 +17,14 @@
 #include <ucs/arch/atomic.h>
 #include <ucs/arch/bitops.h>
 #include <ucs/async/async.h>
+#include <ucs/async/eventfd.h>
 #include <ucs/sys/string.h>
+#include <ucs/vfs/base/vfs_cb.h>
+#include <ucs/vfs/base/vfs_obj.h>
 #include <sys/poll.h>
+#ifdef HAVE_LINUX_FUTEX_H
+#include <linux/futex.h>
+#endif
 
 
 /* Maximal number of events to clear from the signaling pipe in single call */
@@ -27,6 +33,12 @@
 #define UCT_MM_IFACE_OVERHEAD 10e-9
 #define UCT_MM_IFACE_LATENCY  ucs_linear_func_make(80e-9, 0)
 
+static const char *uct_mm_wakeup_mode_names[] = {
+    [UCT_MM_WAKEUP_MODE_SOCKET] = "socket",
+    [UCT_MM_WAKEUP_MODE_FUTEX]  = "futex",
+    [UCT_MM_WAKEUP_MODE_LAST]   = NULL
+};
+
 ucs_config_field_t uct_mm_iface_config_table[] = {
     {"SM_", "ALLOC=md,mmap,heap;BW=15360MBs", NULL,
      ucs_offsetof(uct_mm_iface_config_t, super),
@@ -40,6 +52,27 @@ ucs_config_field_t uct_mm_iface_config_table[] = {
      "Size of send/receive buffers for copy-out sends.",
      ucs_offsetof(uct_mm_iface_config_t, seg_size), UCS_CONFIG_TYPE_MEMUNITS},
 
+    {"AM_ZCOPY", "n",
+     "Enable zero-copy active messages. If the payload is a single buffer in memory\n"
+     "allocated or registered by the memory domain, the receiver reads it directly\n"
+     "from the sender's memory, and if the active message header is empty, passes\n"
+     "it to the receive callback in place. Otherwise, the payload is copied to the\n"
+     "receive descriptor. The maximal message size is limited by SEG_SIZE, so it\n"
+     "should be raised together with this option for large messages.",
+     ucs_offsetof(uct_mm_iface_config_t, am_zcopy), UCS_CONFIG_TYPE_BOOL},
+
+    {"NUMA_PLACEMENT", "y",
+     "Place the receive FIFO and the receive descriptors on the NUMA node of the\n"
+     "interface CPU mask, or of the CPUs which the thread creating the interface\n"
+     "is bound to, if all of them belong to the same node.",
+     ucs_offsetof(uct_mm_iface_config_t, numa_placement), UCS_CONFIG_TYPE_BOOL},
+
+    {"BCAST_FIFO_SIZE", "0",
+     "Size of the broadcast FIFO, which passes a message written once to all the\n"
+     "processes which have endpoints to the interface. Must be a power of 2, or 0\n"
+     "to disable broadcast.",
+     ucs_offsetof(uct_mm_iface_config_t, bcast_fifo_size), UCS_CONFIG_TYPE_UINT},
+
     {"FIFO_RELEASE_FACTOR", "0.5",
      "Frequency of resource releasing on the receiver's side in the MM UCT.\n"
      "This value refers to the percentage of the FIFO size. (must be >= 0 and < 1).",
@@ -60,6 +93,47 @@ ucs_config_field_t uct_mm_iface_config_table[] = {
      "Size of the FIFO element size (data + header) in the MM UCTs.",
      ucs_offsetof(uct_mm_iface_config_t, fifo_elem_size), UCS_CONFIG_TYPE_UINT},
 
+    {"FIFO_LANES", "1",
+     "Number of lanes in the receive FIFO. Every lane is a separate ring with\n"
+     "its own head index, and connected senders are spread over the lanes in\n"
+     "a round-robin order. Using several lanes reduces the contention on the\n"
+     "FIFO head when many processes send to the same receiver.",
+     ucs_offsetof(uct_mm_iface_config_t, fifo_lanes), UCS_CONFIG_TYPE_UINT},
+
+    {"BATCH_SIZE", "16",
+     "Maximal number of FIFO elements an endpoint reserves with a single update\n"
+     "of the remote FIFO head when it sends pending operations. The elements are\n"
+     "passed to the receiver together, and the ones which were not used are\n"
+     "skipped by it. A value of 1 disables batching.",
+     ucs_offsetof(uct_mm_iface_config_t, batch_size), UCS_CONFIG_TYPE_UINT},
+
+    {"WAKEUP", "socket",
+     "Method a sender uses to wake up a receiver waiting for events:\n"
+     " socket - Send a datagram to the receiver's Unix-domain socket.\n"
+     " futex  - Bump a futex word in the shared FIFO, and issue FUTEX_WAKE only\n"
+     "          when the receiver sleeps on it. A helper thread of the receiver\n"
+     "          waits on the futex and signals the interface event fd. Requires\n"
+     "          a memory mapper which supports process-shared futexes\n"
+     "          (posix or sysv).",
+     ucs_offsetof(uct_mm_iface_config_t, wakeup_mode),
+     UCS_CONFIG_TYPE_ENUM(uct_mm_wakeup_mode_names)},
+
+    {"ATTACH_MAX_SEGS", "1024",
+     "Maximal number of remote shared memory segments attached by the interface.\n"
+     "Attached segments are shared by all endpoints to the same remote interface\n"
+     "and kept after the endpoints are destroyed. When the limit is reached,\n"
+     "segments which are not in use are detached in least-recently-used order.\n"
+     "The receive FIFO of a remote interface is in use as long as there are\n"
+     "endpoints connected to it.",
+     ucs_offsetof(uct_mm_iface_config_t, attach_max_segs),
+     UCS_CONFIG_TYPE_ULUNITS},
+
+    {"ATTACH_MAX_SIZE", "inf",
+     "Maximal total size of remote shared memory segments attached by the\n"
+     "interface. Limits the attached segments in the same way as ATTACH_MAX_SEGS.",
+     ucs_offsetof(uct_mm_iface_config_t, attach_max_size),
+     UCS_CONFIG_TYPE_MEMUNITS},
+
     {"FIFO_MAX_POLL", UCS_PP_MAKE_STRING(UCT_MM_IFACE_FIFO_MAX_POLL),
      "Maximal number of receive completions to pick during RX poll",
      ucs_offsetof(uct_mm_iface_config_t, fifo_max_poll), UCS_CONFIG_TYPE_ULUNITS},
@@ -160,10 +234,18 @@ void uct_mm_iface_release_desc(uct_recv_desc_t *self, void *desc)
 ucs_status_t uct_mm_iface_flush(uct_iface_h tl_iface, unsigned flags,
                                 uct_completion_t *comp)
 {
+    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
+
     if (comp != NULL) {
         return UCS_ERR_UNSUPPORTED;
     }
 
+    if (!ucs_queue_is_empty(&iface->zcopy.ops)) {
+        UCT_TL_IFACE_STAT_FLUSH_WAIT(ucs_derived_of(tl_iface,
+                                                    uct_base_iface_t));
+        return UCS_INPROGRESS;
+    }
+
     ucs_memory_cpu_store_fence();
     UCT_TL_IFACE_STAT_FLUSH(ucs_derived_of(tl_iface, uct_base_iface_t));
     return UCS_OK;
@@ -178,6 +260,7 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
     ucs_status_t status;
 
     uct_base_iface_query(&iface->super.super, iface_attr);
+    iface_attr->numa_node = iface->numa_node;
 
     /* default values for all shared memory transports */
     iface_attr->cap.put.max_short       = UINT_MAX;
@@ -204,6 +287,17 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
     iface_attr->cap.am.align_mtu        = iface_attr->cap.am.opt_zcopy_align;
     iface_attr->cap.am.max_iov          = SIZE_MAX;
 
+    if (iface->config.zcopy_hdr_offset != 0) {
+        /* a buffer without a memory handle is copied to the receive
+         * descriptor, so it has to fit there with the header */
+        iface_attr->cap.am.max_hdr      = iface->config.fifo_elem_size -
+                                          sizeof(uct_mm_fifo_element_t) -
+                                          iface->config.zcopy_hdr_offset;
+        iface_attr->cap.am.max_zcopy    = iface->config.seg_size -
+                                          iface_attr->cap.am.max_hdr;
+        iface_attr->cap.am.max_iov      = UCT_SM_MAX_IOV;
+    }
+
     iface_attr->iface_addr_len          = sizeof(uct_mm_iface_addr_t) +
                                           md->iface_addr_len;
     iface_attr->device_addr_len         = uct_sm_iface_get_device_addr_len();
@@ -220,6 +314,14 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
                                           UCT_IFACE_FLAG_CONNECT_TO_IFACE    |
                                           iface->config.extra_cap_flags;
 
+    if (iface->config.zcopy_hdr_offset != 0) {
+        iface_attr->cap.flags          |= UCT_IFACE_FLAG_AM_ZCOPY;
+    }
+
+    if (iface->bcast.ctl != NULL) {
+        iface_attr->cap.flags          |= UCT_IFACE_FLAG_AM_BCAST;
+    }
+
     status = uct_mm_md_mapper_ops(md)->query(&attach_shm_file);
     ucs_assert_always(status == UCS_OK);
 
@@ -262,18 +364,25 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
 }
 
 static UCS_F_ALWAYS_INLINE void
-uct_mm_progress_fifo_tail(uct_mm_iface_t *iface)
+uct_mm_progress_fifo_tail(uct_mm_iface_t *iface, uct_mm_fifo_lane_t *lane,
+                          uint8_t elem_flags)
 {
-    /* don't progress the tail every time - release in batches. improves performance */
-    if (iface->read_index & iface->fifo_release_factor_mask) {
+    if (ucs_unlikely(elem_flags & UCT_MM_FIFO_ELEM_FLAG_ZCOPY)) {
+        /* a zero-copy sender completes its operation when the tail passes the
+         * element, so release it right away, after reading the payload from
+         * the sender's buffer is done */
+        ucs_memory_cpu_fence();
+    } else if (lane->read_index & iface->fifo_release_factor_mask) {
+        /* don't progress the tail every time - release in batches. improves
+         * performance */
         return;
+    } else {
+        /* memory barrier - make sure that the memory is flushed before update
+         * the FIFO tail */
+        ucs_memory_cpu_store_fence();
     }
 
-    /* memory barrier - make sure that the memory is flushed before update the
-     * FIFO tail */
-    ucs_memory_cpu_store_fence();
-
-    iface->recv_fifo_ctl->tail = iface->read_index;
+    lane->fifo_ctl->tail = lane->read_index;
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -295,17 +404,123 @@ uct_mm_assign_desc_to_fifo_elem(uct_mm_iface_t *iface,
     return UCS_OK;
 }
 
-static UCS_F_ALWAYS_INLINE void uct_mm_iface_process_recv(uct_mm_iface_t *iface)
+static UCS_F_NOINLINE void
+uct_mm_iface_process_recv_zcopy(uct_mm_iface_t *iface,
+                                uct_mm_fifo_lane_t *lane,
+                                uct_mm_fifo_element_t *elem)
 {
-    uct_mm_fifo_element_t *elem = iface->read_index_elem;
+    const uct_mm_zcopy_desc_t *zdesc = (const uct_mm_zcopy_desc_t*)(elem + 1);
+    const void *iface_addr           = zdesc + 1;
+    const void *header               = UCS_PTR_BYTE_OFFSET(
+                                               zdesc,
+                                               iface->config.zcopy_hdr_offset);
+    size_t length                    = elem->length + zdesc->length;
     ucs_status_t status;
+    void *base_address;
+    void *payload;
     void *data;
 
+    if (ucs_atomic_cswap32(ucs_unaligned_ptr(&zdesc->state),
+                           UCT_MM_ZCOPY_STATE_POSTED,
+                           UCT_MM_ZCOPY_STATE_READING) !=
+        UCT_MM_ZCOPY_STATE_POSTED) {
+        ucs_trace_data("mm_iface %p: zero-copy active message %d was canceled",
+                       iface, elem->am_id);
+        return;
+    }
+
+    if (zdesc->length == 0) {
+        payload = NULL;
+    } else {
+        status = uct_mm_iface_zcopy_seg_get(iface, zdesc, iface_addr,
+                                            &base_address);
+        if (status != UCS_OK) {
+            ucs_diag("mm_iface %p: failed to attach zero-copy segment id "
+                     "0x%"PRIx64", dropping active message %d: %s", iface,
+                     zdesc->seg_id, elem->am_id, ucs_status_string(status));
+            return;
+        }
+
+        payload = UCS_PTR_BYTE_OFFSET(base_address, zdesc->offset);
+    }
+
+    if (elem->length == 0) {
+        /* no header, pass the sender's buffer to the callback in place. it
+         * may not be kept after the callback returns */
+        uct_mm_iface_trace_am(iface, UCT_AM_TRACE_TYPE_RECV, elem->flags,
+                              elem->am_id, payload, length, lane->read_index);
+        uct_iface_invoke_am(&iface->super.super, elem->am_id, payload, length,
+                            0);
+        return;
+    }
+
+    if (ucs_unlikely(iface->last_recv_desc == NULL)) {
+        UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
+                                 iface->last_recv_desc,
+                                 ucs_debug("recv mpool is empty"));
+    }
+
+    ucs_assert(length <= iface->config.seg_size);
+    if (ucs_unlikely(iface->last_recv_desc == NULL)) {
+        /* no receive descriptor, so assemble the message in a temporary
+         * buffer which is released after the callback returns */
+        data = ucs_malloc(length, "mm_zcopy_recv");
+        if (data == NULL) {
+            ucs_error("mm_iface %p: failed to allocate %zu bytes, dropping "
+                      "active message %d", iface, length, elem->am_id);
+            return;
+        }
+
+        memcpy(data, header, elem->length);
+        memcpy(UCS_PTR_BYTE_OFFSET(data, elem->length), payload,
+               zdesc->length);
+        uct_mm_iface_trace_am(iface, UCT_AM_TRACE_TYPE_RECV, elem->flags,
+                              elem->am_id, data, length, lane->read_index);
+        uct_iface_invoke_am(&iface->super.super, elem->am_id, data, length, 0);
+        ucs_free(data);
+        return;
+    }
+
+    /* assemble the header and the payload in a receive descriptor */
+    data = UCS_PTR_BYTE_OFFSET(iface->last_recv_desc + 1, iface->rx_headroom);
+    memcpy(data, header, elem->length);
+    memcpy(UCS_PTR_BYTE_OFFSET(data, elem->length), payload, zdesc->length);
+    uct_mm_iface_trace_am(iface, UCT_AM_TRACE_TYPE_RECV, elem->flags,
+                          elem->am_id, data, length, lane->read_index);
+
+    status = uct_mm_iface_invoke_am(iface, elem->am_id, data, length,
+                                    UCT_CB_PARAM_FLAG_DESC);
+    if (status != UCS_OK) {
+        /* the descriptor is kept by the user, get a new one */
+        UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
+                                 iface->last_recv_desc,
+                                 ucs_debug("recv mpool is empty"));
+    }
+}
+
+static UCS_F_ALWAYS_INLINE void
+uct_mm_iface_process_recv(uct_mm_iface_t *iface, uct_mm_fifo_lane_t *lane)
+{
+    uct_mm_fifo_element_t *elem = lane->read_index_elem;
+    ucs_status_t status;
+    void *data;
+
+    if (ucs_unlikely(elem->flags & (UCT_MM_FIFO_ELEM_FLAG_ZCOPY |
+                                    UCT_MM_FIFO_ELEM_FLAG_NOP))) {
+        if (elem->flags & UCT_MM_FIFO_ELEM_FLAG_ZCOPY) {
+            uct_mm_iface_process_recv_zcopy(iface, lane, elem);
+        } else {
+            ucs_trace_data("mm_iface %p: skipping unused element %" PRIu64,
+                           iface, lane->read_index);
+        }
+        return;
+    }
+
     if (ucs_likely(elem->flags & UCT_MM_FIFO_ELEM_FLAG_INLINE)) {
         /* read short (inline) messages from the FIFO elements */
         uct_mm_iface_trace_am(iface, UCT_AM_TRACE_TYPE_RECV, elem->flags,
                               elem->am_id, elem + 1, elem->length,
-                              iface->read_index);
+                              lane->read_index);
         uct_mm_iface_invoke_am(iface, elem->am_id, elem + 1, elem->length, 0);
         return;
     }
@@ -320,7 +535,7 @@ static UCS_F_ALWAYS_INLINE void uct_mm_iface_process_recv(uct_mm_iface_t *iface)
     data = elem->desc_data;
     VALGRIND_MAKE_MEM_DEFINED(data, elem->length);
     uct_mm_iface_trace_am(iface, UCT_AM_TRACE_TYPE_RECV, elem->flags,
-                          elem->am_id, data, elem->length, iface->read_index);
+                          elem->am_id, data, elem->length, lane->read_index);
 
     status = uct_mm_iface_invoke_am(iface, elem->am_id, data, elem->length,
                                     UCT_CB_PARAM_FLAG_DESC);
@@ -334,37 +549,40 @@ static UCS_F_ALWAYS_INLINE void uct_mm_iface_process_recv(uct_mm_iface_t *iface)
 }
 
 static UCS_F_ALWAYS_INLINE int
-uct_mm_iface_fifo_has_new_data(uct_mm_iface_t *iface)
+uct_mm_iface_fifo_has_new_data(uct_mm_iface_t *iface, uct_mm_fifo_lane_t *lane)
 {
     /* check the read_index to see if there is a new item to read
      * (checking the owner bit) */
-    return (((iface->read_index >> iface->fifo_shift) & 1) ==
-            (iface->read_index_elem->flags & 1));
+    return (((lane->read_index >> iface->fifo_shift) & 1) ==
+            (lane->read_index_elem->flags & 1));
 }
 
 static UCS_F_ALWAYS_INLINE unsigned
-uct_mm_iface_poll_fifo(uct_mm_iface_t *iface)
+uct_mm_iface_poll_fifo(uct_mm_iface_t *iface, uct_mm_fifo_lane_t *lane)
 {
-    if (!uct_mm_iface_fifo_has_new_data(iface)) {
+    uint8_t elem_flags;
+
+    if (!uct_mm_iface_fifo_has_new_data(iface, lane)) {
         return 0;
     }
 
     /* read from read_index_elem */
     ucs_memory_cpu_load_fence();
-    ucs_assert(iface->read_index <=
-               (iface->recv_fifo_ctl->head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED));
+    ucs_assert(lane->read_index <=
+               (lane->fifo_ctl->head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED));
 
-    uct_mm_iface_process_recv(iface);
+    elem_flags = lane->read_index_elem->flags;
+    uct_mm_iface_process_recv(iface, lane);
 
     /* raise the read_index */
-    iface->read_index++;
+    lane->read_index++;
 
     /* the next fifo_element which the read_index points to */
-    iface->read_index_elem =
-        UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elems,
-                                   (iface->read_index & iface->fifo_mask));
+    lane->read_index_elem =
+        UCT_MM_IFACE_GET_FIFO_ELEM(iface, lane->fifo_elems,
+                                   (lane->read_index & iface->fifo_mask));
 
-    uct_mm_progress_fifo_tail(iface);
+    uct_mm_progress_fifo_tail(iface, lane, elem_flags);
 
     return 1;
 }
@@ -401,89 +619,90 @@ static unsigned uct_mm_iface_progress(uct_iface_h tl_iface)
 {
     uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
     unsigned total_count  = 0;
+    unsigned lane_index   = iface->poll_lane;
+    unsigned num_lanes    = 0;
+    uct_mm_fifo_lane_t *lane;
     unsigned count;
 
     ucs_assert(iface->fifo_poll_count >= UCT_MM_IFACE_FIFO_MIN_POLL);
 
-    /* progress receive */
+    /* progress receive, visiting the lanes in a round-robin order and starting
+     * from a different lane every time to keep the lanes fair */
     do {
-        count = uct_mm_iface_poll_fifo(iface);
-        ucs_assert(count < 2);
-        total_count += count;
-        ucs_assert(total_count < UINT_MAX);
-    } while ((count != 0) && (total_count < iface->fifo_poll_count));
+        lane = &iface->recv_lanes[lane_index];
+        do {
+            count = uct_mm_iface_poll_fifo(iface, lane);
+            ucs_assert(count < 2);
+            total_count += count;
+            ucs_assert(total_count < UINT_MAX);
+        } while ((count != 0) && (total_count < iface->fifo_poll_count));
+
+        if (++lane_index == iface->config.fifo_lanes) {
+            lane_index = 0;
+        }
+    } while ((++num_lanes < iface->config.fifo_lanes) &&
+             (total_count < iface->fifo_poll_count));
+
+    iface->poll_lane = lane_index;
 
     uct_mm_iface_fifo_window_adjust(iface, total_count);
 
+    /* progress the broadcast FIFOs of the peers we have endpoints to */
+    if (ucs_unlikely(!ucs_list_is_empty(&iface->bcast.sources))) {
+        total_count += uct_mm_iface_bcast_progress(iface);
+    }
+
+    /* complete zero-copy sends which were consumed by the receivers */
+    if (ucs_unlikely(!ucs_queue_is_empty(&iface->zcopy.ops))) {
+        total_count += uct_mm_ep_zcopy_progress(iface);
+    }
+
     /* progress the pending sends (if there are any) */
-    ucs_arbiter_dispatch(&iface->arbiter, 1, uct_mm_ep_process_pending,
-                         &total_count);
+    ucs_arbiter_dispatch(&iface->arbiter, iface->config.batch_size,
+                         uct_mm_ep_process_pending, &total_count);
+
+    /* pass the FIFO elements which were reserved by the pending sends to the
+     * receivers */
+    if (ucs_unlikely(!ucs_list_is_empty(&iface->batch_eps))) {
+        uct_mm_ep_batch_publish_all(iface);
+    }
 
     return total_count;
 }
 
 static ucs_status_t uct_mm_iface_event_fd_get(uct_iface_h tl_iface, int *fd_p)
 {
-    *fd_p = ucs_derived_of(tl_iface, uct_mm_iface_t)->signal_fd;
+    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
+
+    *fd_p = (iface->config.wakeup_mode == UCT_MM_WAKEUP_MODE_FUTEX) ?
+            iface->wakeup.event_fd : iface->signal_fd;
     return UCS_OK;
 }
 
-
-static ucs_status_t
-uct_mm_iface_event_fd_arm(uct_iface_h tl_iface, unsigned events)
+static ucs_status_t uct_mm_iface_event_fd_check(uct_mm_iface_t *iface)
 {
-    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
     char dummy[UCT_MM_IFACE_MAX_SIG_EVENTS]; /* pop multiple signals at once */
-    uint64_t head, prev_head;
+    ucs_status_t status;
     int ret;
 
-    if ((events & UCT_EVENT_SEND_COMP) &&
-        !ucs_arbiter_is_empty(&iface->arbiter)) {
-        /* if we have outstanding send operations, can't go to sleep */
-        return UCS_ERR_BUSY;
-    }
-
-    if (!(events & UCT_EVENT_RECV)) {
-        /* Nothing to do anymore */
-        return UCS_OK;
-    }
-
-    /* Make the next sender which writes to the FIFO signal the receiver */
-    head = iface->recv_fifo_ctl->head;
-    if ((head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED) > iface->read_index) {
-        /* head element was not read yet */
-        ucs_trace("iface %p: cannot arm, head %" PRIu64 " read_index %" PRIu64,
-                  iface, head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED,
-                  iface->read_index);
-        return UCS_ERR_BUSY;
-    }
-
-    if (!(head & UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED)) {
-        /* Try to mark the head index as armed in an atomic way; fail if any
-           sender managed to update the head at the same time */
-        prev_head = ucs_atomic_cswap64(
-                ucs_unaligned_ptr(&iface->recv_fifo_ctl->head), head,
-                head | UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED);
-        if (prev_head != head) {
-            /* race with sender; need to retry */
-            ucs_assert(!(prev_head & UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED));
-            ucs_trace("iface %p: cannot arm, head %" PRIu64
-                      " prev_head %" PRIu64,
-                      iface, head, prev_head);
+    if (iface->config.wakeup_mode == UCT_MM_WAKEUP_MODE_FUTEX) {
+        status = ucs_async_eventfd_poll(iface->wakeup.event_fd);
+        if (status == UCS_OK) {
+            ucs_trace("iface %p: cannot arm, got a wakeup", iface);
             return UCS_ERR_BUSY;
+        } else if (status == UCS_ERR_NO_PROGRESS) {
+            return UCS_OK;
         }
+
+        return status;
     }
 
-    /* check for pending events */
     ret = recvfrom(iface->signal_fd, &dummy, sizeof(dummy), 0, NULL, 0);
     if (ret > 0) {
         ucs_trace("iface %p: cannot arm, got a signal", iface);
         return UCS_ERR_BUSY;
     } else if (ret == -1) {
         if (errno == EAGAIN) {
-            ucs_trace("iface %p: armed head %" PRIu64 " read_index %" PRIu64,
-                      iface, head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED,
-                      iface->read_index);
             return UCS_OK;
         } else if (errno == EINTR) {
             return UCS_ERR_BUSY;
@@ -499,8 +718,82 @@ uct_mm_iface_event_fd_arm(uct_iface_h tl_iface, unsigned events)
     }
 }
 
+
+static ucs_status_t
+uct_mm_iface_event_fd_arm(uct_iface_h tl_iface, unsigned events)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
+    uct_mm_fifo_lane_t *lane;
+    uint64_t head, prev_head;
+    ucs_status_t status;
+    unsigned i;
+
+    if ((events & UCT_EVENT_SEND_COMP) &&
+        !ucs_arbiter_is_empty(&iface->arbiter)) {
+        /* if we have outstanding send operations, can't go to sleep */
+        return UCS_ERR_BUSY;
+    }
+
+    if (!(events & UCT_EVENT_RECV)) {
+        /* Nothing to do anymore */
+        return UCS_OK;
+    }
+
+    if (uct_mm_iface_bcast_has_data(iface)) {
+        ucs_trace("iface %p: cannot arm, broadcast data is pending", iface);
+        return UCS_ERR_BUSY;
+    }
+
+    /* Make the next sender which writes to any of the FIFO lanes signal the
+     * receiver */
+    for (i = 0; i < iface->config.fifo_lanes; ++i) {
+        lane = &iface->recv_lanes[i];
+        head = lane->fifo_ctl->head;
+        if ((head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED) > lane->read_index) {
+            /* head element was not read yet */
+            ucs_trace("iface %p: cannot arm, lane %u head %" PRIu64
+                      " read_index %" PRIu64,
+                      iface, i, head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED,
+                      lane->read_index);
+            return UCS_ERR_BUSY;
+        }
+
+        if (!(head & UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED)) {
+            /* Try to mark the head index as armed in an atomic way; fail if
+               any sender managed to update the head at the same time */
+            prev_head = ucs_atomic_cswap64(
+                    ucs_unaligned_ptr(&lane->fifo_ctl->head), head,
+                    head | UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED);
+            if (prev_head != head) {
+                /* race with sender; need to retry */
+                ucs_assert(!(prev_head & UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED));
+                ucs_trace("iface %p: cannot arm, lane %u head %" PRIu64
+                          " prev_head %" PRIu64,
+                          iface, i, head, prev_head);
+                return UCS_ERR_BUSY;
+            }
+        }
+    }
+
+    /* check for pending events */
+    status = uct_mm_iface_event_fd_check(iface);
+    if (status == UCS_OK) {
+        ucs_trace("iface %p: armed %u lanes", iface, iface->config.fifo_lanes);
+    }
+
+    return status;
+}
+
 static UCS_CLASS_DECLARE_DELETE_FUNC(uct_mm_iface_t, uct_iface_t);
 
+static ucs_mpool_ops_t uct_mm_zcopy_op_mpool_ops = {
+    .chunk_alloc   = ucs_mpool_chunk_malloc,
+    .chunk_release = ucs_mpool_chunk_free,
+    .obj_init      = NULL,
+    .obj_cleanup   = NULL,
+    .obj_str       = NULL
+};
+
 static uct_iface_ops_t uct_mm_iface_ops = {
     .ep_put_short             = uct_sm_ep_put_short,
     .ep_put_bcopy             = uct_sm_ep_put_bcopy,
@@ -508,6 +801,7 @@ static uct_iface_ops_t uct_mm_iface_ops = {
     .ep_am_short              = uct_mm_ep_am_short,
     .ep_am_short_iov          = uct_mm_ep_am_short_iov,
     .ep_am_bcopy              = uct_mm_ep_am_bcopy,
+    .ep_am_zcopy              = uct_mm_ep_am_zcopy,
     .ep_atomic_cswap64        = uct_sm_ep_atomic_cswap64,
     .ep_atomic64_post         = uct_sm_ep_atomic64_post,
     .ep_atomic64_fetch        = uct_sm_ep_atomic64_fetch,
@@ -597,16 +891,77 @@ uct_mm_estimate_perf(uct_iface_h tl_iface, uct_perf_attr_t *perf_attr)
     return UCS_OK;
 }
 
+static void uct_mm_iface_vfs_refresh(uct_iface_h tl_iface)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
+
+    ucs_vfs_obj_add_ro_file(iface, ucs_vfs_show_primitive,
+                            &iface->rseg_cache.hits, UCS_VFS_TYPE_ULONG,
+                            "attach_hits");
+    ucs_vfs_obj_add_ro_file(iface, ucs_vfs_show_primitive,
+                            &iface->rseg_cache.misses, UCS_VFS_TYPE_ULONG,
+                            "attach_misses");
+    ucs_vfs_obj_add_ro_file(iface, ucs_vfs_show_primitive,
+                            &iface->rseg_cache.evictions, UCS_VFS_TYPE_ULONG,
+                            "attach_evictions");
+    ucs_vfs_obj_add_ro_file(iface, ucs_vfs_show_primitive,
+                            &iface->rseg_cache.num_segs, UCS_VFS_TYPE_ULONG,
+                            "attached_segs");
+    ucs_vfs_obj_add_ro_file(iface, ucs_vfs_show_primitive,
+                            &iface->rseg_cache.total_size, UCS_VFS_TYPE_SIZET,
+                            "attached_size");
+}
+
 static uct_iface_internal_ops_t uct_mm_iface_internal_ops = {
     .iface_estimate_perf   = uct_mm_estimate_perf,
-    .iface_vfs_refresh     = (uct_iface_vfs_refresh_func_t)ucs_empty_function,
+    .iface_vfs_refresh     = uct_mm_iface_vfs_refresh,
     .ep_query              = (uct_ep_query_func_t)ucs_empty_function,
     .ep_invalidate         = (uct_ep_invalidate_func_t)ucs_empty_function_return_unsupported,
     .ep_connect_to_ep_v2   = ucs_empty_function_return_unsupported,
     .iface_is_reachable_v2 = uct_mm_iface_is_reachable_v2,
-    .ep_is_connected       = uct_mm_ep_is_connected
+    .ep_is_connected       = uct_mm_ep_is_connected,
+    .iface_am_bcast_bcopy  = uct_mm_iface_am_bcast_bcopy
 };
 
+static ucs_numa_node_t
+uct_mm_iface_get_numa_node(const uct_iface_params_t *params)
+{
+    ucs_numa_node_t node = UCS_NUMA_NODE_UNDEFINED;
+    ucs_sys_cpuset_t sys_cpuset;
+    ucs_cpu_set_t cpuset;
+
+    if (params->field_mask & UCT_IFACE_PARAM_FIELD_CPU_MASK) {
+        node = ucs_numa_node_of_cpuset(&params->cpu_mask);
+    }
+
+    /* the interface is usually progressed by the thread which created it */
+    if ((node == UCS_NUMA_NODE_UNDEFINED) &&
+        (ucs_sys_getaffinity(&sys_cpuset) == 0)) {
+        ucs_sys_cpuset_copy(&cpuset, &sys_cpuset);
+        node = ucs_numa_node_of_cpuset(&cpuset);
+    }
+
+    return node;
+}
+
+static void uct_mm_iface_mem_set_node(uct_mm_iface_t *iface, void *address,
+                                      size_t length, const char *name)
+{
+    ucs_status_t status;
+
+    if ((iface->numa_node == UCS_NUMA_NODE_UNDEFINED) ||
+        (ucs_numa_num_configured_nodes() <= 1)) {
+        return;
+    }
+
+    ucs_align_ptr_range(&address, &length, ucs_get_page_size());
+    status = ucs_numa_mem_set_node(address, length, iface->numa_node);
+    if (status != UCS_OK) {
+        ucs_diag("mm_iface %p: failed to place %s %p length %zu on NUMA "
+                 "node %d", iface, name, address, length, iface->numa_node);
+    }
+}
+
 static void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj,
                                         uct_mem_h memh)
 {
@@ -623,6 +978,13 @@ static void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj,
         return;
     }
 
+    if (seg->uid != iface->numa_seg_uid) {
+        /* first descriptor of a new memory pool chunk */
+        uct_mm_iface_mem_set_node(iface, seg->address, seg->length,
+                                  "receive descriptors");
+        iface->numa_seg_uid = seg->uid;
+    }
+
     offset = UCS_PTR_BYTE_DIFF(seg->address, desc + 1) + iface->rx_headroom;
     ucs_assert(offset <= UINT_MAX);
 
@@ -637,22 +999,28 @@ static void uct_mm_iface_free_rx_descs(uct_mm_iface_t *iface, unsigned num_elems
     uct_mm_recv_desc_t *desc;
     unsigned i;
 
+    /* elements are counted over all lanes, in lane order */
     for (i = 0; i < num_elems; i++) {
-        elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elems, i);
+        elem = UCT_MM_IFACE_GET_FIFO_ELEM(
+                iface, iface->recv_lanes[i / iface->config.fifo_size].fifo_elems,
+                i % iface->config.fifo_size);
         desc = (uct_mm_recv_desc_t*)UCS_PTR_BYTE_OFFSET(elem->desc_data,
                                                         -iface->rx_headroom) - 1;
         ucs_mpool_put(desc);
     }
 }
 
-void uct_mm_iface_set_fifo_ptrs(void *fifo_mem, uct_mm_fifo_ctl_t **fifo_ctl_p,
+void uct_mm_iface_set_fifo_ptrs(uct_mm_iface_t *iface, void *fifo_mem,
+                                unsigned lane, uct_mm_fifo_ctl_t **fifo_ctl_p,
                                 void **fifo_elems_p)
 {
     uct_mm_fifo_ctl_t *fifo_ctl;
 
     /* initiate the the uct_mm_fifo_ctl struct, holding the head and the tail */
-    fifo_ctl = (uct_mm_fifo_ctl_t*)ucs_align_up_pow2
-                    ((uintptr_t)fifo_mem, UCS_SYS_CACHE_LINE_SIZE);
+    fifo_ctl = (uct_mm_fifo_ctl_t*)UCS_PTR_BYTE_OFFSET(
+                    ucs_align_up_pow2((uintptr_t)fifo_mem,
+                                      UCS_SYS_CACHE_LINE_SIZE),
+                    lane * UCT_MM_GET_FIFO_LANE_SIZE(iface));
 
     /* Make sure head and tail are cache-aligned, and not on same cacheline, to
      * avoid false-sharing.
@@ -669,6 +1037,344 @@ void uct_mm_iface_set_fifo_ptrs(void *fifo_mem, uct_mm_fifo_ctl_t **fifo_ctl_p,
     *fifo_elems_p = UCS_PTR_BYTE_OFFSET(fifo_ctl, UCT_MM_FIFO_CTL_SIZE);
 }
 
+static ucs_status_t
+uct_mm_iface_rseg_map(uct_mm_iface_t *iface, uct_mm_iface_peer_t *peer,
+                      const void *iface_addr, uct_mm_iface_rseg_t *rseg,
+                      uct_mm_seg_id_t seg_id, size_t length)
+{
+    ucs_status_t status;
+
+    status = uct_mm_iface_mapper_call(iface, mem_attach, seg_id, length,
+                                      iface_addr, &rseg->super);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    rseg->seg_id                   = seg_id;
+    rseg->length                   = length;
+    rseg->uid                      = 0;
+    rseg->peer                     = peer;
+    iface->rseg_cache.total_size  += length;
+    ++iface->rseg_cache.num_segs;
+    ++iface->rseg_cache.misses;
+
+    ucs_debug("mm_iface %p: attached remote segment id 0x%"PRIx64" at %p "
+              "cookie %p", iface, seg_id, rseg->super.address,
+              rseg->super.cookie);
+    return UCS_OK;
+}
+
+static void
+uct_mm_iface_rseg_unmap(uct_mm_iface_t *iface, uct_mm_iface_rseg_t *rseg)
+{
+    ucs_debug("mm_iface %p: detaching remote segment id 0x%"PRIx64" at %p",
+              iface, rseg->seg_id, rseg->super.address);
+
+    uct_mm_iface_mapper_call(iface, mem_detach, &rseg->super);
+    iface->rseg_cache.total_size -= rseg->length;
+    --iface->rseg_cache.num_segs;
+}
+
+/* Detach all segments of a peer, its FIFO must not be on the LRU list */
+static void uct_mm_iface_peer_destroy(uct_mm_iface_t *iface,
+                                      uct_mm_iface_peer_t *peer)
+{
+    uct_mm_iface_rseg_t *rseg;
+
+    uct_mm_iface_bcast_unsubscribe(iface, peer);
+    kh_foreach_value(&peer->segs, rseg, {
+        ucs_list_del(&rseg->lru_list);
+        uct_mm_iface_rseg_unmap(iface, rseg);
+        ucs_free(rseg);
+    })
+    kh_destroy_inplace(uct_mm_iface_rseg, &peer->segs);
+
+    uct_mm_iface_rseg_unmap(iface, &peer->fifo);
+    ucs_free(peer);
+}
+
+static void
+uct_mm_iface_rseg_evict(uct_mm_iface_t *iface, uct_mm_iface_rseg_t *rseg)
+{
+    uct_mm_iface_peer_t *peer = rseg->peer;
+    khiter_t khiter;
+
+    ucs_list_del(&rseg->lru_list);
+    ++iface->rseg_cache.evictions;
+
+    if (peer == NULL) {
+        khiter = kh_get(uct_mm_iface_rseg, &iface->rseg_cache.zcopy_segs,
+                        rseg->uid);
+        ucs_assert(khiter != kh_end(&iface->rseg_cache.zcopy_segs));
+        kh_del(uct_mm_iface_rseg, &iface->rseg_cache.zcopy_segs, khiter);
+        uct_mm_iface_rseg_unmap(iface, rseg);
+        ucs_free(rseg);
+    } else if (rseg == &peer->fifo) {
+        /* Remote FIFO is evicted only when there are no endpoints to it */
+        ucs_assert((peer->refcount == 0) && !peer->stale);
+        khiter = kh_get(uct_mm_iface_peer, &iface->rseg_cache.peers,
+                        peer->fifo.seg_id);
+        ucs_assert(khiter != kh_end(&iface->rseg_cache.peers));
+        kh_del(uct_mm_iface_peer, &iface->rseg_cache.peers, khiter);
+        uct_mm_iface_peer_destroy(iface, peer);
+    } else {
+        khiter = kh_get(uct_mm_iface_rseg, &peer->segs, rseg->seg_id);
+        ucs_assert(khiter != kh_end(&peer->segs));
+        kh_del(uct_mm_iface_rseg, &peer->segs, khiter);
+        uct_mm_iface_rseg_unmap(iface, rseg);
+        ucs_free(rseg);
+    }
+}
+
+/* Evict least recently used segments to make room for a new one */
+static void uct_mm_iface_rseg_cache_trim(uct_mm_iface_t *iface, size_t length)
+{
+    while (!ucs_list_is_empty(&iface->rseg_cache.lru) &&
+           ((iface->rseg_cache.num_segs >= iface->config.attach_max_segs) ||
+            ((iface->rseg_cache.total_size + length) >
+             iface->config.attach_max_size))) {
+        uct_mm_iface_rseg_evict(iface,
+                                ucs_list_tail(&iface->rseg_cache.lru,
+                                              uct_mm_iface_rseg_t, lru_list));
+    }
+}
+
+static int
+uct_mm_iface_peer_is_closed(uct_mm_iface_t *iface, uct_mm_iface_peer_t *peer)
+{
+    uct_mm_fifo_ctl_t *fifo_ctl;
+    void *fifo_elems;
+
+    uct_mm_iface_set_fifo_ptrs(iface, peer->fifo.super.address, 0, &fifo_ctl,
+                               &fifo_elems);
+    return fifo_ctl->closed;
+}
+
+ucs_status_t uct_mm_iface_peer_get(uct_mm_iface_t *iface,
+                                   const uct_mm_iface_addr_t *iface_addr,
+                                   uct_mm_iface_peer_t **peer_p)
+{
+    uct_mm_md_t *md = ucs_derived_of(iface->super.super.md, uct_mm_md_t);
+    uct_mm_iface_peer_t *peer;
+    ucs_status_t status;
+    khiter_t khiter;
+    int khret;
+
+    khiter = kh_get(uct_mm_iface_peer, &iface->rseg_cache.peers,
+                    iface_addr->fifo_seg_id);
+    if (khiter != kh_end(&iface->rseg_cache.peers)) {
+        peer = kh_val(&iface->rseg_cache.peers, khiter);
+        if (!uct_mm_iface_peer_is_closed(iface, peer)) {
+            if (peer->refcount++ == 0) {
+                ucs_list_del(&peer->fifo.lru_list);
+                uct_mm_iface_bcast_subscribe(iface, peer);
+            }
+
+            ++iface->rseg_cache.hits;
+            *peer_p = peer;
+            return UCS_OK;
+        }
+
+        /* The remote interface was closed, and a new one reused its FIFO
+         * segment id. Endpoints to the old one keep using its segments. */
+        ucs_debug("mm_iface %p: remote FIFO id 0x%"PRIx64" was closed",
+                  iface, iface_addr->fifo_seg_id);
+        kh_del(uct_mm_iface_peer, &iface->rseg_cache.peers, khiter);
+        peer->stale = 1;
+        if (peer->refcount == 0) {
+            ucs_list_del(&peer->fifo.lru_list);
+            uct_mm_iface_peer_destroy(iface, peer);
+        }
+    }
+
+    uct_mm_iface_rseg_cache_trim(iface, UCT_MM_GET_FIFO_SIZE(iface));
+
+    peer = ucs_calloc(1, sizeof(*peer) + md->iface_addr_len, "mm_iface_peer");
+    if (peer == NULL) {
+        ucs_error("failed to allocate mm remote interface descriptor");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    memcpy(peer->iface_addr, iface_addr + 1, md->iface_addr_len);
+    kh_init_inplace(uct_mm_iface_rseg, &peer->segs);
+
+    status = uct_mm_iface_rseg_map(iface, peer, peer->iface_addr, &peer->fifo,
+                                   iface_addr->fifo_seg_id,
+                                   UCT_MM_GET_FIFO_SIZE(iface));
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
+    khiter = kh_put(uct_mm_iface_peer, &iface->rseg_cache.peers,
+                    iface_addr->fifo_seg_id, &khret);
+    if (khret == UCS_KH_PUT_FAILED) {
+        ucs_error("failed to add remote interface to mm iface hash");
+        status = UCS_ERR_NO_MEMORY;
+        goto err_unmap;
+    }
+
+    ucs_assert_always((khret == UCS_KH_PUT_BUCKET_EMPTY) ||
+                      (khret == UCS_KH_PUT_BUCKET_CLEAR));
+    kh_val(&iface->rseg_cache.peers, khiter) = peer;
+    peer->refcount                           = 1;
+    *peer_p                                  = peer;
+    uct_mm_iface_bcast_subscribe(iface, peer);
+    return UCS_OK;
+
+err_unmap:
+    uct_mm_iface_rseg_unmap(iface, &peer->fifo);
+err_free:
+    kh_destroy_inplace(uct_mm_iface_rseg, &peer->segs);
+    ucs_free(peer);
+    return status;
+}
+
+void uct_mm_iface_peer_put(uct_mm_iface_t *iface, uct_mm_iface_peer_t *peer)
+{
+    ucs_assert(peer->refcount > 0);
+    if (--peer->refcount > 0) {
+        return;
+    }
+
+    /* Broadcast messages are received only while there are endpoints */
+    uct_mm_iface_bcast_unsubscribe(iface, peer);
+    if (peer->stale) {
+        uct_mm_iface_peer_destroy(iface, peer);
+    } else {
+        /* Keep the remote FIFO attached for future endpoints */
+        ucs_list_add_head(&iface->rseg_cache.lru, &peer->fifo.lru_list);
+    }
+}
+
+ucs_status_t uct_mm_iface_rseg_attach(uct_mm_iface_t *iface,
+                                      uct_mm_iface_peer_t *peer,
+                                      uct_mm_seg_id_t seg_id, size_t length,
+                                      void **address_p)
+{
+    uct_mm_iface_rseg_t *rseg;
+    ucs_status_t status;
+    khiter_t khiter;
+    int khret;
+
+    /* The peer is in use by the calling endpoint, so its FIFO is not evicted */
+    uct_mm_iface_rseg_cache_trim(iface, length);
+
+    rseg = ucs_malloc(sizeof(*rseg), "mm_iface_rseg");
+    if (rseg == NULL) {
+        ucs_error("failed to allocate mm remote segment descriptor");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    khiter = kh_put(uct_mm_iface_rseg, &peer->segs, seg_id, &khret);
+    if (khret == UCS_KH_PUT_FAILED) {
+        ucs_error("failed to add remote segment to mm iface hash");
+        status = UCS_ERR_NO_MEMORY;
+        goto err_free;
+    }
+
+    /* we expect the key would either be
+     * never used (BUCKET_EMPTY) or deleted (BUCKET_CLEAR) */
+    ucs_assert_always((khret == UCS_KH_PUT_BUCKET_EMPTY) ||
+                      (khret == UCS_KH_PUT_BUCKET_CLEAR));
+
+    status = uct_mm_iface_rseg_map(iface, peer, peer->iface_addr, rseg, seg_id,
+                                   length);
+    if (status != UCS_OK) {
+        kh_del(uct_mm_iface_rseg, &peer->segs, khiter);
+        goto err_free;
+    }
+
+    kh_val(&peer->segs, khiter) = rseg;
+    ucs_list_add_head(&iface->rseg_cache.lru, &rseg->lru_list);
+    *address_p = rseg->super.address;
+    return UCS_OK;
+
+err_free:
+    ucs_free(rseg);
+    return status;
+}
+
+ucs_status_t uct_mm_iface_zcopy_seg_get(uct_mm_iface_t *iface,
+                                        const uct_mm_zcopy_desc_t *zdesc,
+                                        const void *iface_addr,
+                                        void **address_p)
+{
+    uct_mm_iface_rseg_t *rseg;
+    ucs_status_t status;
+    khiter_t khiter;
+    int khret;
+
+    khiter = kh_get(uct_mm_iface_rseg, &iface->rseg_cache.zcopy_segs,
+                    zdesc->uid);
+    if (ucs_likely(khiter != kh_end(&iface->rseg_cache.zcopy_segs))) {
+        rseg = kh_val(&iface->rseg_cache.zcopy_segs, khiter);
+        uct_mm_iface_rseg_touch(iface, rseg);
+        ++iface->rseg_cache.hits;
+        *address_p = rseg->super.address;
+        return UCS_OK;
+    }
+
+    uct_mm_iface_rseg_cache_trim(iface, zdesc->seg_length);
+
+    rseg = ucs_malloc(sizeof(*rseg), "mm_iface_zcopy_rseg");
+    if (rseg == NULL) {
+        ucs_error("failed to allocate mm remote segment descriptor");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    khiter = kh_put(uct_mm_iface_rseg, &iface->rseg_cache.zcopy_segs,
+                    zdesc->uid, &khret);
+    if (khret == UCS_KH_PUT_FAILED) {
+        ucs_error("failed to add remote segment to mm iface hash");
+        status = UCS_ERR_NO_MEMORY;
+        goto err_free;
+    }
+
+    ucs_assert_always((khret == UCS_KH_PUT_BUCKET_EMPTY) ||
+                      (khret == UCS_KH_PUT_BUCKET_CLEAR));
+
+    status = uct_mm_iface_rseg_map(iface, NULL, iface_addr, rseg,
+                                   zdesc->seg_id, zdesc->seg_length);
+    if (status != UCS_OK) {
+        kh_del(uct_mm_iface_rseg, &iface->rseg_cache.zcopy_segs, khiter);
+        goto err_free;
+    }
+
+    rseg->uid                                     = zdesc->uid;
+    kh_val(&iface->rseg_cache.zcopy_segs, khiter) = rseg;
+    ucs_list_add_head(&iface->rseg_cache.lru, &rseg->lru_list);
+    *address_p = rseg->super.address;
+    return UCS_OK;
+
+err_free:
+    ucs_free(rseg);
+    return status;
+}
+
+static void uct_mm_iface_rseg_cache_cleanup(uct_mm_iface_t *iface)
+{
+    uct_mm_iface_peer_t *peer;
+    uct_mm_iface_rseg_t *rseg;
+
+    kh_foreach_value(&iface->rseg_cache.zcopy_segs, rseg, {
+        ucs_list_del(&rseg->lru_list);
+        uct_mm_iface_rseg_unmap(iface, rseg);
+        ucs_free(rseg);
+    })
+    kh_destroy_inplace(uct_mm_iface_rseg, &iface->rseg_cache.zcopy_segs);
+
+    kh_foreach_value(&iface->rseg_cache.peers, peer, {
+        if (peer->refcount > 0) {
+            ucs_warn("mm_iface %p: remote FIFO id 0x%"PRIx64" has %u "
+                     "endpoints", iface, peer->fifo.seg_id, peer->refcount);
+        } else {
+            ucs_list_del(&peer->fifo.lru_list);
+        }
+        uct_mm_iface_peer_destroy(iface, peer);
+    })
+    kh_destroy_inplace(uct_mm_iface_peer, &iface->rseg_cache.peers);
+}
+
 static ucs_status_t uct_mm_iface_create_signal_fd(uct_mm_iface_t *iface)
 {
     ucs_status_t status;
@@ -723,14 +1429,98 @@ err:
     return status;
 }
 
+#ifdef HAVE_LINUX_FUTEX_H
+static void *uct_mm_iface_wakeup_thread_func(void *arg)
+{
+    uct_mm_iface_t *iface  = arg;
+    uct_mm_fifo_ctl_t *ctl = iface->recv_fifo_ctl;
+    uint32_t seq           = ctl->wakeup_seq;
+    uint32_t new_seq;
+
+    while (!iface->wakeup.stop) {
+        /* Register as a waiter before checking the futex word, so a sender
+         * which bumped it after the check would see the waiter and wake us.
+         * The atomic add is a full barrier which orders these two accesses. */
+        ucs_atomic_add32(ucs_unaligned_ptr(&ctl->wakeup_waiters), 1);
+        if (ctl->wakeup_seq == seq) {
+            ucs_sys_futex(&ctl->wakeup_seq, FUTEX_WAIT, seq, NULL, NULL, 0);
+        }
+
+        ucs_atomic_sub32(ucs_unaligned_ptr(&ctl->wakeup_waiters), 1);
+
+        new_seq = ctl->wakeup_seq;
+        if ((new_seq != seq) && !iface->wakeup.stop) {
+            ucs_trace("iface %p: futex wakeup seq %u", iface, new_seq);
+            ucs_async_eventfd_signal(iface->wakeup.event_fd);
+        }
+        seq = new_seq;
+    }
+
+    return NULL;
+}
+#endif
+
+static ucs_status_t uct_mm_iface_wakeup_init(uct_mm_iface_t *iface)
+{
+    ucs_status_t status;
+
+    iface->recv_fifo_ctl->wakeup_seq     = 0;
+    iface->recv_fifo_ctl->wakeup_waiters = 0;
+    iface->recv_fifo_ctl->wakeup_mode    = iface->config.wakeup_mode;
+    iface->wakeup.event_fd               = UCS_ASYNC_EVENTFD_INVALID_FD;
+    iface->wakeup.stop                   = 0;
+
+    if (iface->config.wakeup_mode != UCT_MM_WAKEUP_MODE_FUTEX) {
+        return UCS_OK;
+    }
+
+#ifdef HAVE_LINUX_FUTEX_H
+    status = ucs_async_eventfd_create(&iface->wakeup.event_fd);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucs_pthread_create(&iface->wakeup.thread,
+                                uct_mm_iface_wakeup_thread_func, iface,
+                                "mm_wakeup");
+    if (status != UCS_OK) {
+        ucs_async_eventfd_destroy(iface->wakeup.event_fd);
+        return status;
+    }
+
+    return UCS_OK;
+#else
+    ucs_error("mm: futex wakeup mode is not supported on this platform");
+    status = UCS_ERR_UNSUPPORTED;
+    return status;
+#endif
+}
+
+static void uct_mm_iface_wakeup_cleanup(uct_mm_iface_t *iface)
+{
+    if (iface->config.wakeup_mode != UCT_MM_WAKEUP_MODE_FUTEX) {
+        return;
+    }
+
+#ifdef HAVE_LINUX_FUTEX_H
+    iface->wakeup.stop = 1;
+    ucs_atomic_add32(&iface->recv_fifo_ctl->wakeup_seq, 1);
+    ucs_sys_futex(&iface->recv_fifo_ctl->wakeup_seq, FUTEX_WAKE, 1, NULL, NULL,
+                  0);
+    pthread_join(iface->wakeup.thread, NULL);
+    ucs_async_eventfd_destroy(iface->wakeup.event_fd);
+#endif
+}
+
 static void uct_mm_iface_log_created(uct_mm_iface_t *iface)
 {
     uct_mm_seg_t *seg = iface->recv_fifo_mem.memh;
 
     ucs_debug("created mm iface %p FIFO id 0x%"PRIx64
-              " va %p size %zu (%u x %u elems)",
+              " va %p size %zu (%u lanes of %u x %u elems) numa node %d",
               iface, seg->seg_id, seg->address, seg->length,
-              iface->config.fifo_elem_size, iface->config.fifo_size);
+              iface->config.fifo_lanes, iface->config.fifo_elem_size,
+              iface->config.fifo_size, iface->numa_node);
 }
 
 static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
@@ -739,8 +1529,12 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
 {
     uct_mm_iface_config_t *mm_config =
                     ucs_derived_of(tl_config, uct_mm_iface_config_t);
+    uct_mm_md_t *mm_md               = ucs_derived_of(md, uct_mm_md_t);
     uct_mm_fifo_element_t* fifo_elem_p;
+    ucs_mpool_params_t mp_params;
+    unsigned zcopy_hdr_offset;
     size_t alignment, align_offset, payload_offset;
+    uct_mm_fifo_lane_t *lane;
     ucs_status_t status;
     unsigned i;
 
@@ -776,9 +1570,26 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         goto err;
     }
 
+    if (mm_config->fifo_lanes == 0) {
+        ucs_error("The MM FIFO must have at least one lane.");
+        status = UCS_ERR_INVALID_PARAM;
+        goto err;
+    }
+
+    if (mm_config->batch_size == 0) {
+        ucs_error("The MM batch size must be at least 1.");
+        status = UCS_ERR_INVALID_PARAM;
+        goto err;
+    }
+
     self->config.overhead          = mm_config->overhead;
     self->config.fifo_size         = mm_config->fifo_size;
     self->config.fifo_elem_size    = mm_config->fifo_elem_size;
+    self->config.fifo_lanes        = mm_config->fifo_lanes;
+    self->config.batch_size        = mm_config->batch_size;
+    self->config.wakeup_mode       = mm_config->wakeup_mode;
+    self->config.attach_max_segs   = mm_config->attach_max_segs;
+    self->config.attach_max_size   = mm_config->attach_max_size;
     self->config.seg_size          = mm_config->seg_size;
     self->config.fifo_max_poll     = ((mm_config->fifo_max_poll == UCS_ULUNITS_AUTO) ?
                                       UCT_MM_IFACE_FIFO_MAX_POLL :
@@ -800,6 +1611,31 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                                       UCT_IFACE_PARAM_FIELD_RX_HEADROOM) ?
                                      params->rx_headroom : 0;
     self->release_desc.cb          = uct_mm_iface_release_desc;
+    self->poll_lane                = 0;
+
+    /* zero-copy sends pass the descriptor of the sender's buffer and the AM
+     * header in the FIFO element, so they are enabled only if it fits */
+    zcopy_hdr_offset = sizeof(uct_mm_zcopy_desc_t) + mm_md->iface_addr_len;
+    if (mm_config->am_zcopy &&
+        (self->config.fifo_elem_size >= (sizeof(uct_mm_fifo_element_t) +
+                                         zcopy_hdr_offset))) {
+        self->config.zcopy_hdr_offset = zcopy_hdr_offset;
+    } else {
+        self->config.zcopy_hdr_offset = 0;
+    }
+
+    self->numa_node    = mm_config->numa_placement ?
+                         uct_mm_iface_get_numa_node(params) :
+                         UCS_NUMA_NODE_UNDEFINED;
+    self->numa_seg_uid = 0;
+
+    self->recv_lanes = ucs_calloc(self->config.fifo_lanes,
+                                  sizeof(*self->recv_lanes), "mm_recv_lanes");
+    if (self->recv_lanes == NULL) {
+        ucs_error("mm_iface failed to allocate receive FIFO lanes");
+        status = UCS_ERR_NO_MEMORY;
+        goto err;
+    }
 
     /* Allocate the receive FIFO */
     status = uct_iface_mem_alloc(&self->super.super.super,
@@ -808,31 +1644,53 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                                  &self->recv_fifo_mem);
     if (status != UCS_OK) {
         ucs_error("mm_iface failed to allocate receive FIFO");
-        return status;
+        goto err_free_lanes;
+    }
+
+    uct_mm_iface_mem_set_node(self, self->recv_fifo_mem.address,
+                              self->recv_fifo_mem.length, "receive FIFO");
+
+    for (i = 0; i < self->config.fifo_lanes; i++) {
+        lane = &self->recv_lanes[i];
+        uct_mm_iface_set_fifo_ptrs(self, self->recv_fifo_mem.address, i,
+                                   &lane->fifo_ctl, &lane->fifo_elems);
+        lane->fifo_ctl->head  = 0;
+        lane->fifo_ctl->tail  = 0;
+        lane->fifo_ctl->pid   = getpid();
+        lane->read_index      = 0;
+        lane->read_index_elem = UCT_MM_IFACE_GET_FIFO_ELEM(self,
+                                                           lane->fifo_elems,
+                                                           lane->read_index);
     }
 
-    uct_mm_iface_set_fifo_ptrs(self->recv_fifo_mem.address,
-                               &self->recv_fifo_ctl, &self->recv_fifo_elems);
-    self->recv_fifo_ctl->head = 0;
-    self->recv_fifo_ctl->tail = 0;
-    self->recv_fifo_ctl->pid  = getpid();
-    self->read_index          = 0;
-    self->read_index_elem     = UCT_MM_IFACE_GET_FIFO_ELEM(self,
-                                                           self->recv_fifo_elems,
-                                                           self->read_index);
-    payload_offset            = sizeof(uct_mm_recv_desc_t) + self->rx_headroom;
+    self->recv_fifo_ctl            = self->recv_lanes[0].fifo_ctl;
+    self->recv_fifo_ctl->num_lanes = self->config.fifo_lanes;
+    self->recv_fifo_ctl->next_lane = 0;
+    self->recv_fifo_ctl->closed    = 0;
+    payload_offset                 = sizeof(uct_mm_recv_desc_t) +
+                                     self->rx_headroom;
+
+    status = uct_mm_iface_bcast_init(self, mm_config->bcast_fifo_size);
+    if (status != UCS_OK) {
+        goto err_free_fifo;
+    }
 
     /* create a unix file descriptor to receive event notifications */
     status = uct_mm_iface_create_signal_fd(self);
     if (status != UCS_OK) {
-        goto err_free_fifo;
+        goto err_bcast_cleanup;
+    }
+
+    status = uct_mm_iface_wakeup_init(self);
+    if (status != UCS_OK) {
+        goto err_close_signal_fd;
     }
 
     status = uct_iface_param_am_alignment(params, self->config.seg_size,
                                           payload_offset, payload_offset,
                                           &alignment, &align_offset);
     if (status != UCS_OK) {
-        goto err_close_signal_fd;
+        goto err_wakeup_cleanup;
     }
 
     /* create a memory pool for receive descriptors */
@@ -843,7 +1701,7 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                                   uct_mm_iface_recv_desc_init, "mm_recv_desc");
     if (status != UCS_OK) {
         ucs_error("failed to create a receive descriptor memory pool for the MM transport");
-        goto err_close_signal_fd;
+        goto err_wakeup_cleanup;
     }
 
     /* set the first receive descriptor */
@@ -857,8 +1715,10 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
 
     /* initiate the owner bit in all the FIFO elements and assign a receive descriptor
      * per every FIFO element */
-    for (i = 0; i < mm_config->fifo_size; i++) {
-        fifo_elem_p = UCT_MM_IFACE_GET_FIFO_ELEM(self, self->recv_fifo_elems, i);
+    for (i = 0; i < (self->config.fifo_lanes * mm_config->fifo_size); i++) {
+        fifo_elem_p = UCT_MM_IFACE_GET_FIFO_ELEM(
+                self, self->recv_lanes[i / mm_config->fifo_size].fifo_elems,
+                i % mm_config->fifo_size);
         fifo_elem_p->flags = UCT_MM_FIFO_ELEM_FLAG_OWNER;
 
         status = uct_mm_assign_desc_to_fifo_elem(self, fifo_elem_p, 1);
@@ -868,20 +1728,50 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         }
     }
 
+    ucs_mpool_params_reset(&mp_params);
+    mp_params.elem_size       = sizeof(uct_mm_zcopy_op_t);
+    mp_params.elems_per_chunk = 128;
+    mp_params.ops             = &uct_mm_zcopy_op_mpool_ops;
+    mp_params.name            = "mm_zcopy_ops";
+    status = ucs_mpool_init(&mp_params, &self->zcopy.op_mp);
+    if (status != UCS_OK) {
+        ucs_error("failed to create a zero-copy operations memory pool for "
+                  "the MM transport");
+        goto destroy_descs_all;
+    }
+
+    ucs_queue_head_init(&self->zcopy.ops);
     ucs_arbiter_init(&self->arbiter);
+    ucs_list_head_init(&self->batch_eps);
+    kh_init_inplace(uct_mm_iface_peer, &self->rseg_cache.peers);
+    kh_init_inplace(uct_mm_iface_rseg, &self->rseg_cache.zcopy_segs);
+    ucs_list_head_init(&self->rseg_cache.lru);
+    self->rseg_cache.num_segs   = 0;
+    self->rseg_cache.total_size = 0;
+    self->rseg_cache.hits       = 0;
+    self->rseg_cache.misses     = 0;
+    self->rseg_cache.evictions  = 0;
     uct_mm_iface_log_created(self);
 
     return UCS_OK;
 
+destroy_descs_all:
+    i = self->config.fifo_lanes * mm_config->fifo_size;
 destroy_descs:
     uct_mm_iface_free_rx_descs(self, i);
     ucs_mpool_put(self->last_recv_desc);
 destroy_recv_mpool:
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
+err_wakeup_cleanup:
+    uct_mm_iface_wakeup_cleanup(self);
 err_close_signal_fd:
     close(self->signal_fd);
+err_bcast_cleanup:
+    uct_mm_iface_bcast_cleanup(self);
 err_free_fifo:
     uct_iface_mem_free(&self->recv_fifo_mem);
+err_free_lanes:
+    ucs_free(self->recv_lanes);
 err:
     return status;
 }
@@ -893,12 +1783,21 @@ static UCS_CLASS_CLEANUP_FUNC(uct_mm_iface_t)
 
     /* return all the descriptors that are now 'assigned' to the FIFO,
      * to their mpool */
-    uct_mm_iface_free_rx_descs(self, self->config.fifo_size);
+    uct_mm_iface_free_rx_descs(self, self->config.fifo_lanes *
+                                     self->config.fifo_size);
 
     ucs_mpool_put(self->last_recv_desc);
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
+    uct_mm_iface_wakeup_cleanup(self);
     close(self->signal_fd);
+
+    /* let peers which cached our FIFO know it is not valid anymore */
+    self->recv_fifo_ctl->closed = 1;
     uct_iface_mem_free(&self->recv_fifo_mem);
+    ucs_free(self->recv_lanes);
+    uct_mm_iface_rseg_cache_cleanup(self);
+    uct_mm_iface_bcast_cleanup(self);
+    ucs_mpool_cleanup(&self->zcopy.op_mp, 1);
     ucs_arbiter_cleanup(&self->arbiter);
 }
 
@@ -15,11 +15,17 @@
 #include <ucs/arch/cpu.h>
 #include <ucs/debug/memtrack_int.h>
 #include <ucs/datastruct/arbiter.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/list.h>
+#include <ucs/datastruct/mpool.h>
+#include <ucs/datastruct/queue.h>
+#include <ucs/memory/numa.h>
 #include <ucs/sys/compiler.h>
 #include <ucs/sys/ptr_arith.h>
 #include <ucs/sys/sys.h>
 #include <sys/shm.h>
 #include <sys/un.h>
+#include <pthread.h>
 
 
 enum {
@@ -29,6 +35,14 @@ enum {
 
     /* Whether the element data is inline or in receive descriptor */
     UCT_MM_FIFO_ELEM_FLAG_INLINE = UCS_BIT(1),
+
+    /* The element holds a zero-copy descriptor of the sender's buffer, see
+       @ref uct_mm_zcopy_desc_t */
+    UCT_MM_FIFO_ELEM_FLAG_ZCOPY  = UCS_BIT(2),
+
+    /* The element was reserved by a batch of the sender but not used, so the
+       receiver skips it */
+    UCT_MM_FIFO_ELEM_FLAG_NOP    = UCS_BIT(3)
 };
 
 
@@ -36,10 +50,15 @@ enum {
     ucs_align_up(sizeof(uct_mm_fifo_ctl_t), UCS_SYS_CACHE_LINE_SIZE)
 
 
+#define UCT_MM_GET_FIFO_LANE_SIZE(_iface) \
+    ucs_align_up(UCT_MM_FIFO_CTL_SIZE + \
+                 ((_iface)->config.fifo_size * (_iface)->config.fifo_elem_size), \
+                 UCS_SYS_CACHE_LINE_SIZE)
+
+
 #define UCT_MM_GET_FIFO_SIZE(_iface) \
-    (UCT_MM_FIFO_CTL_SIZE + \
-     ((_iface)->config.fifo_size * (_iface)->config.fifo_elem_size) + \
-      (UCS_SYS_CACHE_LINE_SIZE - 1))
+    (((_iface)->config.fifo_lanes * UCT_MM_GET_FIFO_LANE_SIZE(_iface)) + \
+     (UCS_SYS_CACHE_LINE_SIZE - 1))
 
 
 #define UCT_MM_IFACE_GET_FIFO_ELEM(_iface, _fifo, _index) \
@@ -57,13 +76,15 @@ enum {
 #define uct_mm_iface_trace_am(_iface, _type, _flags, _am_id, _data, _length, \
                               _elem_sn) \
     uct_iface_trace_am(&(_iface)->super.super, _type, _am_id, _data, _length, \
-                       "%cX [%lu] %c%c", \
+                       "%cX [%lu] %c%c%c%c", \
                        ((_type) == UCT_AM_TRACE_TYPE_RECV) ? 'R' : \
                        ((_type) == UCT_AM_TRACE_TYPE_SEND) ? 'T' : \
                                                              '?', \
                        (_elem_sn), \
                        ((_flags) & UCT_MM_FIFO_ELEM_FLAG_OWNER) ? 'o' : '-', \
-                       ((_flags) & UCT_MM_FIFO_ELEM_FLAG_INLINE) ? 'i' : '-')
+                       ((_flags) & UCT_MM_FIFO_ELEM_FLAG_INLINE) ? 'i' : '-', \
+                       ((_flags) & UCT_MM_FIFO_ELEM_FLAG_ZCOPY)  ? 'z' : '-', \
+                       ((_flags) & UCT_MM_FIFO_ELEM_FLAG_NOP)    ? 'n' : '-')
 
 
 /* AIMD (additive increase/multiplicative decrease) algorithm adopted for FIFO
@@ -87,6 +108,22 @@ enum {
 /* If this bit is set in fifo_ctl.head, trigger async event on the receiver  */
 #define UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED      UCS_BIT(63)
 
+/* Number of reader slots in a broadcast FIFO */
+#define UCT_MM_BCAST_MAX_READERS                64
+
+
+/**
+ * How a sender wakes up a receiver which armed its FIFO
+ */
+typedef enum {
+    /* Send a datagram to the receiver's Unix-domain socket */
+    UCT_MM_WAKEUP_MODE_SOCKET,
+    /* Bump a futex word in the FIFO control area, and call FUTEX_WAKE only if
+     * the receiver has a waiter sleeping on it */
+    UCT_MM_WAKEUP_MODE_FUTEX,
+    UCT_MM_WAKEUP_MODE_LAST
+} uct_mm_wakeup_mode_t;
+
 
 typedef struct uct_mm_iface_op_overhead {
     double am_short;
@@ -114,6 +151,19 @@ typedef struct uct_mm_iface_config {
     ucs_ternary_auto_value_t hugetlb_mode;        /* Enable using huge pages for
                                                    * shared memory buffers */
     unsigned                 fifo_elem_size;      /* Size of the FIFO element size */
+    unsigned                 fifo_lanes;          /* Number of receive FIFO lanes */
+    unsigned                 batch_size;          /* Maximal number of FIFO
+                                                   * elements reserved at once
+                                                   * for pending sends */
+    uct_mm_wakeup_mode_t     wakeup_mode;         /* Remote wakeup method */
+    unsigned long            attach_max_segs;     /* Maximal number of attached
+                                                   * remote segments */
+    size_t                   attach_max_size;     /* Maximal total size of
+                                                   * attached remote segments */
+    int                      am_zcopy;            /* Enable zero-copy AM */
+    int                      numa_placement;      /* Place receive resources on
+                                                   * the NUMA node of the CPUs */
+    unsigned                 bcast_fifo_size;     /* Size of the broadcast FIFO */
     int                      error_handling; /* Exposing of error handling cap */
     uct_iface_mpool_config_t mp;
     uct_mm_iface_overhead_t  overhead;
@@ -144,9 +194,70 @@ typedef struct uct_mm_fifo_ctl {
     /* 2nd cacheline */
     volatile uint64_t         tail;           /* How much was consumed */
     pid_t                     pid;            /* Process owner pid */
+    uint32_t                  num_lanes;      /* Number of FIFO lanes, valid
+                                                 only on the first lane */
+    volatile uint32_t         next_lane;      /* Lane to assign to the next
+                                                 connected sender, valid only
+                                                 on the first lane */
+    volatile uint32_t         wakeup_seq;     /* Futex word, bumped by senders
+                                                 to wake up the receiver */
+    volatile uint32_t         wakeup_waiters; /* Nonzero if the receiver sleeps
+                                                 on wakeup_seq */
+    uint8_t                   wakeup_mode;    /* uct_mm_wakeup_mode_t */
+    volatile uint8_t          closed;         /* Set by the owner when the FIFO
+                                                 is released, valid only on the
+                                                 first lane */
+    uct_mm_seg_id_t           bcast_seg_id;   /* Broadcast FIFO segment id,
+                                                 valid only on the first lane */
+    uint64_t                  bcast_seg_size; /* Broadcast FIFO segment size,
+                                                 or 0 if there is no broadcast
+                                                 FIFO, valid only on the first
+                                                 lane */
 } UCS_S_PACKED UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE) uct_mm_fifo_ctl_t;
 
 
+/**
+ * MM broadcast FIFO control, at the beginning of the broadcast FIFO segment.
+ * It is followed by the reader slots, and then by the FIFO elements. The FIFO
+ * has a single writer, which is the interface owning it, and may not overwrite
+ * an element before all the active readers consumed it.
+ */
+typedef struct uct_mm_bcast_ctl {
+    volatile uint64_t         head;           /* Sequence number of the next
+                                                 element to write */
+    uint32_t                  fifo_size;      /* Number of FIFO elements */
+    uint32_t                  elem_size;      /* Size of a FIFO element */
+    uint32_t                  num_readers;    /* Number of reader slots */
+} UCS_S_PACKED UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE) uct_mm_bcast_ctl_t;
+
+
+/**
+ * MM broadcast FIFO reader slot, claimed by a remote interface which has
+ * endpoints to the FIFO owner
+ */
+typedef struct uct_mm_bcast_reader {
+    volatile uint64_t         tail;           /* Sequence number of the next
+                                                 element to read */
+    volatile uint32_t         pid;            /* Reader process, or 0 if the
+                                                 slot is free */
+    volatile uint32_t         active;         /* Whether the writer waits for
+                                                 the reader to consume the
+                                                 elements */
+} UCS_S_PACKED UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE) uct_mm_bcast_reader_t;
+
+
+/**
+ * MM broadcast FIFO element, followed by the active message data
+ */
+typedef struct uct_mm_bcast_elem {
+    volatile uint64_t         sn;             /* Sequence number, written after
+                                                 the data to indicate the
+                                                 element is ready */
+    uint32_t                  length;         /* Length of the data */
+    uint8_t                   am_id;          /* Active message id */
+} UCS_S_PACKED uct_mm_bcast_elem_t;
+
+
 /**
  * MM receive descriptor info in the shared FIFO
  */
@@ -175,6 +286,33 @@ typedef struct uct_mm_fifo_element {
 } UCS_S_PACKED uct_mm_fifo_element_t;
 
 
+/**
+ * State of a zero-copy FIFO element, the sender may cancel the element only
+ * before the receiver starts reading the payload.
+ */
+enum {
+    UCT_MM_ZCOPY_STATE_POSTED,
+    UCT_MM_ZCOPY_STATE_READING,
+    UCT_MM_ZCOPY_STATE_CANCELED
+};
+
+
+/**
+ * MM zero-copy descriptor, follows the FIFO element header when the element is
+ * marked with UCT_MM_FIFO_ELEM_FLAG_ZCOPY. It is followed by the mapper-specific
+ * address of the sender, which is needed to attach its segment, and then by the
+ * AM header, whose length is the element length.
+ */
+typedef struct uct_mm_zcopy_desc {
+    volatile uint32_t         state;          /* UCT_MM_ZCOPY_STATE_xx */
+    uct_mm_seg_id_t           seg_id;         /* sender's segment id */
+    uint64_t                  uid;            /* sender's segment unique id */
+    uint64_t                  seg_length;     /* sender's segment length */
+    uint64_t                  offset;         /* payload offset in the segment */
+    uint32_t                  length;         /* payload length */
+} UCS_S_PACKED uct_mm_zcopy_desc_t;
+
+
 /*
  * MM receive descriptor:
  *
@@ -190,6 +328,95 @@ typedef struct uct_mm_recv_desc {
 } uct_mm_recv_desc_t;
 
 
+/**
+ * MM receive FIFO lane. The receive FIFO segment holds one or more lanes, each
+ * one is a separate ring with its own head and tail, so senders which were
+ * assigned to different lanes do not contend on the same head cache line.
+ */
+typedef struct uct_mm_fifo_lane {
+    uct_mm_fifo_ctl_t       *fifo_ctl;        /* pointer to the struct at the */
+                                              /* beginning of the lane */
+                                              /* which holds the head and the tail. */
+                                              /* this struct is cache line aligned */
+    void                    *fifo_elems;      /* pointer to the first fifo element
+                                                 in the lane */
+    uct_mm_fifo_element_t   *read_index_elem;
+    uint64_t                read_index;       /* actual reading location */
+} uct_mm_fifo_lane_t;
+
+
+/**
+ * Remote segment attached by the interface
+ */
+typedef struct uct_mm_iface_rseg {
+    uct_mm_remote_seg_t       super;
+    uct_mm_seg_id_t           seg_id;
+    size_t                    length;
+    uint64_t                  uid;            /* Segment unique id, valid only
+                                                 for zero-copy segments */
+    struct uct_mm_iface_peer  *peer;          /* Peer which owns the segment,
+                                                 NULL for zero-copy segments */
+    ucs_list_link_t           lru_list;       /* Entry in the interface LRU
+                                                 list, valid only if the
+                                                 segment may be evicted */
+} uct_mm_iface_rseg_t;
+
+
+KHASH_INIT(uct_mm_iface_rseg, uct_mm_seg_id_t, uct_mm_iface_rseg_t*, 1,
+           kh_int64_hash_func, kh_int64_hash_equal)
+
+
+/**
+ * Remote interface the local interface has endpoints to. Its receive FIFO and
+ * receive descriptor segments are attached once and shared by all endpoints to
+ * it, and remain attached after the last endpoint is destroyed, until evicted.
+ * The FIFO segment may be evicted only when there are no endpoints, and the
+ * descriptor segments may be evicted at any time, since endpoints access them
+ * only during a send operation.
+ */
+typedef struct uct_mm_iface_peer {
+    uct_mm_iface_rseg_t       fifo;           /* Receive FIFO segment */
+    khash_t(uct_mm_iface_rseg) segs;          /* Receive descriptor segments */
+    struct uct_mm_bcast_source *bcast;        /* Broadcast FIFO which is read
+                                                 while there are endpoints, or
+                                                 NULL */
+    unsigned                  refcount;       /* Number of endpoints */
+    int                       stale;          /* Removed from the peers hash */
+    uint8_t                   iface_addr[];   /* Mapper-specific address */
+} uct_mm_iface_peer_t;
+
+
+KHASH_INIT(uct_mm_iface_peer, uct_mm_seg_id_t, uct_mm_iface_peer_t*, 1,
+           kh_int64_hash_func, kh_int64_hash_equal)
+
+
+/**
+ * Broadcast FIFO of a remote interface, read by the local interface
+ */
+typedef struct uct_mm_bcast_source {
+    ucs_list_link_t           list;           /* Entry in the interface list */
+    uct_mm_remote_seg_t       seg;            /* Attached FIFO segment */
+    uct_mm_bcast_ctl_t        *ctl;           /* FIFO control */
+    uct_mm_bcast_reader_t     *reader;        /* Claimed reader slot */
+    void                      *elems;         /* First FIFO element */
+    uint64_t                  tail;           /* Next element to read */
+    int                       released;       /* Released by the callback of
+                                                 the element being read */
+} uct_mm_bcast_source_t;
+
+
+/**
+ * Zero-copy send which is not completed yet. It is completed when the tail of
+ * the remote FIFO lane passes the element with the given sequence number.
+ */
+typedef struct uct_mm_zcopy_op {
+    ucs_queue_elem_t          queue;          /* Entry in the interface queue */
+    struct uct_mm_ep          *ep;            /* Sending endpoint */
+    uint64_t                  sn;             /* FIFO element sequence number */
+    uct_completion_t          *comp;          /* User completion, may be NULL */
+} uct_mm_zcopy_op_t;
+
+
 /**
  * MM transport interface
  */
@@ -199,16 +426,11 @@ typedef struct uct_mm_iface {
     /* Receive FIFO */
     uct_allocated_memory_t  recv_fifo_mem;
 
-    uct_mm_fifo_ctl_t       *recv_fifo_ctl;   /* pointer to the struct at the */
-                                              /* beginning of the receive fifo */
-                                              /* which holds the head and the tail. */
-                                              /* this struct is cache line aligned and */
-                                              /* doesn't necessarily start where */
-                                              /* shared_mem starts */
-    void                    *recv_fifo_elems; /* pointer to the first fifo element
-                                                 in the receive fifo */
-    uct_mm_fifo_element_t   *read_index_elem;
-    uint64_t                read_index;       /* actual reading location */
+    uct_mm_fifo_ctl_t       *recv_fifo_ctl;   /* control struct of the first
+                                                 lane, holds the signaling
+                                                 address and owner pid */
+    uct_mm_fifo_lane_t      *recv_lanes;      /* receive FIFO lanes */
+    unsigned                poll_lane;        /* lane to start polling from */
 
     uint8_t                 fifo_shift;       /* = log2(fifo_size) */
     unsigned                fifo_mask;        /* = 2^fifo_shift - 1 */
@@ -222,18 +444,79 @@ typedef struct uct_mm_iface {
     ucs_mpool_t             recv_desc_mp;
     uct_mm_recv_desc_t      *last_recv_desc;  /* next receive descriptor to use */
 
+    ucs_numa_node_t         numa_node;        /* NUMA node of the receive FIFO
+                                                 and descriptors, or undefined
+                                                 if they are not placed */
+    uint64_t                numa_seg_uid;     /* last receive descriptors
+                                                 segment placed on numa_node */
+
     int                     signal_fd;        /* Unix socket for receiving remote signal */
 
+    struct {
+        int                 event_fd;         /* Event fd signaled by the
+                                                 wakeup thread */
+        pthread_t           thread;           /* Thread which sleeps on the
+                                                 FIFO futex word */
+        volatile int        stop;             /* Wakeup thread stop flag */
+    } wakeup;
+
     size_t                  rx_headroom;
     ucs_arbiter_t           arbiter;
+    ucs_list_link_t         batch_eps;        /* Endpoints with reserved FIFO
+                                                 elements which were not
+                                                 published yet */
     uct_recv_desc_t         release_desc;
 
+    /* Cache of attached remote segments */
+    struct {
+        khash_t(uct_mm_iface_peer) peers;     /* Peers by FIFO segment id */
+        khash_t(uct_mm_iface_rseg) zcopy_segs; /* Zero-copy send buffers of
+                                                  remote senders, by unique
+                                                  segment id */
+        ucs_list_link_t     lru;              /* Segments which may be evicted,
+                                                 most recently used first */
+        unsigned long       num_segs;         /* Number of attached segments */
+        size_t              total_size;       /* Total size of attached
+                                                 segments */
+        unsigned long       hits;
+        unsigned long       misses;
+        unsigned long       evictions;
+    } rseg_cache;
+
+    /* Broadcast FIFO written by the interface, and the ones it reads */
+    struct {
+        uct_allocated_memory_t mem;           /* FIFO segment */
+        uct_mm_bcast_ctl_t  *ctl;             /* FIFO control, or NULL if
+                                                 broadcast is disabled */
+        void                *elems;           /* First FIFO element */
+        uint64_t            min_tail;         /* Minimal tail of the readers
+                                                 when it was last checked */
+        ucs_list_link_t     sources;          /* FIFOs of the peers */
+        uct_mm_bcast_source_t *dispatch;      /* FIFO whose element is being
+                                                 passed to the user */
+    } bcast;
+
+    /* Outstanding zero-copy sends */
+    struct {
+        ucs_mpool_t         op_mp;            /* Memory pool of operations */
+        ucs_queue_head_t    ops;              /* Operations waiting for the
+                                                 receiver to consume them */
+    } zcopy;
+
     struct {
         unsigned                fifo_size;
         unsigned                fifo_elem_size;
+        unsigned                fifo_lanes;
+        unsigned                batch_size;
+        uct_mm_wakeup_mode_t    wakeup_mode;
+        unsigned long           attach_max_segs;
+        size_t                  attach_max_size;
         /* size of the receive descriptor (for payload) */
         unsigned                seg_size;
         unsigned                fifo_max_poll;
+        /* offset of the AM header in a zero-copy FIFO element, or 0 if the
+         * FIFO element is too small for zero-copy sends */
+        unsigned                zcopy_hdr_offset;
         uint64_t                extra_cap_flags;
         uct_mm_iface_overhead_t overhead;
     } config;
@@ -289,16 +572,118 @@ uct_mm_iface_invoke_am(uct_mm_iface_t *iface, uint8_t am_id, void *data,
 
 
 /**
- * Set aligned pointers of the FIFO according to the beginning of the allocated
- * memory.
+ * Set aligned pointers of a FIFO lane according to the beginning of the
+ * allocated memory.
+ * @param [in] iface         MM interface which defines the FIFO geometry.
  * @param [in] fifo_mem      Pointer to the beginning of the allocated memory.
- * @param [out] fifo_ctl_p   Pointer to the FIFO control structure.
- * @param [out] fifo_elems   Pointer to the array of FIFO elements.
+ * @param [in] lane          Index of the FIFO lane.
+ * @param [out] fifo_ctl_p   Pointer to the FIFO lane control structure.
+ * @param [out] fifo_elems   Pointer to the array of FIFO lane elements.
  */
-void uct_mm_iface_set_fifo_ptrs(void *fifo_mem, uct_mm_fifo_ctl_t **fifo_ctl_p,
+void uct_mm_iface_set_fifo_ptrs(uct_mm_iface_t *iface, void *fifo_mem,
+                                unsigned lane, uct_mm_fifo_ctl_t **fifo_ctl_p,
                                 void **fifo_elems_p);
 
 
+/**
+ * Get a reference to a remote interface, attaching its receive FIFO if needed.
+ * @param [in] iface         MM interface.
+ * @param [in] iface_addr    Address of the remote interface.
+ * @param [out] peer_p       Filled with the remote interface descriptor.
+ */
+ucs_status_t uct_mm_iface_peer_get(uct_mm_iface_t *iface,
+                                   const uct_mm_iface_addr_t *iface_addr,
+                                   uct_mm_iface_peer_t **peer_p);
+
+
+/**
+ * Release a reference to a remote interface obtained by
+ * @ref uct_mm_iface_peer_get.
+ */
+void uct_mm_iface_peer_put(uct_mm_iface_t *iface, uct_mm_iface_peer_t *peer);
+
+
+/**
+ * Attach a receive descriptor segment of a remote interface, which was not
+ * found in the peer's segments hash.
+ */
+ucs_status_t uct_mm_iface_rseg_attach(uct_mm_iface_t *iface,
+                                      uct_mm_iface_peer_t *peer,
+                                      uct_mm_seg_id_t seg_id, size_t length,
+                                      void **address_p);
+
+
+/**
+ * Attach the segment of a remote sender, which holds the payload of a received
+ * zero-copy active message.
+ * @param [in] iface         MM interface.
+ * @param [in] zdesc         Zero-copy descriptor from the FIFO element.
+ * @param [in] iface_addr    Mapper-specific address of the sender.
+ * @param [out] address_p    Filled with the local address of the segment.
+ */
+ucs_status_t uct_mm_iface_zcopy_seg_get(uct_mm_iface_t *iface,
+                                        const uct_mm_zcopy_desc_t *zdesc,
+                                        const void *iface_addr,
+                                        void **address_p);
+
+
+/* Mark a cached remote segment as most recently used */
+static UCS_F_ALWAYS_INLINE void
+uct_mm_iface_rseg_touch(uct_mm_iface_t *iface, uct_mm_iface_rseg_t *rseg)
+{
+    if (iface->rseg_cache.lru.next != &rseg->lru_list) {
+        ucs_list_del(&rseg->lru_list);
+        ucs_list_add_head(&iface->rseg_cache.lru, &rseg->lru_list);
+    }
+}
+
+
+/**
+ * Allocate the broadcast FIFO of the interface, if it is enabled.
+ * @param [in] iface         MM interface.
+ * @param [in] fifo_size     Number of FIFO elements, 0 to disable.
+ */
+ucs_status_t uct_mm_iface_bcast_init(uct_mm_iface_t *iface, unsigned fifo_size);
+
+
+/**
+ * Release the broadcast FIFO of the interface.
+ */
+void uct_mm_iface_bcast_cleanup(uct_mm_iface_t *iface);
+
+
+/**
+ * Start reading the broadcast FIFO of a remote interface, if it has one.
+ */
+void uct_mm_iface_bcast_subscribe(uct_mm_iface_t *iface,
+                                  uct_mm_iface_peer_t *peer);
+
+
+/**
+ * Stop reading the broadcast FIFO of a remote interface.
+ */
+void uct_mm_iface_bcast_unsubscribe(uct_mm_iface_t *iface,
+                                    uct_mm_iface_peer_t *peer);
+
+
+/**
+ * Pass the new elements of the remote broadcast FIFOs to the user.
+ * @return Number of elements which were read.
+ */
+unsigned uct_mm_iface_bcast_progress(uct_mm_iface_t *iface);
+
+
+/**
+ * @return Whether one of the remote broadcast FIFOs has an element to read.
+ */
+int uct_mm_iface_bcast_has_data(uct_mm_iface_t *iface);
+
+
+ssize_t uct_mm_iface_am_bcast_bcopy(uct_iface_h tl_iface, uint8_t id,
+                                    uct_pack_callback_t pack_cb, void *arg,
+                                    unsigned flags);
+
+
 UCS_CLASS_DECLARE_NEW_FUNC(uct_mm_iface_t, uct_iface_t, uct_md_h, uct_worker_h,
                            const uct_iface_params_t*, const uct_iface_config_t*);
 
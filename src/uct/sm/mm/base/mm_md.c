@@ -11,7 +11,9 @@
 
 #include "mm_md.h"
 
+#include <ucs/arch/atomic.h>
 #include <ucs/debug/log.h>
+#include <ucs/sys/sys.h>
 #include <inttypes.h>
 #include <limits.h>
 
@@ -50,6 +52,11 @@ ucs_status_t uct_mm_query_md_resources(uct_component_t *component,
     }
 }
 
+/* Next unique segment id, starts from a random value so that segments of
+ * different processes do not have the same id */
+static uint64_t uct_mm_seg_next_uid;
+
+
 ucs_status_t uct_mm_seg_new(void *address, size_t length, uct_mm_seg_t **seg_p)
 {
     uct_mm_seg_t *seg;
@@ -63,6 +70,7 @@ ucs_status_t uct_mm_seg_new(void *address, size_t length, uct_mm_seg_t **seg_p)
     seg->address = address;
     seg->length  = length;
     seg->seg_id  = 0;
+    seg->uid     = ucs_atomic_fadd64(&uct_mm_seg_next_uid, 1);
     *seg_p       = seg;
     return UCS_OK;
 }
@@ -135,3 +143,7 @@ void uct_mm_md_close(uct_md_h md)
     ucs_free(mm_md->config);
     ucs_free(mm_md);
 }
+
+UCS_STATIC_INIT {
+    uct_mm_seg_next_uid = ucs_generate_uuid(0);
+}
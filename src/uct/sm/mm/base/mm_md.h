@@ -29,6 +29,8 @@ typedef struct uct_mm_seg {
     uct_mm_seg_id_t       seg_id;     /* Shared memory ID */
     void                  *address;   /* Virtual address */
     size_t                length;     /* Size of the memory */
+    uint64_t              uid;        /* Unique segment id, unlike seg_id it
+                                         is never reused by another segment */
 } uct_mm_seg_t;
 
 
@@ -17,8 +17,11 @@
 #include <ucs/sys/string.h>
 #include <ucs/profile/profile.h>
 #include <ucs/sys/sys.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/type/spinlock.h>
 #include <sys/mman.h>
 #include <sys/statvfs.h>
+#include <sys/syscall.h>
 #include <uct/api/v2/uct_v2.h>
 
 
@@ -35,26 +38,39 @@
 #define UCT_POSIX_SEG_FLAG_SHM_OPEN     UCS_BIT(62) /* use shm_open() rather than open() */
 #define UCT_POSIX_SEG_FLAG_HUGETLB      UCS_BIT(61) /* use MAP_HUGETLB */
 #define UCT_POSIX_SEG_FLAG_PID_NS       UCS_BIT(60) /* use PID NS in address */
+#define UCT_POSIX_SEG_FLAG_MEMFD        UCS_BIT(59) /* anonymous memfd segment, the
+                                                       mmid encodes pid+fd as in
+                                                       procfs mode */
 #define UCT_POSIX_SEG_FLAGS_MASK        (UCT_POSIX_SEG_FLAG_PROCFS | \
                                          UCT_POSIX_SEG_FLAG_SHM_OPEN | \
                                          UCT_POSIX_SEG_FLAG_PID_NS | \
-                                         UCT_POSIX_SEG_FLAG_HUGETLB)
+                                         UCT_POSIX_SEG_FLAG_HUGETLB | \
+                                         UCT_POSIX_SEG_FLAG_MEMFD)
 #define UCT_POSIX_SEG_MMID_MASK         (~UCT_POSIX_SEG_FLAGS_MASK)
 
 /* Packing mmid for procfs mode */
-#define UCT_POSIX_PROCFS_MMID_FD_BITS   30  /* how many bits for file descriptor */
+#define UCT_POSIX_PROCFS_MMID_FD_BITS   29  /* how many bits for file descriptor */
 #define UCT_POSIX_PROCFS_MMID_PID_BITS  30  /* how many bits for pid */
 
 /* Filesystem paths */
 #define UCT_POSIX_SHM_OPEN_DIR          "/dev/shm"       /* directory path for shm_open() */
 #define UCT_POSIX_FILE_FMT              "/ucx_shm_posix_%"PRIx64
 #define UCT_POSIX_PROCFS_FILE_FMT       "/proc/%d/fd/%d" /* file pattern for procfs mode */
+#define UCT_POSIX_MEMFD_NAME            "ucx_shm_posix"  /* memfd name, for debug only */
+
+/* Duplicating a peer's file descriptor with pidfd_getfd() */
+#if defined(SYS_pidfd_open) && defined(SYS_pidfd_getfd)
+#  define UCT_POSIX_HAVE_PIDFD          1
+#else
+#  define UCT_POSIX_HAVE_PIDFD          0
+#endif
 
 
 typedef struct uct_posix_md_config {
     uct_mm_md_config_t super;
     char               *dir;
     int                use_proc_link;
+    int                use_memfd;
     size_t             shm_min_size;
 } uct_posix_md_config_t;
 
@@ -65,6 +81,14 @@ typedef struct uct_posix_packed_rkey {
 } UCS_S_PACKED uct_posix_packed_rkey_t;
 
 
+KHASH_MAP_INIT_INT(uct_posix_pidfd, int)
+
+/* Cache of pidfds of peer processes, used to duplicate their memfd segment
+ * file descriptors. Shared by all memory domains and remote keys. */
+static khash_t(uct_posix_pidfd) uct_posix_pidfd_hash = KHASH_STATIC_INITIALIZER;
+static ucs_spinlock_t           uct_posix_pidfd_lock;
+
+
 static ucs_config_field_t uct_posix_md_config_table[] = {
     {"MM_", "", NULL, ucs_offsetof(uct_posix_md_config_t, super),
      UCS_CONFIG_TYPE_TABLE(uct_mm_md_config_table)},
@@ -88,6 +112,13 @@ static ucs_config_field_t uct_posix_md_config_table[] = {
      " n   - Use original file path to share posix file.\n",
      ucs_offsetof(uct_posix_md_config_t, use_proc_link), UCS_CONFIG_TYPE_BOOL},
 
+    {"USE_MEMFD", "n",
+     "Allocate shared memory segments with memfd_create(), so they are not\n"
+     "linked to any file system and cannot be leaked if the process crashes.\n"
+     "Peers obtain the file descriptor with pidfd_getfd() when possible, and\n"
+     "fall back to /proc/<pid>/fd/<fd> otherwise. DIR is ignored in this mode.",
+     ucs_offsetof(uct_posix_md_config_t, use_memfd), UCS_CONFIG_TYPE_BOOL},
+
     {NULL}
 };
 
@@ -102,6 +133,11 @@ static int uct_posix_use_shm_open(const uct_posix_md_config_t *posix_config)
     return !strcmp(posix_config->dir, UCT_POSIX_SHM_OPEN_DIR);
 }
 
+static int uct_posix_use_fd_link(const uct_posix_md_config_t *posix_config)
+{
+    return posix_config->use_proc_link || posix_config->use_memfd;
+}
+
 static ucs_status_t uct_posix_query(int *attach_shm_file_p)
 {
     *attach_shm_file_p = 1;
@@ -118,7 +154,7 @@ static size_t uct_posix_iface_addr_length(uct_mm_md_t *md)
      * requested backing file is needed so that the user would know how much
      * space to allocate for the rkey.
      */
-    if (posix_config->use_proc_link) {
+    if (uct_posix_use_fd_link(posix_config)) {
         return ucs_sys_ns_is_default(UCS_SYS_NS_TYPE_PID) ? 0 : sizeof(ucs_sys_ns_t);
     }
 
@@ -294,6 +330,61 @@ out:
     return status;
 }
 
+static ucs_status_t uct_posix_pidfd_getfd(int pid, int peer_fd, int *fd_p)
+{
+#if UCT_POSIX_HAVE_PIDFD
+    ucs_status_t status = UCS_ERR_UNSUPPORTED;
+    khiter_t iter;
+    int pidfd, ret, retry;
+
+    /* Keep the lock while using the cached pidfd, so it would not be closed
+     * by another thread which detected that the process has exited */
+    ucs_spin_lock(&uct_posix_pidfd_lock);
+
+    for (retry = 0; retry < 2; ++retry) {
+        iter = kh_get(uct_posix_pidfd, &uct_posix_pidfd_hash, pid);
+        if (iter == kh_end(&uct_posix_pidfd_hash)) {
+            pidfd = syscall(SYS_pidfd_open, pid, 0);
+            if (pidfd < 0) {
+                ucs_debug("pidfd_open(pid=%d) failed: %m", pid);
+                break;
+            }
+
+            iter = kh_put(uct_posix_pidfd, &uct_posix_pidfd_hash, pid, &ret);
+            if (ret == UCS_KH_PUT_FAILED) {
+                close(pidfd);
+                break;
+            }
+
+            kh_value(&uct_posix_pidfd_hash, iter) = pidfd;
+        }
+
+        ret = syscall(SYS_pidfd_getfd, kh_value(&uct_posix_pidfd_hash, iter),
+                      peer_fd, 0);
+        if (ret >= 0) {
+            *fd_p  = ret;
+            status = UCS_OK;
+            break;
+        }
+
+        ucs_debug("pidfd_getfd(pid=%d fd=%d) failed: %m", pid, peer_fd);
+        if (errno != ESRCH) {
+            break;
+        }
+
+        /* The cached pidfd refers to a process which has exited, and the pid
+         * could have been reused by a new process; open it again */
+        close(kh_value(&uct_posix_pidfd_hash, iter));
+        kh_del(uct_posix_pidfd, &uct_posix_pidfd_hash, iter);
+    }
+
+    ucs_spin_unlock(&uct_posix_pidfd_lock);
+    return status;
+#else
+    return UCS_ERR_UNSUPPORTED;
+#endif
+}
+
 static ucs_status_t
 uct_posix_unlink(uct_mm_md_t *md, uint64_t seg_id, ucs_log_level_t err_level)
 {
@@ -412,7 +503,13 @@ uct_posix_mem_open(uct_mm_seg_id_t seg_id, const char *dir, int *fd_p)
 
     if (seg_id & UCT_POSIX_SEG_FLAG_PROCFS) {
         uct_posix_mmid_procfs_unpack(mmid, &pid, &peer_fd);
-        status = uct_posix_procfs_open(pid, peer_fd, fd_p);
+        if ((seg_id & UCT_POSIX_SEG_FLAG_MEMFD) &&
+            (uct_posix_pidfd_getfd(pid, peer_fd, fd_p) == UCS_OK)) {
+            /* Avoid path lookup and procfs permission checks */
+            status = UCS_OK;
+        } else {
+            status = uct_posix_procfs_open(pid, peer_fd, fd_p);
+        }
     } else if (seg_id & UCT_POSIX_SEG_FLAG_SHM_OPEN) {
         status = uct_posix_shm_open(mmid, 0, fd_p);
     } else {
@@ -513,6 +610,104 @@ uct_posix_segment_open(uct_mm_md_t *md, uct_mm_seg_id_t *seg_id_p, int *fd_p)
     }
 }
 
+#ifdef MFD_CLOEXEC
+static ucs_status_t
+uct_posix_memfd_map(uct_mm_seg_t *seg, unsigned memfd_flags, int mmap_flags,
+                    const char *alloc_name, ucs_log_level_t err_level,
+                    int *fd_p)
+{
+    ucs_status_t status;
+    int fd;
+
+    fd = memfd_create(UCT_POSIX_MEMFD_NAME, MFD_CLOEXEC | memfd_flags);
+    if (fd < 0) {
+        ucs_log(err_level, "memfd_create(flags=0x%x) failed: %m", memfd_flags);
+        return UCS_ERR_SHMEM_SEGMENT;
+    }
+
+    /* Map before setting the file size, since the aligned length is known
+     * only after mmap(). Huge page memfd mapping also reserves the pages, so
+     * a shortage of huge pages is detected here rather than on first access */
+    status = uct_posix_mmap(&seg->address, &seg->length, mmap_flags, fd,
+                            alloc_name, err_level);
+    if (status != UCS_OK) {
+        goto err_close;
+    }
+
+    if (ftruncate(fd, seg->length) < 0) {
+        ucs_log(err_level, "ftruncate(fd=%d, length=%zu) failed: %m", fd,
+                seg->length);
+        status = UCS_ERR_SHMEM_SEGMENT;
+        goto err_munmap;
+    }
+
+    *fd_p = fd;
+    return UCS_OK;
+
+err_munmap:
+    uct_posix_munmap(seg->address, seg->length);
+err_close:
+    close(fd);
+    return status;
+}
+#endif
+
+static ucs_status_t
+uct_posix_memfd_alloc(const uct_posix_md_config_t *posix_config,
+                      uct_mm_seg_t *seg, int mmap_flags, const char *alloc_name,
+                      int *fd_p)
+{
+#ifdef MFD_CLOEXEC
+    uint64_t seg_flags = UCT_POSIX_SEG_FLAG_PROCFS | UCT_POSIX_SEG_FLAG_MEMFD;
+    void *address      = seg->address;
+    size_t length      = seg->length;
+    ucs_status_t status;
+    int force_hugetlb;
+
+    if (posix_config->super.hugetlb_mode != UCS_NO) {
+        force_hugetlb = (posix_config->super.hugetlb_mode == UCS_YES);
+#if defined(MFD_HUGETLB) && defined(MAP_HUGETLB)
+        status = uct_posix_memfd_map(seg, MFD_HUGETLB, mmap_flags | MAP_HUGETLB,
+                                     alloc_name,
+                                     force_hugetlb ? UCS_LOG_LEVEL_ERROR :
+                                                     UCS_LOG_LEVEL_DEBUG,
+                                     fd_p);
+#else
+        status = UCS_ERR_SHMEM_SEGMENT;
+        if (force_hugetlb) {
+            ucs_error("shared memory allocation failed: "
+                      "MFD_HUGETLB is not supported on the system");
+        }
+#endif
+        if ((status != UCS_OK) && force_hugetlb) {
+            return status;
+        } else if (status == UCS_OK) {
+            seg_flags |= UCT_POSIX_SEG_FLAG_HUGETLB;
+            goto out;
+        }
+
+        seg->address = address;
+        seg->length  = length;
+    }
+
+    status = uct_posix_memfd_map(seg, 0, mmap_flags, alloc_name,
+                                 UCS_LOG_LEVEL_ERROR, fd_p);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+out:
+    seg->seg_id = uct_posix_mmid_procfs_pack(*fd_p) | seg_flags |
+                  (ucs_sys_ns_is_default(UCS_SYS_NS_TYPE_PID) ? 0 :
+                   UCT_POSIX_SEG_FLAG_PID_NS);
+    return UCS_OK;
+#else
+    ucs_error("shared memory allocation failed: "
+              "memfd_create() is not supported on the system");
+    return UCS_ERR_UNSUPPORTED;
+#endif
+}
+
 static ucs_status_t
 uct_posix_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
                     ucs_memory_type_t mem_type, unsigned flags,
@@ -537,6 +732,24 @@ uct_posix_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
         goto err;
     }
 
+    /* mmap the shared memory segment that was created by shm_open */
+    if (flags & UCT_MD_MEM_FLAG_FIXED) {
+        mmap_flags   = MAP_FIXED;
+    } else {
+        seg->address = NULL;
+        mmap_flags   = 0;
+    }
+
+    if (posix_config->use_memfd) {
+        status = uct_posix_memfd_alloc(posix_config, seg, mmap_flags,
+                                       alloc_name, &fd);
+        if (status != UCS_OK) {
+            goto err_free_seg;
+        }
+
+        goto out;
+    }
+
     status = uct_posix_segment_open(md, &seg->seg_id, &fd);
     if (status != UCS_OK) {
         goto err_free_seg;
@@ -562,14 +775,6 @@ uct_posix_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
                        UCT_POSIX_SEG_FLAG_PID_NS);
     }
 
-    /* mmap the shared memory segment that was created by shm_open */
-    if (flags & UCT_MD_MEM_FLAG_FIXED) {
-        mmap_flags   = MAP_FIXED;
-    } else {
-        seg->address = NULL;
-        mmap_flags   = 0;
-    }
-
     /* try HUGETLB mmap */
     address = MAP_FAILED;
     if (posix_config->super.hugetlb_mode != UCS_NO) {
@@ -603,11 +808,12 @@ uct_posix_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
         }
     }
 
+out:
     /* create new memory segment */
     ucs_debug("allocated posix shared memory at %p length %zu", seg->address,
               seg->length);
 
-    if (!posix_config->use_proc_link) {
+    if (!(seg->seg_id & UCT_POSIX_SEG_FLAG_PROCFS)) {
         /* closing the file here since the peers will open it by file system path */
         close(fd);
     }
@@ -669,7 +875,7 @@ static ucs_status_t uct_posix_iface_addr_pack(uct_mm_md_t *md, void *buffer)
     const uct_posix_md_config_t *posix_config =
                      ucs_derived_of(md->config, uct_posix_md_config_t);
 
-    if (posix_config->use_proc_link) {
+    if (uct_posix_use_fd_link(posix_config)) {
         if (!ucs_sys_ns_is_default(UCS_SYS_NS_TYPE_PID)) {
             *(ucs_sys_ns_t*)buffer = ucs_sys_get_ns(UCS_SYS_NS_TYPE_PID);
         }
@@ -783,5 +989,23 @@ UCT_MM_TL_DEFINE(posix, &uct_posix_md_ops, uct_posix_rkey_unpack,
                  uct_posix_rkey_release, "POSIX_",
                  uct_posix_iface_config_table);
 
-UCT_SINGLE_TL_INIT(&uct_posix_component.super, posix,,,)
+static void uct_posix_global_init()
+{
+    ucs_spinlock_init(&uct_posix_pidfd_lock, 0);
+}
+
+static void uct_posix_global_cleanup()
+{
+    int pidfd;
+
+    kh_foreach_value(&uct_posix_pidfd_hash, pidfd, {
+        close(pidfd);
+    })
+    kh_destroy_inplace(uct_posix_pidfd, &uct_posix_pidfd_hash);
+
+    ucs_spinlock_destroy(&uct_posix_pidfd_lock);
+}
+
+UCT_SINGLE_TL_INIT(&uct_posix_component.super, posix,,
+                   uct_posix_global_init(), uct_posix_global_cleanup())
 
@@ -11,6 +11,11 @@
 #include "scopy_ep.h"
 
 #include <uct/base/uct_iov.inl>
+#include <ucs/arch/atomic.h>
+#include <ucs/sys/ptr_arith.h>
+#include <ucs/time/time.h>
+
+#include <sched.h>
 
 
 const char* uct_scopy_tx_op_str[] = {
@@ -25,12 +30,18 @@ UCS_CLASS_INIT_FUNC(uct_scopy_ep_t, const uct_ep_params_t *params)
     UCS_CLASS_CALL_SUPER_INIT(uct_base_ep_t, &iface->super.super);
 
     ucs_arbiter_group_init(&self->arb_group);
+    self->mt_chunks = 0;
 
     return UCS_OK;
 }
 
 static UCS_CLASS_CLEANUP_FUNC(uct_scopy_ep_t)
 {
+    /* the copy threads may still be using the endpoint */
+    while (self->mt_chunks != 0) {
+        sched_yield();
+    }
+
     ucs_arbiter_group_cleanup(&self->arb_group);
 }
 
@@ -40,8 +51,11 @@ static UCS_F_ALWAYS_INLINE void
 uct_scopy_ep_tx_init_common(uct_scopy_tx_t *tx, uct_scopy_tx_op_t tx_op,
                             uct_completion_t *comp)
 {
-    tx->comp = comp;
-    tx->op   = tx_op;
+    tx->comp       = comp;
+    tx->op         = tx_op;
+    tx->mt.chunks  = NULL;
+    tx->mt.pending = 0;
+    tx->mt.failed  = 0;
     ucs_arbiter_elem_init(&tx->arb_elem);
 }
 
@@ -124,6 +138,200 @@ ucs_status_t uct_scopy_ep_get_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
                                 rkey, comp, UCT_SCOPY_TX_GET_ZCOPY);
 }
 
+static void uct_scopy_ep_iov_iter_advance(const uct_iov_t *iov,
+                                          ucs_iov_iter_t *iov_iter,
+                                          size_t length)
+{
+    size_t iov_length;
+
+    while (length > 0) {
+        iov_length = uct_iov_get_length(&iov[iov_iter->iov_index]) -
+                     iov_iter->buffer_offset;
+        if (length < iov_length) {
+            iov_iter->buffer_offset += length;
+            return;
+        }
+
+        length -= iov_length;
+        ++iov_iter->iov_index;
+        iov_iter->buffer_offset = 0;
+    }
+}
+
+ucs_status_t uct_scopy_ep_tx_chunk(uct_scopy_tx_chunk_t *chunk,
+                                   uct_scopy_ep_tx_func_t tx_func)
+{
+    uct_scopy_tx_t *tx      = chunk->tx;
+    ucs_iov_iter_t iov_iter = chunk->iov_iter;
+    uint64_t remote_addr    = chunk->remote_addr;
+    size_t remaining        = chunk->length;
+    ucs_status_t status;
+    size_t length;
+
+    /* a single call is limited by the number of IOVs it converts */
+    while (remaining > 0) {
+        length = remaining;
+        status = tx_func(chunk->tl_ep, tx->iov, tx->iov_cnt, &iov_iter,
+                         &length, remote_addr, tx->rkey, tx->op);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        ucs_assert(length <= remaining);
+        remaining   -= length;
+        remote_addr += length;
+    }
+
+    return UCS_OK;
+}
+
+/* Split the operation between the copy threads. Return 0 if it should be
+ * copied by the progress thread instead. */
+static int uct_scopy_ep_tx_mt_start(uct_scopy_iface_t *iface,
+                                    uct_scopy_ep_t *ep, uct_scopy_tx_t *tx)
+{
+    size_t total_length = uct_iov_total_length(tx->iov, tx->iov_cnt);
+    ucs_iov_iter_t iov_iter;
+    uct_scopy_tx_chunk_t *chunk;
+    size_t chunk_length;
+    size_t offset;
+    unsigned num_chunks;
+
+    if ((iface->mt.num_threads == 0) || tx->mt.failed ||
+        (total_length < iface->mt.thresh) ||
+        (tx->iov_iter.iov_index != 0) || (tx->iov_iter.buffer_offset != 0)) {
+        return 0;
+    }
+
+    tx->mt.chunks = ucs_malloc(iface->mt.num_threads * sizeof(*tx->mt.chunks),
+                               "scopy_tx_chunks");
+    if (tx->mt.chunks == NULL) {
+        return 0;
+    }
+
+    chunk_length = ucs_align_up(ucs_div_round_up(total_length,
+                                                 iface->mt.num_threads),
+                                UCS_SYS_CACHE_LINE_SIZE);
+    ucs_iov_iter_init(&iov_iter);
+    for (offset = 0, num_chunks = 0; offset < total_length;
+         offset += chunk->length, ++num_chunks) {
+        chunk              = &tx->mt.chunks[num_chunks];
+        chunk->tl_ep       = &ep->super.super;
+        chunk->tx          = tx;
+        chunk->iov_iter    = iov_iter;
+        chunk->length      = ucs_min(chunk_length, total_length - offset);
+        chunk->remote_addr = tx->remote_addr + offset;
+        uct_scopy_ep_iov_iter_advance(tx->iov, &iov_iter, chunk->length);
+    }
+
+    tx->mt.pending = num_chunks;
+    ucs_atomic_add32(&ep->mt_chunks, num_chunks);
+    uct_scopy_iface_mt_submit(iface, tx->mt.chunks, num_chunks);
+    return 1;
+}
+
+/* Check whether the copy threads completed the operation, and if they failed,
+ * restart it on the progress thread, which handles the error */
+static ucs_status_t uct_scopy_ep_tx_mt_check(uct_scopy_tx_t *tx)
+{
+    if (tx->mt.pending != 0) {
+        return UCS_INPROGRESS;
+    }
+
+    ucs_memory_cpu_load_fence();
+    ucs_free(tx->mt.chunks);
+    tx->mt.chunks = NULL;
+
+    if (ucs_unlikely(tx->mt.failed)) {
+        ucs_debug("tx %p: copy threads failed, retrying on progress thread",
+                  tx);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    tx->remote_addr       += uct_iov_total_length(tx->iov, tx->iov_cnt);
+    tx->iov_iter.iov_index = tx->iov_cnt;
+    return UCS_OK;
+}
+
+static UCS_F_ALWAYS_INLINE int
+uct_scopy_ep_tx_is_done(const uct_scopy_tx_t *tx)
+{
+    return tx->iov_iter.iov_index == tx->iov_cnt;
+}
+
+/* Copy the operation together with the following operations of the same type
+ * which were posted on the endpoint, and mark all of them as done. Return 0 if
+ * it should be copied by itself. */
+static int uct_scopy_ep_tx_batch(uct_scopy_iface_t *iface, uct_scopy_ep_t *ep,
+                                 ucs_arbiter_group_t *group,
+                                 ucs_arbiter_elem_t *elem, uct_scopy_tx_t *tx)
+{
+    uct_scopy_tx_t *txs[UCT_SCOPY_TX_BATCH_MAX];
+    size_t lengths[UCT_SCOPY_TX_BATCH_MAX];
+    ucs_arbiter_elem_t *tail, *next;
+    size_t total_length, total_iov_cnt;
+    uct_scopy_tx_t *next_tx;
+    ucs_status_t status;
+    unsigned count, i;
+
+    if ((iface->tx_batch == NULL) || (iface->config.tx_batch <= 1) ||
+        ucs_arbiter_elem_is_only(elem) || (tx->iov_iter.iov_index != 0) ||
+        (tx->iov_iter.buffer_offset != 0)) {
+        return 0;
+    }
+
+    lengths[0] = uct_iov_total_length(tx->iov, tx->iov_cnt);
+    if (lengths[0] > iface->config.seg_size) {
+        return 0;
+    }
+
+    /* The current element was replaced by a placeholder as the group head, but
+     * still points to the next one. Only the head of a group is dispatched, so
+     * the following operations were not started. */
+    txs[0]        = tx;
+    count         = 1;
+    total_length  = lengths[0];
+    total_iov_cnt = tx->iov_cnt;
+    tail          = ucs_arbiter_group_tail(group);
+    next          = elem;
+    do {
+        next    = next->next;
+        next_tx = ucs_container_of(next, uct_scopy_tx_t, arb_elem);
+        if (next_tx->op != tx->op) {
+            break;
+        }
+
+        lengths[count] = uct_iov_total_length(next_tx->iov, next_tx->iov_cnt);
+        if (((total_length + lengths[count]) > iface->config.seg_size) ||
+            ((total_iov_cnt + next_tx->iov_cnt) >
+             iface->config.tx_batch_max_iov)) {
+            break;
+        }
+
+        total_length  += lengths[count];
+        total_iov_cnt += next_tx->iov_cnt;
+        txs[count++]   = next_tx;
+    } while ((next != tail) && (count < iface->config.tx_batch));
+
+    if (count == 1) {
+        return 0;
+    }
+
+    status = iface->tx_batch(&ep->super.super, txs, count);
+    if (status != UCS_OK) {
+        return 0;
+    }
+
+    for (i = 0; i < count; ++i) {
+        txs[i]->remote_addr            += lengths[i];
+        txs[i]->iov_iter.iov_index      = txs[i]->iov_cnt;
+        txs[i]->iov_iter.buffer_offset  = 0;
+        uct_scopy_trace_data(txs[i]);
+    }
+
+    return 1;
+}
+
 ucs_arbiter_cb_result_t uct_scopy_ep_progress_tx(ucs_arbiter_t *arbiter,
                                                  ucs_arbiter_group_t *group,
                                                  ucs_arbiter_elem_t *elem,
@@ -137,8 +345,25 @@ ucs_arbiter_cb_result_t uct_scopy_ep_progress_tx(ucs_arbiter_t *arbiter,
                                                 arb_elem);
     unsigned *count          = (unsigned*)arg;
     ucs_status_t status      = UCS_OK;
+    ucs_time_t start_time    = 0;
     size_t seg_size;
 
+    if (tx->mt.chunks != NULL) {
+        status = uct_scopy_ep_tx_mt_check(tx);
+        if (status == UCS_INPROGRESS) {
+            return UCS_ARBITER_CB_RESULT_RESCHED_GROUP;
+        } else if (status == UCS_OK) {
+            uct_scopy_trace_data(tx);
+            goto complete;
+        }
+
+        status = UCS_OK;
+    } else if ((tx->op != UCT_SCOPY_TX_FLUSH_COMP) &&
+               uct_scopy_ep_tx_is_done(tx)) {
+        /* copied together with a preceding operation */
+        goto complete;
+    }
+
     if (*count == iface->config.tx_quota) {
         return UCS_ARBITER_CB_RESULT_STOP;
     }
@@ -146,6 +371,20 @@ ucs_arbiter_cb_result_t uct_scopy_ep_progress_tx(ucs_arbiter_t *arbiter,
     if (tx->op != UCT_SCOPY_TX_FLUSH_COMP) {
         ucs_assert((tx->op == UCT_SCOPY_TX_GET_ZCOPY) ||
                    (tx->op == UCT_SCOPY_TX_PUT_ZCOPY));
+        if (uct_scopy_ep_tx_mt_start(iface, ep, tx)) {
+            (*count)++;
+            return UCS_ARBITER_CB_RESULT_RESCHED_GROUP;
+        }
+
+        if (uct_scopy_ep_tx_batch(iface, ep, group, elem, tx)) {
+            (*count)++;
+            goto complete;
+        }
+
+        if (iface->autotune.enable) {
+            start_time = ucs_get_time();
+        }
+
         seg_size = iface->config.seg_size;
         status   = iface->tx(&ep->super.super, tx->iov, tx->iov_cnt,
                              &tx->iov_iter, &seg_size, tx->remote_addr,
@@ -156,6 +395,13 @@ ucs_arbiter_cb_result_t uct_scopy_ep_progress_tx(ucs_arbiter_t *arbiter,
                         "count=%u vs quota=%u",
                         *count, iface->config.tx_quota);
 
+            /* shorter segments do not depend on the segment size */
+            if (iface->autotune.enable &&
+                (seg_size == iface->config.seg_size)) {
+                uct_scopy_iface_autotune_seg(iface, seg_size,
+                                             ucs_get_time() - start_time);
+            }
+
             tx->remote_addr += seg_size;
             uct_scopy_trace_data(tx);
 
@@ -165,6 +411,7 @@ ucs_arbiter_cb_result_t uct_scopy_ep_progress_tx(ucs_arbiter_t *arbiter,
         }
     }
 
+complete:
     ucs_assert((tx->comp != NULL) ||
                (tx->op != UCT_SCOPY_TX_FLUSH_COMP));
     if (tx->comp != NULL) {
@@ -11,6 +11,10 @@
 #include <ucs/sys/iovec.h>
 
 
+/* Maximal number of operations which are copied by a single call */
+#define UCT_SCOPY_TX_BATCH_MAX 64
+
+
 extern const char* uct_scopy_tx_op_str[];
 
 
@@ -45,21 +49,61 @@ typedef ucs_status_t
                           uct_scopy_tx_op_t tx_op);
 
 
-typedef struct uct_scopy_tx {
+typedef struct uct_scopy_tx uct_scopy_tx_t;
+
+
+/**
+ * Executor of multiple TX operations to the same endpoint
+ *
+ * @param [in]     tl_ep             Transport EP.
+ * @param [in]     txs               Operations to copy, all of them are of the
+ *                                   same type and were not started.
+ * @param [in]     count             Number of operations in @a txs.
+ *
+ * @return UCS_OK if all the operations were completely copied, otherwise -
+ *         error status, and the operations should be copied one by one.
+ */
+typedef ucs_status_t
+(*uct_scopy_ep_tx_batch_func_t)(uct_ep_h tl_ep, uct_scopy_tx_t *const *txs,
+                                unsigned count);
+
+
+/**
+ * Part of a TX operation which is copied by a copy thread
+ */
+typedef struct uct_scopy_tx_chunk {
+    ucs_queue_elem_t                queue;              /* Entry in the copy threads queue */
+    uct_ep_h                        tl_ep;              /* Transport EP */
+    uct_scopy_tx_t                  *tx;                /* TX operation */
+    ucs_iov_iter_t                  iov_iter;           /* First IOV position of the chunk */
+    size_t                          length;             /* Length of the chunk */
+    uint64_t                        remote_addr;        /* Remote address of the chunk */
+} uct_scopy_tx_chunk_t;
+
+
+struct uct_scopy_tx {
     ucs_arbiter_elem_t              arb_elem;           /* TX arbiter group element */
     uct_scopy_tx_op_t               op;                 /* TX operation identifier */
     uint64_t                        remote_addr;        /* The remote address */
     uct_rkey_t                      rkey;               /* User-passed UCT rkey */
     uct_completion_t                *comp;              /* The pointer to the user's passed completion */
     ucs_iov_iter_t                  iov_iter;           /* UCT IOVs iterator */
+    struct {
+        uct_scopy_tx_chunk_t        *chunks;            /* Chunks copied by the copy threads,
+                                                         * NULL if not started */
+        volatile uint32_t           pending;            /* Number of chunks in progress */
+        volatile int                failed;             /* Whether copying a chunk failed */
+    } mt;
     size_t                          iov_cnt;            /* The number of the UCT IOVs */
     uct_iov_t                       iov[];              /* UCT IOVs */
-} uct_scopy_tx_t;
+};
 
 
 typedef struct uct_scopy_ep {
     uct_base_ep_t                   super;
     ucs_arbiter_group_t             arb_group;          /* TX arbiter group */
+    volatile uint32_t               mt_chunks;          /* Number of chunks which the copy
+                                                         * threads did not complete */
 } uct_scopy_ep_t;
 
 
@@ -81,4 +125,7 @@ ucs_arbiter_cb_result_t uct_scopy_ep_progress_tx(ucs_arbiter_t *arbiter,
 ucs_status_t uct_scopy_ep_flush(uct_ep_h tl_ep, unsigned flags,
                                 uct_completion_t *comp);
 
+ucs_status_t uct_scopy_ep_tx_chunk(uct_scopy_tx_chunk_t *chunk,
+                                   uct_scopy_ep_tx_func_t tx_func);
+
 #endif
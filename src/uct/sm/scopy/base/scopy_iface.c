@@ -10,8 +10,13 @@
 #include "scopy_iface.h"
 #include "scopy_ep.h"
 
+#include <ucs/arch/atomic.h>
 #include <ucs/arch/cpu.h>
 #include <ucs/sys/string.h>
+#include <ucs/sys/sys.h>
+#include <ucs/time/time.h>
+#include <ucs/vfs/base/vfs_cb.h>
+#include <ucs/vfs/base/vfs_obj.h>
 
 #include <uct/sm/base/sm_iface.h>
 
@@ -23,6 +28,18 @@
 /* Overhead value used for estimate_perf */
 #define UCT_SCOPY_IFACE_OVERHEAD 500e-9
 
+/* The segment size is adjusted by hill climbing: after every measurement of
+ * AUTOTUNE_SAMPLES full segments, the segment size is multiplied or divided by
+ * AUTOTUNE_SEG_FACTOR, and the direction is reversed when the measured
+ * bandwidth is lower than with the previous segment size. The TX quota is
+ * adjusted by the same AIMD algorithm as the MM FIFO polling window, and is
+ * limited so that a progress call copies at most SEG_SIZE * TX_QUOTA bytes of
+ * the initial configuration. */
+#define UCT_SCOPY_IFACE_AUTOTUNE_SAMPLES    16
+#define UCT_SCOPY_IFACE_AUTOTUNE_SEG_FACTOR 2
+#define UCT_SCOPY_IFACE_AUTOTUNE_AI_VALUE   1
+#define UCT_SCOPY_IFACE_AUTOTUNE_MD_FACTOR  2
+
 
 ucs_config_field_t uct_scopy_iface_config_table[] = {
     {"SM_", "", NULL,
@@ -48,9 +65,49 @@ ucs_config_field_t uct_scopy_iface_config_table[] = {
      "How many TX segments can be dispatched during iface progress",
      ucs_offsetof(uct_scopy_iface_config_t, tx_quota), UCS_CONFIG_TYPE_UINT},
 
+    {"TX_BATCH", "16",
+     "Maximal number of consecutive GET/PUT Zcopy operations on an endpoint which\n"
+     "are copied together by a single call, if supported by the transport. Their\n"
+     "total size is limited by SEG_SIZE. 1 disables merging the operations.",
+     ucs_offsetof(uct_scopy_iface_config_t, tx_batch), UCS_CONFIG_TYPE_UINT},
+
+    {"AUTOTUNE", "n",
+     "Adjust the segment size and the TX quota at runtime according to the\n"
+     "measured copy bandwidth and the amount of pending operations. SEG_SIZE and\n"
+     "TX_QUOTA are used as the initial values, and TX_QUOTA is also the minimal\n"
+     "quota.",
+     ucs_offsetof(uct_scopy_iface_config_t, autotune.enable), UCS_CONFIG_TYPE_BOOL},
+
+    {"AUTOTUNE_SEG_SIZE_MIN", "64k",
+     "Minimal segment size when AUTOTUNE is enabled",
+     ucs_offsetof(uct_scopy_iface_config_t, autotune.seg_size_min),
+     UCS_CONFIG_TYPE_MEMUNITS},
+
+    {"AUTOTUNE_SEG_SIZE_MAX", "4m",
+     "Maximal segment size when AUTOTUNE is enabled",
+     ucs_offsetof(uct_scopy_iface_config_t, autotune.seg_size_max),
+     UCS_CONFIG_TYPE_MEMUNITS},
+
     UCT_IFACE_MPOOL_CONFIG_FIELDS("TX_", -1, 8, 128m, 1.0, "send",
                                   ucs_offsetof(uct_scopy_iface_config_t, tx_mpool), ""),
 
+    {"MT_THREADS", "0",
+     "Number of helper threads which copy large GET/PUT Zcopy operations in\n"
+     "parallel, if supported by the transport. 0 disables the helper threads, and\n"
+     "the data is copied by the progress thread.",
+     ucs_offsetof(uct_scopy_iface_config_t, mt.num_threads), UCS_CONFIG_TYPE_UINT},
+
+    {"MT_THRESH", "8m",
+     "Minimal length of a GET/PUT Zcopy operation which is split between the\n"
+     "helper threads.",
+     ucs_offsetof(uct_scopy_iface_config_t, mt.thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
+    {"MT_CPUS", "",
+     "Comma-separated list of CPUs to bind the helper threads to, each thread is\n"
+     "bound to the next CPU in the list. If empty, the threads inherit the\n"
+     "affinity of the thread which creates the interface.",
+     ucs_offsetof(uct_scopy_iface_config_t, mt.cpus), UCS_CONFIG_TYPE_STRING_ARRAY},
+
     {NULL}
 };
 
@@ -116,6 +173,241 @@ uct_scopy_iface_estimate_perf(uct_iface_h iface, uct_perf_attr_t *perf_attr)
     return UCS_OK;
 }
 
+static void uct_scopy_iface_autotune_reset(uct_scopy_iface_t *iface)
+{
+    iface->autotune.time  = 0;
+    iface->autotune.bytes = 0;
+    iface->autotune.count = 0;
+}
+
+static unsigned uct_scopy_iface_autotune_max_quota(uct_scopy_iface_t *iface)
+{
+    return ucs_max(iface->autotune.quota_bytes / iface->config.seg_size,
+                   iface->autotune.tx_quota_min);
+}
+
+static void uct_scopy_iface_autotune_init(uct_scopy_iface_t *iface,
+                                          const uct_scopy_iface_config_t *config)
+{
+    iface->autotune.enable        = config->autotune.enable;
+    iface->autotune.seg_size_min  = ucs_max(config->autotune.seg_size_min, 1);
+    iface->autotune.seg_size_max  = ucs_max(config->autotune.seg_size_max,
+                                            iface->autotune.seg_size_min);
+    iface->autotune.tx_quota_min  = ucs_max(iface->config.tx_quota, 1);
+    iface->autotune.quota_bytes   = 0;
+    iface->autotune.prev_bw       = 0;
+    iface->autotune.grow          = 1;
+    iface->autotune.prev_wnd_cons = 0;
+    uct_scopy_iface_autotune_reset(iface);
+
+    if (!iface->autotune.enable) {
+        return;
+    }
+
+    iface->config.seg_size      = ucs_max(ucs_min(iface->config.seg_size,
+                                                  iface->autotune.seg_size_max),
+                                          iface->autotune.seg_size_min);
+    iface->autotune.quota_bytes = iface->config.seg_size *
+                                  iface->autotune.tx_quota_min;
+}
+
+void uct_scopy_iface_autotune_seg(uct_scopy_iface_t *iface, size_t length,
+                                  ucs_time_t time)
+{
+    size_t seg_size = iface->config.seg_size;
+    double bw;
+
+    ucs_assert(iface->autotune.enable);
+
+    iface->autotune.time  += time;
+    iface->autotune.bytes += length;
+    if ((++iface->autotune.count < UCT_SCOPY_IFACE_AUTOTUNE_SAMPLES) ||
+        (iface->autotune.time == 0)) {
+        return;
+    }
+
+    bw = iface->autotune.bytes / (double)iface->autotune.time;
+    if (bw < iface->autotune.prev_bw) {
+        iface->autotune.grow = !iface->autotune.grow;
+    }
+
+    iface->autotune.prev_bw = bw;
+    uct_scopy_iface_autotune_reset(iface);
+
+    if (iface->autotune.grow) {
+        seg_size = ucs_min(seg_size * UCT_SCOPY_IFACE_AUTOTUNE_SEG_FACTOR,
+                           iface->autotune.seg_size_max);
+    } else {
+        seg_size = ucs_max(seg_size / UCT_SCOPY_IFACE_AUTOTUNE_SEG_FACTOR,
+                           iface->autotune.seg_size_min);
+    }
+
+    if (seg_size == iface->config.seg_size) {
+        /* reached the bound, go back next time */
+        iface->autotune.grow = !iface->autotune.grow;
+        return;
+    }
+
+    ucs_trace("scopy iface %p: segment size %zu -> %zu, bandwidth %.2f MB/s",
+              iface, iface->config.seg_size, seg_size,
+              bw * ucs_time_sec_value() / UCS_MBYTE);
+    /* the TX quota is updated after the arbiter dispatch */
+    iface->config.seg_size = seg_size;
+}
+
+static void *uct_scopy_iface_mt_thread_func(void *arg)
+{
+    uct_scopy_iface_t *iface = arg;
+    uct_scopy_tx_chunk_t *chunk;
+    ucs_status_t status;
+    uct_scopy_tx_t *tx;
+    uct_scopy_ep_t *ep;
+
+    pthread_mutex_lock(&iface->mt.lock);
+    for (;;) {
+        while (ucs_queue_is_empty(&iface->mt.chunks) && !iface->mt.stop) {
+            pthread_cond_wait(&iface->mt.cond, &iface->mt.lock);
+        }
+
+        if (iface->mt.stop) {
+            break;
+        }
+
+        chunk = ucs_queue_pull_elem_non_empty(&iface->mt.chunks,
+                                              uct_scopy_tx_chunk_t, queue);
+        pthread_mutex_unlock(&iface->mt.lock);
+
+        tx     = chunk->tx;
+        ep     = ucs_derived_of(chunk->tl_ep, uct_scopy_ep_t);
+        status = uct_scopy_ep_tx_chunk(chunk, iface->mt.tx);
+        if (ucs_unlikely(status != UCS_OK)) {
+            tx->mt.failed = 1;
+        }
+
+        /* the progress thread completes the operation and releases the chunks
+         * after the last one, and the endpoint is destroyed only after all of
+         * its chunks are done */
+        ucs_memory_cpu_store_fence();
+        ucs_atomic_sub32(&tx->mt.pending, 1);
+        ucs_atomic_sub32(&ep->mt_chunks, 1);
+
+        pthread_mutex_lock(&iface->mt.lock);
+    }
+    pthread_mutex_unlock(&iface->mt.lock);
+
+    return NULL;
+}
+
+void uct_scopy_iface_mt_submit(uct_scopy_iface_t *iface,
+                               uct_scopy_tx_chunk_t *chunks,
+                               unsigned num_chunks)
+{
+    unsigned i;
+
+    pthread_mutex_lock(&iface->mt.lock);
+    for (i = 0; i < num_chunks; ++i) {
+        ucs_queue_push(&iface->mt.chunks, &chunks[i].queue);
+    }
+    pthread_cond_broadcast(&iface->mt.cond);
+    pthread_mutex_unlock(&iface->mt.lock);
+}
+
+static void uct_scopy_iface_mt_stop(uct_scopy_iface_t *iface,
+                                    unsigned num_threads)
+{
+    unsigned i;
+
+    pthread_mutex_lock(&iface->mt.lock);
+    iface->mt.stop = 1;
+    pthread_cond_broadcast(&iface->mt.cond);
+    pthread_mutex_unlock(&iface->mt.lock);
+
+    for (i = 0; i < num_threads; ++i) {
+        pthread_join(iface->mt.threads[i], NULL);
+    }
+
+    ucs_free(iface->mt.threads);
+    pthread_cond_destroy(&iface->mt.cond);
+    pthread_mutex_destroy(&iface->mt.lock);
+}
+
+static void uct_scopy_iface_mt_set_affinity(uct_scopy_iface_t *iface,
+                                            pthread_t thread,
+                                            const char *cpu_str)
+{
+    ucs_sys_cpuset_t cpu_mask;
+    unsigned long cpu;
+    char *end;
+    int ret;
+
+    cpu = strtoul(cpu_str, &end, 10);
+    if ((*end != '\0') || (cpu >= CPU_SETSIZE)) {
+        ucs_warn("scopy iface %p: invalid CPU '%s' for a copy thread", iface,
+                 cpu_str);
+        return;
+    }
+
+    CPU_ZERO(&cpu_mask);
+    CPU_SET(cpu, &cpu_mask);
+    ret = pthread_setaffinity_np(thread, sizeof(cpu_mask), &cpu_mask);
+    if (ret != 0) {
+        ucs_warn("scopy iface %p: failed to bind a copy thread to CPU %lu: %s",
+                 iface, cpu, strerror(ret));
+    }
+}
+
+static ucs_status_t
+uct_scopy_iface_mt_init(uct_scopy_iface_t *iface,
+                        const uct_scopy_iface_config_t *config,
+                        uct_scopy_ep_tx_func_t tx_func)
+{
+    ucs_status_t status;
+    unsigned i;
+
+    iface->mt.tx          = tx_func;
+    iface->mt.num_threads = (tx_func != NULL) ? config->mt.num_threads : 0;
+    iface->mt.thresh      = ucs_max(config->mt.thresh, 1);
+    iface->mt.threads     = NULL;
+    iface->mt.stop        = 0;
+    ucs_queue_head_init(&iface->mt.chunks);
+
+    if (iface->mt.num_threads == 0) {
+        return UCS_OK;
+    }
+
+    iface->mt.threads = ucs_calloc(iface->mt.num_threads,
+                                   sizeof(*iface->mt.threads),
+                                   "scopy_mt_threads");
+    if (iface->mt.threads == NULL) {
+        ucs_error("failed to allocate scopy copy threads array");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    pthread_mutex_init(&iface->mt.lock, NULL);
+    pthread_cond_init(&iface->mt.cond, NULL);
+
+    for (i = 0; i < iface->mt.num_threads; ++i) {
+        status = ucs_pthread_create(&iface->mt.threads[i],
+                                    uct_scopy_iface_mt_thread_func, iface,
+                                    "scopy_copy_%u", i);
+        if (status != UCS_OK) {
+            uct_scopy_iface_mt_stop(iface, i);
+            return status;
+        }
+
+        if (config->mt.cpus.count > 0) {
+            uct_scopy_iface_mt_set_affinity(
+                    iface, iface->mt.threads[i],
+                    config->mt.cpus.names[i % config->mt.cpus.count]);
+        }
+    }
+
+    ucs_debug("scopy iface %p: started %u copy threads for operations of "
+              "%zu bytes and more", iface, iface->mt.num_threads,
+              iface->mt.thresh);
+    return UCS_OK;
+}
+
 UCS_CLASS_INIT_FUNC(uct_scopy_iface_t, uct_iface_ops_t *ops,
                     uct_scopy_iface_ops_t *scopy_ops, uct_md_h md,
                     uct_worker_h worker, const uct_iface_params_t *params,
@@ -130,10 +422,16 @@ UCS_CLASS_INIT_FUNC(uct_scopy_iface_t, uct_iface_ops_t *ops,
     UCS_CLASS_CALL_SUPER_INIT(uct_sm_iface_t, ops, &scopy_ops->super, md,
                               worker, params, tl_config);
 
-    self->tx              = scopy_ops->ep_tx;
-    self->config.max_iov  = ucs_min(config->max_iov, ucs_iov_get_max());
-    self->config.seg_size = config->seg_size;
-    self->config.tx_quota = config->tx_quota;
+    self->tx                      = scopy_ops->ep_tx;
+    self->tx_batch                = scopy_ops->ep_tx_batch;
+    self->config.max_iov          = ucs_min(config->max_iov,
+                                            ucs_iov_get_max());
+    self->config.seg_size         = config->seg_size;
+    self->config.tx_quota         = config->tx_quota;
+    self->config.tx_batch         = ucs_min(config->tx_batch,
+                                            UCT_SCOPY_TX_BATCH_MAX);
+    self->config.tx_batch_max_iov = ucs_iov_get_max();
+    uct_scopy_iface_autotune_init(self, config);
 
     elem_size             = sizeof(uct_scopy_tx_t) +
                             self->config.max_iov * sizeof(uct_iov_t);
@@ -146,20 +444,52 @@ UCS_CLASS_INIT_FUNC(uct_scopy_iface_t, uct_iface_ops_t *ops,
     mp_params.ops             = &uct_scopy_mpool_ops;
     mp_params.name            = "uct_scopy_iface_tx_mp";
     status = ucs_mpool_init(&mp_params, &self->tx_mpool);
+    if (status != UCS_OK) {
+        return status;
+    }
 
-    return status;
+    status = uct_scopy_iface_mt_init(self, config, scopy_ops->ep_tx_mt);
+    if (status != UCS_OK) {
+        ucs_mpool_cleanup(&self->tx_mpool, 1);
+        return status;
+    }
+
+    return UCS_OK;
 }
 
 static UCS_CLASS_CLEANUP_FUNC(uct_scopy_iface_t)
 {
     uct_worker_progress_unregister_safe(&self->super.super.worker->super,
                                         &self->super.super.prog.id);
+    if (self->mt.num_threads > 0) {
+        uct_scopy_iface_mt_stop(self, self->mt.num_threads);
+    }
     ucs_mpool_cleanup(&self->tx_mpool, 1);
     ucs_arbiter_cleanup(&self->arbiter);
 }
 
 UCS_CLASS_DEFINE(uct_scopy_iface_t, uct_sm_iface_t);
 
+/* Same as uct_mm_iface_fifo_window_adjust() */
+static void uct_scopy_iface_autotune_quota(uct_scopy_iface_t *iface,
+                                           unsigned count)
+{
+    if (count < iface->config.tx_quota) {
+        iface->config.tx_quota        = ucs_max(iface->config.tx_quota /
+                                                UCT_SCOPY_IFACE_AUTOTUNE_MD_FACTOR,
+                                                iface->autotune.tx_quota_min);
+        iface->autotune.prev_wnd_cons = 0;
+    } else if (iface->autotune.prev_wnd_cons) {
+        iface->config.tx_quota += UCT_SCOPY_IFACE_AUTOTUNE_AI_VALUE;
+    } else {
+        iface->autotune.prev_wnd_cons = 1;
+    }
+
+    /* the segment size may have been increased */
+    iface->config.tx_quota = ucs_min(iface->config.tx_quota,
+                                     uct_scopy_iface_autotune_max_quota(iface));
+}
+
 unsigned uct_scopy_iface_progress(uct_iface_h tl_iface)
 {
     uct_scopy_iface_t *iface = ucs_derived_of(tl_iface, uct_scopy_iface_t);
@@ -167,6 +497,10 @@ unsigned uct_scopy_iface_progress(uct_iface_h tl_iface)
 
     ucs_arbiter_dispatch(&iface->arbiter, 1, uct_scopy_ep_progress_tx, &count);
 
+    if (iface->autotune.enable) {
+        uct_scopy_iface_autotune_quota(iface, count);
+    }
+
     if (ucs_unlikely(ucs_arbiter_is_empty(&iface->arbiter))) {
         uct_worker_progress_unregister_safe(&iface->super.super.worker->super,
                                             &iface->super.super.prog.id);
@@ -175,6 +509,18 @@ unsigned uct_scopy_iface_progress(uct_iface_h tl_iface)
     return count;
 }
 
+void uct_scopy_iface_vfs_refresh(uct_iface_h tl_iface)
+{
+    uct_scopy_iface_t *iface = ucs_derived_of(tl_iface, uct_scopy_iface_t);
+
+    ucs_vfs_obj_add_ro_file(iface, ucs_vfs_show_primitive,
+                            &iface->config.seg_size, UCS_VFS_TYPE_SIZET,
+                            "seg_size");
+    ucs_vfs_obj_add_ro_file(iface, ucs_vfs_show_primitive,
+                            &iface->config.tx_quota, UCS_VFS_TYPE_U32,
+                            "tx_quota");
+}
+
 ucs_status_t uct_scopy_iface_event_arm(uct_iface_h tl_iface, unsigned events)
 {
     uct_scopy_iface_t *iface = ucs_derived_of(tl_iface, uct_scopy_iface_t);
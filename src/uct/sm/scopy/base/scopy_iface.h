@@ -10,6 +10,9 @@
 
 #include <uct/base/uct_iface.h>
 #include <uct/sm/base/sm_iface.h>
+#include <ucs/datastruct/queue.h>
+
+#include <pthread.h>
 
 #define uct_scopy_trace_data(_tx) \
     ucs_trace_data("%s [tx %p iov %zu/%zu length %zu/%zu] to %" PRIx64 "(%+ld)", \
@@ -32,6 +35,22 @@ typedef struct uct_scopy_iface_config {
     unsigned                      tx_quota;   /* How many TX segments can be dispatched
                                                * during iface progress */
     uct_iface_mpool_config_t      tx_mpool;   /* TX memory pool configuration */
+    unsigned                      tx_batch;   /* How many TX operations can be copied
+                                               * by a single call */
+    struct {
+        int                       enable;     /* Whether to adjust the segment
+                                               * size and the TX quota */
+        size_t                    seg_size_min; /* Minimal segment size */
+        size_t                    seg_size_max; /* Maximal segment size */
+    } autotune;
+    struct {
+        unsigned                  num_threads; /* Number of copy threads */
+        size_t                    thresh;      /* Minimal length of operations
+                                                * which are split between the
+                                                * copy threads */
+        ucs_config_names_array_t  cpus;        /* CPUs to bind the copy
+                                                * threads to */
+    } mt;
 } uct_scopy_iface_config_t;
 
 
@@ -40,6 +59,8 @@ typedef struct uct_scopy_iface {
     ucs_arbiter_t                 arbiter;     /* TX arbiter */
     ucs_mpool_t                   tx_mpool;    /* TX memory pool */
     uct_scopy_ep_tx_func_t        tx;          /* TX function */
+    uct_scopy_ep_tx_batch_func_t  tx_batch;    /* TX function for multiple
+                                                * operations, or NULL */
     struct {
         size_t                    max_iov;     /* Maximum supported IOVs limited by
                                                 * user configuration and system
@@ -49,13 +70,61 @@ typedef struct uct_scopy_iface {
                                                 * Zcopy transfers */
         unsigned                  tx_quota;    /* How many TX segments can be dispatched
                                                 * during iface progress */
+        unsigned                  tx_batch;    /* How many TX operations can be
+                                                * copied by a single call */
+        size_t                    tx_batch_max_iov; /* Maximal total number of
+                                                     * IOVs of the operations
+                                                     * copied by a single call */
     } config;
+    struct {
+        int                       enable;      /* Whether the autotuning is
+                                                * enabled */
+        size_t                    seg_size_min; /* Minimal segment size */
+        size_t                    seg_size_max; /* Maximal segment size */
+        unsigned                  tx_quota_min; /* Minimal TX quota */
+        size_t                    quota_bytes; /* How many bytes a progress
+                                                * call may copy, limits the TX
+                                                * quota of small segments */
+        ucs_time_t                time;        /* Time spent copying the
+                                                * segments of the current
+                                                * measurement */
+        size_t                    bytes;       /* Bytes copied in the current
+                                                * measurement */
+        unsigned                  count;       /* Segments in the current
+                                                * measurement */
+        double                    prev_bw;     /* Bandwidth measured with the
+                                                * previous segment size */
+        int                       grow;        /* Whether the segment size is
+                                                * being increased */
+        int                       prev_wnd_cons; /* Whether the previous progress
+                                                  * call used the whole quota */
+    } autotune;
+    struct {
+        uct_scopy_ep_tx_func_t    tx;          /* TX function which may be
+                                                * called from the copy threads */
+        unsigned                  num_threads; /* Number of copy threads, 0 if
+                                                * disabled */
+        size_t                    thresh;      /* Minimal operation length to
+                                                * split between the threads */
+        pthread_t                 *threads;    /* Copy threads */
+        pthread_mutex_t           lock;        /* Protects the chunks queue */
+        pthread_cond_t            cond;        /* Signaled on new chunks */
+        ucs_queue_head_t          chunks;      /* Chunks waiting for a thread */
+        int                       stop;        /* Whether the threads should
+                                                * exit */
+    } mt;
 } uct_scopy_iface_t;
 
 
 typedef struct uct_scopy_iface_ops {
     uct_iface_internal_ops_t super;
     uct_scopy_ep_tx_func_t   ep_tx;
+    uct_scopy_ep_tx_func_t   ep_tx_mt;  /* Same as ep_tx, but thread safe and
+                                         * does not handle errors, or NULL if
+                                         * not supported */
+    uct_scopy_ep_tx_batch_func_t ep_tx_batch; /* Copies several operations at
+                                               * once, or NULL if not
+                                               * supported */
 } uct_scopy_iface_ops_t;
 
 
@@ -75,4 +144,13 @@ ucs_status_t uct_scopy_iface_event_arm(uct_iface_h tl_iface, unsigned events);
 ucs_status_t uct_scopy_iface_flush(uct_iface_h tl_iface, unsigned flags,
                                    uct_completion_t *comp);
 
+void uct_scopy_iface_vfs_refresh(uct_iface_h tl_iface);
+
+void uct_scopy_iface_autotune_seg(uct_scopy_iface_t *iface, size_t length,
+                                  ucs_time_t time);
+
+void uct_scopy_iface_mt_submit(uct_scopy_iface_t *iface,
+                               uct_scopy_tx_chunk_t *chunks,
+                               unsigned num_chunks);
+
 #endif
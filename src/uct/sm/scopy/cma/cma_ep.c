@@ -100,10 +100,11 @@ int uct_cma_ep_is_connected(const uct_ep_h tl_ep,
     return ep->remote_pid == uct_cma_ep_get_remote_pid(params->iface_addr);
 }
 
-ucs_status_t uct_cma_ep_tx(uct_ep_h tl_ep, const uct_iov_t *iov, size_t iov_cnt,
-                           ucs_iov_iter_t *iov_iter, size_t *length_p,
-                           uint64_t remote_addr, uct_rkey_t rkey,
-                           uct_scopy_tx_op_t tx_op)
+static UCS_F_ALWAYS_INLINE ucs_status_t
+uct_cma_ep_tx_common(uct_ep_h tl_ep, const uct_iov_t *iov, size_t iov_cnt,
+                     ucs_iov_iter_t *iov_iter, size_t *length_p,
+                     uint64_t remote_addr, uct_scopy_tx_op_t tx_op,
+                     int handle_error)
 {
     uct_cma_ep_t *ep     = ucs_derived_of(tl_ep, uct_cma_ep_t);
     size_t local_iov_idx = 0;
@@ -126,9 +127,15 @@ ucs_status_t uct_cma_ep_tx(uct_ep_h tl_ep, const uct_iov_t *iov, size_t iov_cnt,
                                   local_iov_cnt - local_iov_idx, &remote_iov,
                                   1, 0);
     if (ucs_unlikely(ret < 0)) {
-        uct_cma_ep_tx_error(ep, uct_cma_ep_fn[tx_op].name, ret, errno,
-                            &local_iov[local_iov_idx],
-                            local_iov_cnt - local_iov_idx, &remote_iov);
+        if (handle_error) {
+            uct_cma_ep_tx_error(ep, uct_cma_ep_fn[tx_op].name, ret, errno,
+                                &local_iov[local_iov_idx],
+                                local_iov_cnt - local_iov_idx, &remote_iov);
+        } else {
+            ucs_debug("%s(pid=%d length %zu) failed: %m",
+                      uct_cma_ep_fn[tx_op].name, ep->remote_pid,
+                      total_iov_length);
+        }
         return UCS_ERR_IO_ERROR;
     }
 
@@ -138,6 +145,68 @@ ucs_status_t uct_cma_ep_tx(uct_ep_h tl_ep, const uct_iov_t *iov, size_t iov_cnt,
     return UCS_OK;
 }
 
+ucs_status_t uct_cma_ep_tx(uct_ep_h tl_ep, const uct_iov_t *iov, size_t iov_cnt,
+                           ucs_iov_iter_t *iov_iter, size_t *length_p,
+                           uint64_t remote_addr, uct_rkey_t rkey,
+                           uct_scopy_tx_op_t tx_op)
+{
+    return uct_cma_ep_tx_common(tl_ep, iov, iov_cnt, iov_iter, length_p,
+                                remote_addr, tx_op, 1);
+}
+
+ucs_status_t uct_cma_ep_tx_mt(uct_ep_h tl_ep, const uct_iov_t *iov,
+                              size_t iov_cnt, ucs_iov_iter_t *iov_iter,
+                              size_t *length_p, uint64_t remote_addr,
+                              uct_rkey_t rkey, uct_scopy_tx_op_t tx_op)
+{
+    /* the error is handled when the operation is retried by the progress
+     * thread */
+    return uct_cma_ep_tx_common(tl_ep, iov, iov_cnt, iov_iter, length_p,
+                                remote_addr, tx_op, 0);
+}
+
+ucs_status_t uct_cma_ep_tx_batch(uct_ep_h tl_ep, uct_scopy_tx_t *const *txs,
+                                unsigned count)
+{
+    uct_cma_ep_t *ep        = ucs_derived_of(tl_ep, uct_cma_ep_t);
+    uct_cma_iface_t *iface  = ucs_derived_of(tl_ep->iface, uct_cma_iface_t);
+    uct_scopy_tx_op_t tx_op = txs[0]->op;
+    size_t local_iov_cnt    = 0;
+    size_t total_length     = 0;
+    ucs_iov_iter_t iov_iter;
+    size_t iov_cnt;
+    unsigned i;
+    ssize_t ret;
+
+    for (i = 0; i < count; ++i) {
+        ucs_assert(txs[i]->op == tx_op);
+        ucs_iov_iter_init(&iov_iter);
+        iov_cnt = iface->super.config.tx_batch_max_iov - local_iov_cnt;
+        iface->batch.remote_iov[i].iov_base =
+                (void*)(uintptr_t)txs[i]->remote_addr;
+        iface->batch.remote_iov[i].iov_len  =
+                uct_iov_to_iovec(&iface->batch.local_iov[local_iov_cnt],
+                                 &iov_cnt, txs[i]->iov, txs[i]->iov_cnt,
+                                 SIZE_MAX, &iov_iter);
+        ucs_assert(iov_iter.iov_index == txs[i]->iov_cnt);
+        local_iov_cnt += iov_cnt;
+        total_length  += iface->batch.remote_iov[i].iov_len;
+    }
+
+    ret = uct_cma_ep_fn[tx_op].fn(ep->remote_pid, iface->batch.local_iov,
+                                  local_iov_cnt, iface->batch.remote_iov,
+                                  count, 0);
+    if (ucs_unlikely(ret != total_length)) {
+        /* the operations are copied one by one, which handles the error */
+        ucs_debug("%s(pid=%d) of %u operations returned %zd instead of %zu",
+                  uct_cma_ep_fn[tx_op].name, ep->remote_pid, count, ret,
+                  total_length);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    return UCS_OK;
+}
+
 ucs_status_t uct_cma_ep_check(const uct_ep_h tl_ep, unsigned flags,
                               uct_completion_t *comp)
 {
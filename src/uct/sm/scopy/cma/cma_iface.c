@@ -156,14 +156,17 @@ static uct_iface_ops_t uct_cma_iface_tl_ops = {
 static uct_scopy_iface_ops_t uct_cma_iface_ops = {
     .super = {
         .iface_estimate_perf   = uct_scopy_iface_estimate_perf,
-        .iface_vfs_refresh     = (uct_iface_vfs_refresh_func_t)ucs_empty_function,
+        .iface_vfs_refresh     = uct_scopy_iface_vfs_refresh,
         .ep_query              = (uct_ep_query_func_t)ucs_empty_function_return_unsupported,
         .ep_invalidate         = (uct_ep_invalidate_func_t)ucs_empty_function_return_unsupported,
         .ep_connect_to_ep_v2   = ucs_empty_function_return_unsupported,
         .iface_is_reachable_v2 = uct_cma_iface_is_reachable_v2,
-        .ep_is_connected       = uct_cma_ep_is_connected
+        .ep_is_connected       = uct_cma_ep_is_connected,
+        .iface_am_bcast_bcopy  = (uct_iface_am_bcast_bcopy_func_t)ucs_empty_function_return_unsupported
     },
-    .ep_tx = uct_cma_ep_tx,
+    .ep_tx       = uct_cma_ep_tx,
+    .ep_tx_mt    = uct_cma_ep_tx_mt,
+    .ep_tx_batch = uct_cma_ep_tx_batch,
 };
 
 static UCS_CLASS_INIT_FUNC(uct_cma_iface_t, uct_md_h md, uct_worker_h worker,
@@ -174,12 +177,20 @@ static UCS_CLASS_INIT_FUNC(uct_cma_iface_t, uct_md_h md, uct_worker_h worker,
                               &uct_cma_iface_ops, md, worker, params,
                               tl_config);
 
+    self->batch.local_iov = ucs_malloc(self->super.config.tx_batch_max_iov *
+                                       sizeof(*self->batch.local_iov),
+                                       "cma_batch_iov");
+    if (self->batch.local_iov == NULL) {
+        ucs_error("failed to allocate CMA batch IOVs");
+        return UCS_ERR_NO_MEMORY;
+    }
+
     return UCS_OK;
 }
 
 static UCS_CLASS_CLEANUP_FUNC(uct_cma_iface_t)
 {
-    /* No op */
+    ucs_free(self->batch.local_iov);
 }
 
 UCS_CLASS_DEFINE(uct_cma_iface_t, uct_scopy_iface_t);
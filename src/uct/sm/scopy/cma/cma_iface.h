@@ -21,6 +21,13 @@ typedef struct uct_cma_iface_config {
 
 typedef struct uct_cma_iface {
     uct_scopy_iface_t             super;
+    struct {
+        struct iovec              *local_iov;  /* Local IOVs of all the
+                                                * operations */
+        struct iovec              remote_iov[UCT_SCOPY_TX_BATCH_MAX];
+                                               /* Remote buffer of each
+                                                * operation */
+    } batch;
 } uct_cma_iface_t;
 
 
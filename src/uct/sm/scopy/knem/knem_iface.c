@@ -76,14 +76,17 @@ static uct_iface_ops_t uct_knem_iface_tl_ops = {
 static uct_scopy_iface_ops_t uct_knem_iface_ops = {
     .super = {
         .iface_estimate_perf   = uct_scopy_iface_estimate_perf,
-        .iface_vfs_refresh     = (uct_iface_vfs_refresh_func_t)ucs_empty_function,
+        .iface_vfs_refresh     = uct_scopy_iface_vfs_refresh,
         .ep_query              = (uct_ep_query_func_t)ucs_empty_function_return_unsupported,
         .ep_invalidate         = (uct_ep_invalidate_func_t)ucs_empty_function_return_unsupported,
         .ep_connect_to_ep_v2   = ucs_empty_function_return_unsupported,
         .iface_is_reachable_v2 = uct_knem_iface_is_reachable_v2,
-        .ep_is_connected       = uct_base_ep_is_connected
+        .ep_is_connected       = uct_base_ep_is_connected,
+        .iface_am_bcast_bcopy  = (uct_iface_am_bcast_bcopy_func_t)ucs_empty_function_return_unsupported
     },
-    .ep_tx = uct_knem_ep_tx,
+    .ep_tx       = uct_knem_ep_tx,
+    .ep_tx_mt    = NULL,
+    .ep_tx_batch = NULL,
 };
 
 static UCS_CLASS_INIT_FUNC(uct_knem_iface_t, uct_md_h md, uct_worker_h worker,
@@ -114,7 +114,29 @@ enum {
     /* EP is on EP PTR map. */
     UCT_TCP_EP_FLAG_ON_PTR_MAP         = UCS_BIT(9),
     /* EP has some operations done without flush */
-    UCT_TCP_EP_FLAG_NEED_FLUSH         = UCS_BIT(10)
+    UCT_TCP_EP_FLAG_NEED_FLUSH         = UCS_BIT(10),
+    /* EP has a receive operation posted to the iface io_uring. */
+    UCT_TCP_EP_FLAG_RX_URING           = UCS_BIT(11),
+    /* EP is an additional connection of a user's EP, which is used to
+     * stripe large PUT Zcopy operations. */
+    UCT_TCP_EP_FLAG_STRIPE             = UCS_BIT(12),
+    /* A fence was requested while PUT operations on the stripe EPs were
+     * waiting for ACKs, the operations on the EP have to wait for them. */
+    UCT_TCP_EP_FLAG_FENCE_STRIPES      = UCS_BIT(13),
+    /* A fence was requested while operations on the EP were not
+     * acknowledged, PUT Zcopy operations mustn't be striped until an ACK
+     * for a PUT operation sent after the fence is received. */
+    UCT_TCP_EP_FLAG_FENCE_PRIMARY      = UCS_BIT(14),
+    /* The PUT RX operation in progress receives a GET response. */
+    UCT_TCP_EP_FLAG_GET_RX             = UCS_BIT(15),
+    /* TX buffer aggregates short and bcopy AMs, which are sent together
+     * when the aggregation limit is reached or from the progress. */
+    UCT_TCP_EP_FLAG_CORKED             = UCS_BIT(16),
+    /* EP has a progress callback scheduled to send the aggregated AMs. */
+    UCT_TCP_EP_FLAG_CORK_PROGRESS      = UCS_BIT(17),
+    /* The PUT RX operation in progress receives the payload of a large AM
+     * to a descriptor, which is passed to the user. */
+    UCT_TCP_EP_FLAG_AM_RX              = UCS_BIT(18)
 };
 
 
@@ -189,7 +211,10 @@ typedef enum uct_tcp_cm_conn_event {
 enum {
     /* Indicates whether both EPs of the connection has to use CONNECT_TO_EP
      * CONNECT_TO_EP of connection establishment */
-    UCT_TCP_CM_CONN_REQ_PKT_FLAG_CONNECT_TO_EP = UCS_BIT(0)
+    UCT_TCP_CM_CONN_REQ_PKT_FLAG_CONNECT_TO_EP = UCS_BIT(0),
+    /* Indicates that the connection is an additional connection of an EP,
+     * which is used only to receive striped PUT operations */
+    UCT_TCP_CM_CONN_REQ_PKT_FLAG_STRIPE        = UCS_BIT(1)
 };
 
 
@@ -225,7 +250,12 @@ typedef enum uct_tcp_ep_am_id {
     /* AM ID reserved for TCP internal PUT ACK message */
     UCT_TCP_EP_PUT_ACK_AM_ID   = UCT_AM_ID_MAX + 2,
     /* AM ID reserved for TCP internal keepalive message */
-    UCT_TCP_EP_KEEPALIVE_AM_ID = UCT_AM_ID_MAX + 3
+    UCT_TCP_EP_KEEPALIVE_AM_ID = UCT_AM_ID_MAX + 3,
+    /* AM ID reserved for TCP internal GET REQ message */
+    UCT_TCP_EP_GET_REQ_AM_ID   = UCT_AM_ID_MAX + 4,
+    /* AM ID reserved for TCP internal GET RESP message, which has the same
+     * header as PUT REQ message */
+    UCT_TCP_EP_GET_RESP_AM_ID  = UCT_AM_ID_MAX + 5
 } uct_tcp_ep_am_id_t;
 
 
@@ -239,6 +269,53 @@ typedef struct uct_tcp_ep_put_req_hdr {
 } UCS_S_PACKED uct_tcp_ep_put_req_hdr_t;
 
 
+/**
+ * TCP receive descriptor of a large AM, which is passed to the user with
+ * UCT_CB_PARAM_FLAG_DESC flag
+ */
+typedef struct uct_tcp_rx_desc {
+    uct_recv_desc_t               *release_desc; /* Has to be located right before
+                                                  * the user's descriptor */
+} uct_tcp_rx_desc_t;
+
+
+/**
+ * Large AM which is received to the RX descriptor, kept in the EP RX buffer
+ */
+typedef struct uct_tcp_ep_am_rx_req {
+    uct_tcp_ep_put_req_hdr_t      put_req;     /* Remaining part of the AM payload,
+                                                * has to be the first field to be
+                                                * received by PUT RX progress */
+    uct_tcp_rx_desc_t             *desc;       /* Descriptor with the AM payload */
+    uint32_t                      length;      /* Length of the AM payload */
+    uint8_t                       am_id;       /* AM identifier */
+} uct_tcp_ep_am_rx_req_t;
+
+
+/**
+ * TCP GET request header
+ */
+typedef struct uct_tcp_ep_get_req_hdr {
+    uint64_t                      addr;        /* Address of a remote memory buffer */
+    size_t                        length;      /* Length of a remote memory buffer */
+    uint64_t                      resp_addr;   /* Address of a local memory buffer
+                                                * to place the response to */
+    uint32_t                      sn;          /* Sequence number of the current GET
+                                                * operation, which is acked by the
+                                                * response */
+} UCS_S_PACKED uct_tcp_ep_get_req_hdr_t;
+
+
+/**
+ * TCP GET request waiting for resources to send the response
+ */
+typedef struct uct_tcp_ep_get_resp {
+    uct_tcp_ep_get_req_hdr_t      get_req;     /* Received GET request */
+    ucs_queue_elem_t              elem;        /* Element to insert the request into
+                                                * TCP EP GET response queue */
+} uct_tcp_ep_get_resp_t;
+
+
 /**
  * TCP PUT acknowledge header
  */
@@ -248,19 +325,32 @@ typedef struct uct_tcp_ep_put_ack_hdr {
 
 
 /**
- * TCP PUT completion
+ * TCP PUT or zero-copy send completion
  */
 typedef struct uct_tcp_ep_put_completion {
     uct_completion_t              *comp;           /* User's completion passed to
-                                                    * uct_ep_flush */
+                                                    * uct_ep_flush or to a Zcopy
+                                                    * operation */
     uint32_t                      wait_put_sn;     /* Sequence number of the last unacked
                                                     * PUT operations that was in-progress
-                                                    * when uct_ep_flush was called */
+                                                    * when uct_ep_flush was called, or of
+                                                    * the last MSG_ZEROCOPY send to wait
+                                                    * for when the completion is on the
+                                                    * EP zero-copy completion queue */
     ucs_queue_elem_t              elem;            /* Element to insert completion into
                                                     * TCP EP PUT operation pending queue */
 } uct_tcp_ep_put_completion_t;
 
 
+/**
+ * Completion of an operation which is split over the stripe EPs
+ */
+typedef struct uct_tcp_ep_stripe_completion {
+    uct_completion_t              super;           /* Completed by every part */
+    uct_completion_t              *comp;           /* User's completion */
+} uct_tcp_ep_stripe_completion_t;
+
+
 /**
  * TCP endpoint communication context
  */
@@ -283,6 +373,8 @@ typedef struct uct_tcp_ep_zcopy_tx {
     uct_completion_t              *comp;     /* Local UCT completion object */
     size_t                        iov_index; /* Current IOV index */
     size_t                        iov_cnt;   /* Number of IOVs that should be sent */
+    size_t                        copy_iov_cnt; /* Number of leading IOVs which are
+                                                 * sent without MSG_ZEROCOPY */
     struct iovec                  iov[0];    /* IOVs that should be sent */
 } uct_tcp_ep_zcopy_tx_t;
 
@@ -338,7 +430,7 @@ struct uct_tcp_ep {
     uint8_t                       conn_retries; /* Number of connection attempts done */
     uint8_t                       conn_state;   /* State of connection with peer */
     ucs_event_set_types_t         events;       /* Current notifications */
-    uint16_t                      flags;        /* Endpoint flags */
+    uint32_t                      flags;        /* Endpoint flags */
     int                           fd;           /* Socket file descriptor */
     int                           stale_fd;     /* Old file descriptor which should be
                                                  * closed as soon as the EP is connected
@@ -349,6 +441,22 @@ struct uct_tcp_ep {
     ucs_queue_head_t              pending_q;    /* Pending operations */
     ucs_queue_head_t              put_comp_q;   /* Flush completions waiting for
                                                  * outstanding PUTs acknowledgment */
+    ucs_queue_head_t              get_resp_q;   /* GET requests waiting for
+                                                 * resources to send the response */
+    struct {
+        uint32_t                  tx_sn;        /* Number of MSG_ZEROCOPY sends */
+        uint32_t                  comp_sn;      /* Number of MSG_ZEROCOPY sends
+                                                 * notified by the kernel */
+        ucs_queue_head_t          comp_q;       /* Completions waiting for the
+                                                 * MSG_ZEROCOPY notifications */
+    } msg_zcopy;
+    struct {
+        ucs_list_link_t           list;         /* Stripe EPs of a user's EP */
+        uct_tcp_ep_t              *owner;       /* User's EP of a stripe EP */
+        uint32_t                  fence_put_sn; /* Sequence number of the
+                                                 * first PUT operation after
+                                                 * the last fence */
+    } stripe;
     union {
         ucs_list_link_t           list;         /* List element to insert into TCP EP list */
         ucs_conn_match_elem_t     elem;         /* Connection matching element, used by EPs
@@ -361,6 +469,46 @@ struct uct_tcp_ep {
 UCS_PTR_MAP_DEFINE(tcp_ep, 0);
 
 
+/**
+ * Receive operation posted to the io_uring
+ */
+typedef struct uct_tcp_uring_rx {
+    uct_tcp_ep_t                  *ep;          /* EP which receives the data, or
+                                                 * NULL if the EP was destroyed */
+    void                          *buf;         /* Receive buffer */
+    size_t                        length;       /* Receive buffer length */
+    int                           result;       /* Result of the receive */
+} uct_tcp_uring_rx_t;
+
+
+/**
+ * io_uring which receives the data of all EPs which became readable during
+ * a single wait on the event set by one system call
+ */
+typedef struct uct_tcp_uring {
+    int                           fd;           /* io_uring fd, or -1 if
+                                                 * disabled */
+    unsigned                      entries;      /* Submission queue size */
+    void                          *sq_ring;     /* Mapped submission queue ring */
+    size_t                        sq_ring_size; /* Submission queue ring size */
+    void                          *cq_ring;     /* Mapped completion queue ring */
+    size_t                        cq_ring_size; /* Completion queue ring size */
+    void                          *sqes;        /* Mapped submission queue
+                                                 * entries */
+    size_t                        sqes_size;    /* Submission queue entries size */
+    unsigned                      *sq_tail;     /* Submission queue tail */
+    unsigned                      *sq_array;    /* Submission queue index array */
+    unsigned                      sq_mask;      /* Submission queue index mask */
+    unsigned                      *cq_head;     /* Completion queue head */
+    unsigned                      *cq_tail;     /* Completion queue tail */
+    unsigned                      cq_mask;      /* Completion queue index mask */
+    void                          *cqes;        /* Completion queue entries */
+    uct_tcp_uring_rx_t            *rx;          /* Posted receive operations */
+    unsigned                      rx_count;     /* Number of posted receive
+                                                 * operations */
+} uct_tcp_uring_t;
+
+
 /**
  * TCP interface
  */
@@ -377,18 +525,31 @@ typedef struct uct_tcp_iface {
     ucs_sys_event_set_t           *event_set;        /* Event set identifier */
     ucs_mpool_t                   tx_mpool;          /* TX memory pool */
     ucs_mpool_t                   rx_mpool;          /* RX memory pool */
+    ucs_mpool_t                   rx_desc_mpool;     /* Descriptors of large AMs
+                                                      * passed to the user */
+    size_t                        rx_headroom;       /* User's headroom in the RX
+                                                      * descriptors */
+    uct_recv_desc_t               release_desc;      /* Callback to release the RX
+                                                      * descriptors */
     size_t                        outstanding;       /* How much data in the EP send buffers
                                                       * + how many non-blocking connections
                                                       * are in progress + how many EPs are
                                                       * waiting for PUT Zcopy operation ACKs
-                                                      * (0/1 for each EP) */
+                                                      * (0/1 for each EP) + how many
+                                                      * MSG_ZEROCOPY sends are not notified
+                                                      * yet */
     ucs_range_spec_t              port_range;        /** Range of ports to use for bind() */
+    uct_tcp_uring_t               uring;             /* io_uring for receive operations */
 
     struct {
         size_t                    tx_seg_size;       /* TX AM buffer size */
         size_t                    rx_seg_size;       /* RX AM buffer size */
         size_t                    sendv_thresh;      /* Minimum size of user's payload from which
                                                       * non-blocking vector send should be used */
+        size_t                    cork_bytes;        /* Maximal size of short and bcopy AMs
+                                                      * aggregated in TX buffer, 0 - disabled */
+        size_t                    rx_desc_thresh;    /* Minimum size of AM payload which is
+                                                      * received to RX descriptor */
         size_t                    max_iov;           /* Maximum supported IOVs limited by
                                                       * user configuration and service buffers
                                                       * (TCP protocol and user's AM headers) */
@@ -396,6 +557,8 @@ typedef struct uct_tcp_iface {
             size_t                max_hdr;           /* Maximum supported AM Zcopy header */
             size_t                hdr_offset;        /* Offset in TX buffer to empty space that
                                                       * can be used for AM Zcopy header */
+            size_t                msg_thresh;        /* Minimum size of Zcopy payload which is
+                                                      * sent with MSG_ZEROCOPY */
         } zcopy;
         struct sockaddr_storage   ifaddr;            /* Network address */
         struct sockaddr_storage   netmask;           /* Network address mask */
@@ -403,6 +566,7 @@ typedef struct uct_tcp_iface {
         ucs_ternary_auto_value_t  ep_bind_src_addr;  /* Bind EP's FD to ifaddr */
         int                       prefer_default;    /* Prefer default gateway */
         int                       put_enable;        /* Enable PUT Zcopy operation support */
+        int                       get_enable;        /* Enable GET Zcopy operation support */
         int                       conn_nb;           /* Use non-blocking connect() */
         unsigned                  max_poll;          /* Number of events to poll per socket*/
         uint8_t                   max_conn_retries;  /* How many connection establishment attempts
@@ -412,6 +576,12 @@ typedef struct uct_tcp_iface {
                                                       * before aborting the attempt to connect.
                                                       * It cannot exceed 255. */
         double                    max_bw;            /* Upper bound to TCP iface bandwidth */
+        struct {
+            unsigned              count;             /* Number of connections per EP
+                                                      * to stripe PUT Zcopy over */
+            size_t                thresh;            /* Minimum size of PUT Zcopy
+                                                      * payload which is striped */
+        } stripe;
         struct {
             ucs_time_t            idle;              /* The time the connection needs to remain
                                                       * idle before TCP starts sending keepalive
@@ -441,8 +611,14 @@ typedef struct uct_tcp_iface_config {
     size_t                         rx_seg_size;
     size_t                         max_iov;
     size_t                         sendv_thresh;
+    size_t                         cork_bytes;
+    size_t                         rx_desc_thresh;
+    size_t                         msg_zcopy_thresh;
+    unsigned                       stripes;
+    size_t                         stripe_thresh;
     int                            prefer_default;
     int                            put_enable;
+    int                            get_enable;
     int                            conn_nb;
     unsigned                       max_poll;
     unsigned                       max_conn_retries;
@@ -459,6 +635,7 @@ typedef struct uct_tcp_iface_config {
         ucs_time_t                 intvl;
     } keepalive;
     ucs_ternary_auto_value_t       ep_bind_src_addr;
+    ucs_ternary_auto_value_t       io_uring;
 } uct_tcp_iface_config_t;
 
 
@@ -557,14 +734,14 @@ uct_tcp_ep_connect_to_ep_v2(uct_ep_h tl_ep,
 
 const char *uct_tcp_ep_ctx_caps_str(uint8_t ep_ctx_caps, char *str_buffer);
 
-void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint16_t new_caps);
+void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint32_t new_caps);
 
-void uct_tcp_ep_add_ctx_cap(uct_tcp_ep_t *ep, uint16_t cap);
+void uct_tcp_ep_add_ctx_cap(uct_tcp_ep_t *ep, uint32_t cap);
 
-void uct_tcp_ep_remove_ctx_cap(uct_tcp_ep_t *ep, uint16_t cap);
+void uct_tcp_ep_remove_ctx_cap(uct_tcp_ep_t *ep, uint32_t cap);
 
 void uct_tcp_ep_move_ctx_cap(uct_tcp_ep_t *from_ep, uct_tcp_ep_t *to_ep,
-                             uint16_t ctx_cap);
+                             uint32_t ctx_cap);
 
 void uct_tcp_ep_destroy_internal(uct_ep_h tl_ep);
 
@@ -572,6 +749,8 @@ void uct_tcp_ep_destroy(uct_ep_h tl_ep);
 
 void uct_tcp_ep_set_failed(uct_tcp_ep_t *ep, ucs_status_t status);
 
+ucs_status_t uct_tcp_ep_fence(uct_ep_h tl_ep, unsigned flags);
+
 void uct_tcp_ep_replace_ep(uct_tcp_ep_t *to_ep, uct_tcp_ep_t *from_ep);
 
 int uct_tcp_ep_is_self(const uct_tcp_ep_t *ep);
@@ -607,6 +786,10 @@ ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
                                   size_t iovcnt, uint64_t remote_addr,
                                   uct_rkey_t rkey, uct_completion_t *comp);
 
+ucs_status_t uct_tcp_ep_get_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp);
+
 ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req,
                                     unsigned flags);
 
@@ -654,6 +837,27 @@ ucs_status_t uct_tcp_cm_conn_start(uct_tcp_ep_t *ep);
 
 int uct_tcp_keepalive_is_enabled(uct_tcp_iface_t *iface);
 
+void *uct_tcp_ep_rx_uring_buf(uct_tcp_ep_t *ep);
+
+int uct_tcp_ep_post_rx_uring(uct_tcp_ep_t *ep);
+
+unsigned uct_tcp_ep_rx_uring_complete(uct_tcp_ep_t *ep, size_t recv_length);
+
+unsigned uct_tcp_ep_progress_rx_uring(uct_tcp_ep_t *ep, int result);
+
+unsigned uct_tcp_ep_progress_msg_zcopy(uct_tcp_ep_t *ep);
+
+ucs_status_t uct_tcp_uring_init(uct_tcp_uring_t *uring, unsigned entries);
+
+void uct_tcp_uring_cleanup(uct_tcp_uring_t *uring);
+
+void uct_tcp_uring_post_recv(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep,
+                             void *buf, size_t length);
+
+unsigned uct_tcp_uring_progress(uct_tcp_uring_t *uring);
+
+void uct_tcp_uring_remove_ep(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep);
+
 static UCS_F_ALWAYS_INLINE int uct_tcp_ep_ctx_buf_empty(uct_tcp_ep_ctx_t *ctx)
 {
     ucs_assert((ctx->length == 0) || (ctx->buf != NULL));
@@ -661,6 +865,22 @@ static UCS_F_ALWAYS_INLINE int uct_tcp_ep_ctx_buf_empty(uct_tcp_ep_ctx_t *ctx)
     return ctx->length == 0;
 }
 
+static UCS_F_ALWAYS_INLINE int
+uct_tcp_ep_msg_zcopy_in_progress(const uct_tcp_ep_t *ep)
+{
+    return ep->msg_zcopy.tx_sn != ep->msg_zcopy.comp_sn;
+}
+
+static UCS_F_ALWAYS_INLINE int uct_tcp_uring_is_enabled(uct_tcp_uring_t *uring)
+{
+    return uring->fd != -1;
+}
+
+static UCS_F_ALWAYS_INLINE int uct_tcp_uring_is_full(uct_tcp_uring_t *uring)
+{
+    return uring->rx_count == uring->entries;
+}
+
 static inline void uct_tcp_iface_outstanding_inc(uct_tcp_iface_t *iface)
 {
     iface->outstanding++;
@@ -230,8 +230,13 @@ ucs_status_t uct_tcp_cm_send_event(uct_tcp_ep_t *ep,
 
         conn_pkt        = (uct_tcp_cm_conn_req_pkt_t*)(pkt_hdr + 1);
         conn_pkt->event = UCT_TCP_CM_CONN_REQ;
-        conn_pkt->flags = (ep->flags & UCT_TCP_EP_FLAG_CONNECT_TO_EP) ?
-                          UCT_TCP_CM_CONN_REQ_PKT_FLAG_CONNECT_TO_EP : 0;
+        conn_pkt->flags = 0;
+        if (ep->flags & UCT_TCP_EP_FLAG_CONNECT_TO_EP) {
+            conn_pkt->flags |= UCT_TCP_CM_CONN_REQ_PKT_FLAG_CONNECT_TO_EP;
+        }
+        if (ep->flags & UCT_TCP_EP_FLAG_STRIPE) {
+            conn_pkt->flags |= UCT_TCP_CM_CONN_REQ_PKT_FLAG_STRIPE;
+        }
         conn_pkt->cm_id = ep->cm_id;
         memcpy(conn_pkt + 1, &iface->config.ifaddr, iface->config.sockaddr_len);
     } else {
@@ -569,7 +574,7 @@ uct_tcp_cm_handle_conn_req(uct_tcp_ep_t **ep_p,
     unsigned progress_count = 0;
     ucs_status_t status;
     uct_tcp_ep_t *peer_ep;
-    int connect_to_self;
+    int connect_to_self, stripe;
     char accept_err_str[UCT_TCP_CM_SOCKADDR_STR_LEN] UCS_V_UNUSED;
 
     ucs_assert(/* EP received the connection request after the TCP
@@ -601,7 +606,10 @@ uct_tcp_cm_handle_conn_req(uct_tcp_ep_t **ep_p,
                 "ep %p mustn't have TX cap", ep);
 
     connect_to_self = uct_tcp_ep_is_self(ep);
-    if (connect_to_self) {
+    stripe          = cm_req_pkt->flags & UCT_TCP_CM_CONN_REQ_PKT_FLAG_STRIPE;
+    if (connect_to_self || stripe) {
+        /* Stripe connection is used only to receive PUT operations, so it
+         * is not matched with the EPs connected to the peer */
         goto accept_conn;
     }
 
@@ -641,7 +649,7 @@ accept_conn:
     ucs_assert(!(cm_req_pkt->flags &
                  UCT_TCP_CM_CONN_REQ_PKT_FLAG_CONNECT_TO_EP) || connect_to_self);
 
-    if (!connect_to_self) {
+    if (!connect_to_self && !stripe) {
         uct_tcp_iface_remove_ep(ep);
         uct_tcp_cm_insert_ep(iface, ep);
     }
@@ -13,12 +13,18 @@
 
 #include <ucs/async/async.h>
 
+#ifdef UCT_TCP_MSG_ZEROCOPY
+#include <linux/errqueue.h>
+#endif
+
 
 /* Forward declarations */
 static unsigned uct_tcp_ep_progress_data_tx(void *arg);
 static unsigned uct_tcp_ep_progress_data_rx(void *arg);
 static unsigned uct_tcp_ep_progress_magic_number_rx(void *arg);
 static unsigned uct_tcp_ep_destroy_progress(void *arg);
+static unsigned uct_tcp_ep_progress_cork(void *arg);
+static ucs_status_t uct_tcp_ep_cork_flush(uct_tcp_ep_t *ep);
 
 const uct_tcp_cm_state_t uct_tcp_ep_cm_state[] = {
     [UCT_TCP_EP_CONN_STATE_CLOSED] = {
@@ -63,8 +69,11 @@ static inline int uct_tcp_ep_ctx_buf_need_progress(uct_tcp_ep_ctx_t *ctx)
 
 static inline ucs_status_t uct_tcp_ep_check_tx_res(uct_tcp_ep_t *ep)
 {
+    ucs_status_t status;
+
     if (ucs_likely((ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
-                   uct_tcp_ep_ctx_buf_empty(&ep->tx))) {
+                   uct_tcp_ep_ctx_buf_empty(&ep->tx) &&
+                   !(ep->flags & UCT_TCP_EP_FLAG_FENCE_STRIPES))) {
         return UCS_OK;
     } else if (ucs_unlikely(ep->conn_state == UCT_TCP_EP_CONN_STATE_CLOSED)) {
         return UCS_ERR_CONNECTION_RESET;
@@ -75,6 +84,21 @@ static inline ucs_status_t uct_tcp_ep_check_tx_res(uct_tcp_ep_t *ep)
                                   UCT_TCP_EP_FLAG_CTX_TYPE_RX)) &&
                    (ep->flags & UCT_TCP_EP_FLAG_CONNECT_TO_EP));
         return UCS_ERR_NO_RESOURCE;
+    } else if (ep->flags & UCT_TCP_EP_FLAG_CORKED) {
+        /* Send the aggregated AMs before the operation to keep the order */
+        ucs_assert(ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED);
+        status = uct_tcp_ep_cork_flush(ep);
+        if (ucs_unlikely(status != UCS_OK)) {
+            return status;
+        }
+
+        return uct_tcp_ep_check_tx_res(ep);
+    } else if ((ep->flags & UCT_TCP_EP_FLAG_FENCE_STRIPES) &&
+               uct_tcp_ep_ctx_buf_empty(&ep->tx)) {
+        /* The EP is progressed when the PUT ACKs for the operations sent
+         * before the fence are received on the stripe EPs */
+        ucs_assert(ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED);
+        return UCS_ERR_NO_RESOURCE;
     }
 
     ucs_assertv((ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTING) ||
@@ -132,11 +156,22 @@ int uct_tcp_ep_is_self(const uct_tcp_ep_t *ep)
 
 static void uct_tcp_ep_cleanup(uct_tcp_ep_t *ep)
 {
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    uct_tcp_uring_remove_ep(&iface->uring, ep);
+
     if (ep->tx.buf != NULL) {
         uct_tcp_ep_ctx_reset(&ep->tx);
     }
 
     if (ep->rx.buf != NULL) {
+        if (ep->flags & UCT_TCP_EP_FLAG_AM_RX) {
+            /* The AM was not received entirely, so it wasn't passed to the
+             * user */
+            ucs_mpool_put_inline(((uct_tcp_ep_am_rx_req_t*)ep->rx.buf)->desc);
+        }
+
         uct_tcp_ep_ctx_reset(&ep->rx);
     }
 
@@ -241,6 +276,13 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_ep_t, uct_tcp_iface_t *iface, int fd,
     ucs_list_head_init(&self->list);
     ucs_queue_head_init(&self->pending_q);
     ucs_queue_head_init(&self->put_comp_q);
+    ucs_queue_head_init(&self->get_resp_q);
+    ucs_queue_head_init(&self->msg_zcopy.comp_q);
+    self->msg_zcopy.tx_sn   = 0;
+    self->msg_zcopy.comp_sn = 0;
+    ucs_list_head_init(&self->stripe.list);
+    self->stripe.owner        = NULL;
+    self->stripe.fence_put_sn = 0;
 
     if (dest_addr != NULL) {
         memcpy(&self->peer_addr[0], dest_addr, iface->config.sockaddr_len);
@@ -271,7 +313,7 @@ const char *uct_tcp_ep_ctx_caps_str(uint8_t ep_ctx_caps, char *str_buffer)
     return str_buffer;
 }
 
-void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint16_t new_caps)
+void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint32_t new_caps)
 {
     char str_prev_ctx_caps[UCT_TCP_EP_CTX_CAPS_STR_MAX];
     char str_cur_ctx_caps[UCT_TCP_EP_CTX_CAPS_STR_MAX];
@@ -284,20 +326,20 @@ void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint16_t new_caps)
     }
 }
 
-void uct_tcp_ep_add_ctx_cap(uct_tcp_ep_t *ep, uint16_t ctx_cap)
+void uct_tcp_ep_add_ctx_cap(uct_tcp_ep_t *ep, uint32_t ctx_cap)
 {
     ucs_assert(ctx_cap & UCT_TCP_EP_CTX_CAPS);
     uct_tcp_ep_change_ctx_caps(ep, ep->flags | ctx_cap);
 }
 
-void uct_tcp_ep_remove_ctx_cap(uct_tcp_ep_t *ep, uint16_t ctx_cap)
+void uct_tcp_ep_remove_ctx_cap(uct_tcp_ep_t *ep, uint32_t ctx_cap)
 {
     ucs_assert(ctx_cap & UCT_TCP_EP_CTX_CAPS);
     uct_tcp_ep_change_ctx_caps(ep, ep->flags & ~ctx_cap);
 }
 
 void uct_tcp_ep_move_ctx_cap(uct_tcp_ep_t *from_ep, uct_tcp_ep_t *to_ep,
-                             uint16_t ctx_cap)
+                             uint32_t ctx_cap)
 {
     uct_tcp_ep_remove_ctx_cap(from_ep, ctx_cap);
     uct_tcp_ep_add_ctx_cap(to_ep, ctx_cap);
@@ -321,6 +363,15 @@ uct_tcp_ep_progress_rx_remove_filter(const ucs_callbackq_elem_t *elem,
     return (elem->cb == uct_tcp_ep_progress_data_rx) && (elem->arg == ep);
 }
 
+static int
+uct_tcp_ep_progress_cork_remove_filter(const ucs_callbackq_elem_t *elem,
+                                       void *arg)
+{
+    uct_tcp_ep_t *ep = (uct_tcp_ep_t*)arg;
+
+    return (elem->cb == uct_tcp_ep_progress_cork) && (elem->arg == ep);
+}
+
 static UCS_F_ALWAYS_INLINE void
 uct_tcp_ep_tx_started(uct_tcp_ep_t *ep, const uct_tcp_am_hdr_t *hdr)
 {
@@ -351,14 +402,97 @@ uct_tcp_ep_zcopy_completed(uct_tcp_ep_t *ep, uct_completion_t *comp,
     }
 }
 
+static void
+uct_tcp_ep_msg_zcopy_comp_push(uct_tcp_ep_t *ep,
+                               uct_tcp_ep_put_completion_t *zcopy_comp)
+{
+    /* Wait for the notifications of all MSG_ZEROCOPY sends done so far */
+    zcopy_comp->wait_put_sn = ep->msg_zcopy.tx_sn;
+    ucs_queue_push(&ep->msg_zcopy.comp_q, &zcopy_comp->elem);
+}
+
+static ucs_status_t
+uct_tcp_ep_msg_zcopy_comp_add(uct_tcp_ep_t *ep, uct_completion_t *comp)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_put_completion_t *zcopy_comp;
+
+    if (ucs_likely(!uct_tcp_ep_msg_zcopy_in_progress(ep))) {
+        return UCS_OK;
+    }
+
+    if (comp != NULL) {
+        zcopy_comp = ucs_mpool_get_inline(&iface->tx_mpool);
+        if (ucs_unlikely(zcopy_comp == NULL)) {
+            ucs_error("tcp_ep %p: unable to allocate zero-copy send "
+                      "completion from mpool", ep);
+            return UCS_ERR_NO_MEMORY;
+        }
+
+        zcopy_comp->comp = comp;
+        uct_tcp_ep_msg_zcopy_comp_push(ep, zcopy_comp);
+    }
+
+    return UCS_INPROGRESS;
+}
+
+static void uct_tcp_ep_msg_zcopy_dispatch(uct_tcp_ep_t *ep, ucs_status_t status)
+{
+    uct_tcp_ep_put_completion_t *zcopy_comp;
+
+    ucs_queue_for_each_extract(zcopy_comp, &ep->msg_zcopy.comp_q, elem,
+                               UCS_CIRCULAR_COMPARE32(zcopy_comp->wait_put_sn,
+                                                      <=,
+                                                      ep->msg_zcopy.comp_sn)) {
+        uct_invoke_completion(zcopy_comp->comp, status);
+        ucs_mpool_put_inline(zcopy_comp);
+    }
+}
+
+/* Account MSG_ZEROCOPY sends as completed, also if the kernel did not
+ * notify about them yet */
+static void uct_tcp_ep_msg_zcopy_set_comp_sn(uct_tcp_ep_t *ep, uint32_t comp_sn)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uint32_t count         = comp_sn - ep->msg_zcopy.comp_sn;
+
+    ucs_assertv(UCS_CIRCULAR_COMPARE32(comp_sn, <=, ep->msg_zcopy.tx_sn),
+                "ep=%p comp_sn=%u tx_sn=%u", ep, comp_sn, ep->msg_zcopy.tx_sn);
+    ucs_assert(iface->outstanding >= count);
+
+    iface->outstanding    -= count;
+    ep->msg_zcopy.comp_sn  = comp_sn;
+}
+
+static void uct_tcp_ep_zcopy_sent(uct_tcp_ep_t *ep, uct_completion_t *comp)
+{
+    ucs_status_t status;
+
+    ep->flags &= ~UCT_TCP_EP_FLAG_ZCOPY_TX;
+
+    /* The data may be still used by the kernel for MSG_ZEROCOPY sends */
+    status = uct_tcp_ep_msg_zcopy_comp_add(ep, comp);
+    if ((status != UCS_INPROGRESS) && (comp != NULL)) {
+        uct_invoke_completion(comp, status);
+    }
+}
+
 static void uct_tcp_ep_purge(uct_tcp_ep_t *ep, ucs_status_t status)
 {
     uct_tcp_ep_put_completion_t *put_comp;
+    uct_tcp_ep_get_resp_t *get_resp;
     uct_tcp_ep_zcopy_tx_t *ctx;
 
     ucs_debug("tcp_ep %p: purge outstanding operations with status %s", ep,
               ucs_status_string(status));
 
+    /* Complete the operations waiting for MSG_ZEROCOPY notifications first,
+     * since they were posted before the operation in progress */
+    uct_tcp_ep_msg_zcopy_set_comp_sn(ep, ep->msg_zcopy.tx_sn);
+    uct_tcp_ep_msg_zcopy_dispatch(ep, status);
+
     if (ep->flags & UCT_TCP_EP_FLAG_ZCOPY_TX) {
         ctx = (uct_tcp_ep_zcopy_tx_t*)ep->tx.buf;
         uct_tcp_ep_zcopy_completed(ep, ctx->comp, status);
@@ -369,6 +503,59 @@ static void uct_tcp_ep_purge(uct_tcp_ep_t *ep, ucs_status_t status)
         uct_invoke_completion(put_comp->comp, status);
         ucs_mpool_put_inline(put_comp);
     }
+
+    /* The peer will not receive the responses anyway */
+    ucs_queue_for_each_extract(get_resp, &ep->get_resp_q, elem, 1) {
+        ucs_mpool_put_inline(get_resp);
+    }
+}
+
+static int uct_tcp_ep_stripes_put_in_progress(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_t *stripe;
+
+    ucs_list_for_each(stripe, &ep->stripe.list, list) {
+        if (stripe->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Called when a stripe EP doesn't wait for PUT ACKs anymore */
+static void uct_tcp_ep_stripe_put_done(uct_tcp_ep_t *stripe)
+{
+    uct_tcp_ep_t *ep = stripe->stripe.owner;
+
+    ucs_assert(stripe->flags & UCT_TCP_EP_FLAG_STRIPE);
+
+    if (!(ep->flags & UCT_TCP_EP_FLAG_FENCE_STRIPES) ||
+        uct_tcp_ep_stripes_put_in_progress(ep)) {
+        return;
+    }
+
+    ep->flags &= ~UCT_TCP_EP_FLAG_FENCE_STRIPES;
+    if ((!ucs_queue_is_empty(&ep->pending_q) ||
+         !ucs_queue_is_empty(&ep->get_resp_q) ||
+         (ep->flags & UCT_TCP_EP_FLAG_PUT_RX_SENDING_ACK)) &&
+        (ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED)) {
+        /* Progress the operations, the GET responses and the PUT ACK
+         * postponed by the fence */
+        uct_tcp_ep_mod_events(ep, UCS_EVENT_SET_EVWRITE, 0);
+    }
+}
+
+static void uct_tcp_ep_destroy_stripes(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_t *stripe, *tmp;
+
+    ucs_list_for_each_safe(stripe, tmp, &ep->stripe.list, list) {
+        uct_tcp_ep_destroy_internal(&stripe->super.super);
+    }
+
+    ep->flags &= ~(UCT_TCP_EP_FLAG_FENCE_STRIPES |
+                   UCT_TCP_EP_FLAG_FENCE_PRIMARY);
 }
 
 static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
@@ -378,6 +565,7 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
 
     uct_ep_pending_purge(&self->super.super, ucs_empty_function_do_assert_void,
                          NULL);
+    uct_tcp_ep_destroy_stripes(self);
 
     if (self->flags & UCT_TCP_EP_FLAG_ON_MATCH_CTX) {
         uct_tcp_cm_remove_ep(iface, self);
@@ -403,6 +591,11 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
 
     ucs_callbackq_remove_oneshot(&iface->super.worker->super.progress_q, self,
                                  uct_tcp_ep_progress_rx_remove_filter, self);
+    if (self->flags & UCT_TCP_EP_FLAG_CORK_PROGRESS) {
+        ucs_callbackq_remove_oneshot(&iface->super.worker->super.progress_q,
+                                     self, uct_tcp_ep_progress_cork_remove_filter,
+                                     self);
+    }
 
     uct_tcp_ep_cleanup(self);
     uct_tcp_cm_change_conn_state(self, UCT_TCP_EP_CONN_STATE_CLOSED);
@@ -451,6 +644,8 @@ void uct_tcp_ep_destroy(uct_ep_h tl_ep)
                                             uct_tcp_iface_t);
     ucs_status_t status;
 
+    uct_tcp_ep_destroy_stripes(ep);
+
     if (/* EPs that are connected as CONNECT_TO_EP have to be full duplex */
         !(ep->flags & UCT_TCP_EP_FLAG_CONNECT_TO_EP) &&
         (ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
@@ -501,7 +696,19 @@ void uct_tcp_ep_set_failed(uct_tcp_ep_t *ep, ucs_status_t status)
 
     uct_tcp_ep_mod_events(ep, 0, ep->events);
 
-    if (ep->flags & UCT_TCP_EP_FLAG_CTX_TYPE_TX) {
+    if (ep->flags & UCT_TCP_EP_FLAG_STRIPE) {
+        /* The owner EP keeps using its other connections */
+        ucs_diag("tcp_ep %p: stripe tcp_ep %p failed: %s", ep->stripe.owner,
+                 ep, ucs_status_string(status));
+        uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_CLOSED);
+        uct_tcp_ep_purge(ep, status);
+        if (ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK) {
+            uct_tcp_iface_outstanding_dec(iface);
+            ep->flags &= ~UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK;
+        }
+
+        uct_tcp_ep_stripe_put_done(ep);
+    } else if (ep->flags & UCT_TCP_EP_FLAG_CTX_TYPE_TX) {
         ucs_debug("tcp_ep %p: calling error handler (flags: %x)", ep,
                   ep->flags);
         uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_CLOSED);
@@ -730,12 +937,22 @@ void uct_tcp_ep_replace_ep(uct_tcp_ep_t *to_ep, uct_tcp_ep_t *from_ep)
 
     uct_tcp_ep_ctx_move(&to_ep->tx, &from_ep->tx);
     uct_tcp_ep_ctx_move(&to_ep->rx, &from_ep->rx);
+    /* The received data was already accounted in the RX context, so the
+     * context is moved with it */
+    uct_tcp_uring_remove_ep(&iface->uring, from_ep);
 
     ucs_queue_splice(&to_ep->pending_q, &from_ep->pending_q);
     ucs_queue_splice(&to_ep->put_comp_q, &from_ep->put_comp_q);
+    ucs_queue_splice(&to_ep->get_resp_q, &from_ep->get_resp_q);
+    /* The kernel numbers MSG_ZEROCOPY sends of each socket from 0, and the
+     * EPs did not send data yet */
+    ucs_assert(from_ep->msg_zcopy.tx_sn == 0);
+    ucs_assert(to_ep->msg_zcopy.tx_sn == 0);
 
     to_ep->flags |= from_ep->flags & (UCT_TCP_EP_FLAG_ZCOPY_TX           |
                                       UCT_TCP_EP_FLAG_PUT_RX             |
+                                      UCT_TCP_EP_FLAG_GET_RX             |
+                                      UCT_TCP_EP_FLAG_AM_RX              |
                                       UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK |
                                       UCT_TCP_EP_FLAG_PUT_RX_SENDING_ACK |
                                       UCT_TCP_EP_FLAG_NEED_FLUSH);
@@ -862,6 +1079,43 @@ uint64_t uct_tcp_ep_get_cm_id(const uct_tcp_ep_t *ep)
            ep->cm_id.ptr_map_key : ep->cm_id.conn_sn;
 }
 
+static void uct_tcp_ep_create_stripes(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_t *stripe;
+    ucs_status_t status;
+    unsigned count;
+
+    for (count = 1; count < iface->config.stripe.count; ++count) {
+        status = uct_tcp_ep_init(iface, -1, (struct sockaddr*)ep->peer_addr,
+                                 &stripe);
+        if (status != UCS_OK) {
+            break;
+        }
+
+        /* Stripe EP is hidden from the iface and destroyed with its owner */
+        uct_tcp_iface_remove_ep(stripe);
+        ucs_list_add_tail(&ep->stripe.list, &stripe->list);
+        stripe->flags        |= UCT_TCP_EP_FLAG_STRIPE;
+        stripe->cm_id         = ep->cm_id;
+        stripe->stripe.owner  = ep;
+
+        status = uct_tcp_ep_create_socket_and_connect(stripe);
+        if (status != UCS_OK) {
+            uct_tcp_ep_destroy_internal(&stripe->super.super);
+            break;
+        }
+
+        uct_tcp_ep_add_ctx_cap(stripe, UCT_TCP_EP_FLAG_CTX_TYPE_TX);
+    }
+
+    if (count < iface->config.stripe.count) {
+        ucs_diag("tcp_ep %p: using %u of %u connections to stripe PUT "
+                 "operations", ep, count, iface->config.stripe.count);
+    }
+}
+
 ucs_status_t uct_tcp_ep_create(const uct_ep_params_t *params, uct_ep_h *ep_p)
 {
     uct_tcp_iface_t *iface                = ucs_derived_of(params->iface,
@@ -894,6 +1148,8 @@ ucs_status_t uct_tcp_ep_create(const uct_ep_params_t *params, uct_ep_h *ep_p)
         if (status != UCS_OK) {
             return status;
         }
+
+        uct_tcp_ep_create_stripes(ep);
     }
 
     /* cppcheck-suppress autoVariables */
@@ -933,6 +1189,7 @@ uct_tcp_ep_connect_to_ep_v2(uct_ep_h tl_ep,
          * anymore */
         ucs_assert(uct_tcp_ep_ptr_map_retrieve(iface,
                                                ep->cm_id.ptr_map_key) == NULL);
+        uct_tcp_ep_create_stripes(ep);
         return UCS_OK;
     }
 
@@ -968,12 +1225,16 @@ uct_tcp_ep_connect_to_ep_v2(uct_ep_h tl_ep,
          * to the peer which has to find an EP created for this connection in
          * the EP PTR map */
         ep->cm_id.ptr_map_key = addr->ptr_map_key;
-        return uct_tcp_ep_connect(ep);
+        status                = uct_tcp_ep_connect(ep);
+        if (status != UCS_OK) {
+            return status;
+        }
+    } else {
+        ucs_assert(!uct_tcp_ep_is_self(ep));
+        uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_ACCEPTING);
     }
 
-    ucs_assert(!uct_tcp_ep_is_self(ep));
-    uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_ACCEPTING);
-
+    uct_tcp_ep_create_stripes(ep);
     return UCS_OK;
 }
 
@@ -1021,13 +1282,28 @@ static inline void uct_tcp_ep_handle_put_ack(uct_tcp_ep_t *ep,
         ucs_assert(ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK);
         ep->flags &= ~UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK;
         uct_tcp_iface_outstanding_dec(iface);
+
+        if (ep->flags & UCT_TCP_EP_FLAG_STRIPE) {
+            uct_tcp_ep_stripe_put_done(ep);
+        }
+    }
+
+    if ((ep->flags & UCT_TCP_EP_FLAG_FENCE_PRIMARY) &&
+        UCS_CIRCULAR_COMPARE32(put_ack->sn, >=, ep->stripe.fence_put_sn)) {
+        /* The data sent before the fence was delivered */
+        ep->flags &= ~UCT_TCP_EP_FLAG_FENCE_PRIMARY;
     }
 
     ucs_queue_for_each_extract(put_comp, &ep->put_comp_q, elem,
                                (UCS_CIRCULAR_COMPARE32(put_comp->wait_put_sn,
                                                        <=, put_ack->sn))) {
-        uct_invoke_completion(put_comp->comp, UCS_OK);
-        ucs_mpool_put_inline(put_comp);
+        if (uct_tcp_ep_msg_zcopy_in_progress(ep)) {
+            /* The PUT data could be still used by the kernel */
+            uct_tcp_ep_msg_zcopy_comp_push(ep, put_comp);
+        } else {
+            uct_invoke_completion(put_comp->comp, UCS_OK);
+            ucs_mpool_put_inline(put_comp);
+        }
     }
 }
 
@@ -1035,10 +1311,20 @@ void uct_tcp_ep_pending_queue_dispatch(uct_tcp_ep_t *ep)
 {
     uct_pending_req_priv_queue_t *priv;
 
+    /* The aggregated AMs don't prevent sending the next pending operations,
+     * since they are sent before them */
     uct_pending_queue_dispatch(priv, &ep->pending_q,
-                               uct_tcp_ep_ctx_buf_empty(&ep->tx));
-    if (uct_tcp_ep_ctx_buf_empty(&ep->tx)) {
-        ucs_assert(ucs_queue_is_empty(&ep->pending_q));
+                               (uct_tcp_ep_ctx_buf_empty(&ep->tx) ||
+                                (ep->flags & UCT_TCP_EP_FLAG_CORKED)) &&
+                               !(ep->flags & UCT_TCP_EP_FLAG_FENCE_STRIPES));
+    /* Keep EVWRITE to send the postponed GET responses and PUT ACK from TX
+     * progress, the aggregated AMs are sent from the progress callback */
+    if ((uct_tcp_ep_ctx_buf_empty(&ep->tx) ||
+         (ep->flags & UCT_TCP_EP_FLAG_CORKED)) &&
+        ucs_queue_is_empty(&ep->get_resp_q) &&
+        !(ep->flags & UCT_TCP_EP_FLAG_PUT_RX_SENDING_ACK)) {
+        ucs_assert(ucs_queue_is_empty(&ep->pending_q) ||
+                   (ep->flags & UCT_TCP_EP_FLAG_FENCE_STRIPES));
         uct_tcp_ep_mod_events(ep, 0, UCS_EVENT_SET_EVWRITE);
     }
 }
@@ -1066,6 +1352,7 @@ static void uct_tcp_ep_handle_disconnected(uct_tcp_ep_t *ep, ucs_status_t status
         }
 
         uct_tcp_ep_tx_completed(ep, ep->tx.length - ep->tx.offset);
+        ep->flags &= ~UCT_TCP_EP_FLAG_CORKED;
     }
 
     uct_tcp_ep_set_failed(ep, UCS_ERR_CONNECTION_RESET);
@@ -1102,6 +1389,61 @@ static inline ucs_status_t uct_tcp_ep_handle_send_err(uct_tcp_ep_t *ep,
     return status;
 }
 
+/* Send the IOVs starting from copy_iov_cnt with MSG_ZEROCOPY, the leading
+ * IOVs point to the TX buffer or to the stack, so they are always copied */
+static ucs_status_t
+uct_tcp_ep_sendv_iov(uct_tcp_ep_t *ep, struct iovec *iov, size_t iov_cnt,
+                     size_t copy_iov_cnt, size_t *length_p)
+{
+#ifdef UCT_TCP_MSG_ZEROCOPY
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    size_t copy_length, zcopy_length;
+    ucs_status_t status;
+
+    if (ucs_likely(copy_iov_cnt >= iov_cnt)) {
+        return ucs_socket_sendv_nb(ep->fd, iov, iov_cnt, length_p);
+    }
+
+    copy_length = 0;
+    if (copy_iov_cnt > 0) {
+        status = ucs_socket_sendv_flags_nb(ep->fd, iov, copy_iov_cnt, MSG_MORE,
+                                           &copy_length);
+        if ((status != UCS_OK) ||
+            (copy_length < ucs_iovec_total_length(iov, copy_iov_cnt))) {
+            *length_p = copy_length;
+            return status;
+        }
+    }
+
+    status = ucs_socket_sendv_flags_nb(ep->fd, iov + copy_iov_cnt,
+                                       iov_cnt - copy_iov_cnt, MSG_ZEROCOPY,
+                                       &zcopy_length);
+    if (ucs_unlikely(status == UCS_ERR_NO_MEMORY)) {
+        /* Out of locked memory or socket option memory for tracking the
+         * zero-copy sends, copy the data instead */
+        ucs_trace_data("tcp_ep %p: MSG_ZEROCOPY send failed, copying the data",
+                       ep);
+        status = ucs_socket_sendv_nb(ep->fd, iov + copy_iov_cnt,
+                                     iov_cnt - copy_iov_cnt, &zcopy_length);
+    } else if (zcopy_length > 0) {
+        /* The kernel reports a notification per successful send */
+        ep->msg_zcopy.tx_sn++;
+        uct_tcp_iface_outstanding_inc(iface);
+    }
+
+    *length_p = copy_length + zcopy_length;
+    if ((status != UCS_OK) && (copy_length > 0)) {
+        /* Report the error when sending the next time */
+        return UCS_OK;
+    }
+
+    return status;
+#else
+    return ucs_socket_sendv_nb(ep->fd, iov, iov_cnt, length_p);
+#endif
+}
+
 static inline ssize_t uct_tcp_ep_send(uct_tcp_ep_t *ep)
 {
     size_t sent_length;
@@ -1133,8 +1475,11 @@ static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
     ucs_assertv((ep->tx.offset < ep->tx.length) &&
                 (ctx->iov_cnt > 0), "ep=%p", ep);
 
-    status = ucs_socket_sendv_nb(ep->fd, &ctx->iov[ctx->iov_index],
-                                 ctx->iov_cnt - ctx->iov_index, &sent_length);
+    status = uct_tcp_ep_sendv_iov(ep, &ctx->iov[ctx->iov_index],
+                                  ctx->iov_cnt - ctx->iov_index,
+                                  (ctx->copy_iov_cnt > ctx->iov_index) ?
+                                  (ctx->copy_iov_cnt - ctx->iov_index) : 0,
+                                  &sent_length);
     if (ucs_unlikely(status != UCS_OK)) {
         if (status == UCS_ERR_NO_PROGRESS) {
             ucs_assert(sent_length == 0);
@@ -1152,7 +1497,7 @@ static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
         ucs_iov_advance(ctx->iov, ctx->iov_cnt,
                         &ctx->iov_index, sent_length);
     } else {
-        uct_tcp_ep_zcopy_completed(ep, ctx->comp, UCS_OK);
+        uct_tcp_ep_zcopy_sent(ep, ctx->comp);
     }
 
     ucs_assert(sent_length <= SSIZE_MAX);
@@ -1278,19 +1623,13 @@ static inline void uct_tcp_ep_handle_recv_err(uct_tcp_ep_t *ep,
     }
 }
 
-static inline unsigned uct_tcp_ep_recv(uct_tcp_ep_t *ep, size_t recv_length)
+static inline unsigned uct_tcp_ep_recv_complete(uct_tcp_ep_t *ep,
+                                                ucs_status_t status,
+                                                size_t recv_length)
 {
     uct_tcp_iface_t UCS_V_UNUSED *iface = ucs_derived_of(ep->super.super.iface,
                                                          uct_tcp_iface_t);
-    ucs_status_t status;
-
-    if (ucs_unlikely(recv_length == 0)) {
-        return 1;
-    }
 
-    status = ucs_socket_recv_nb(ep->fd, UCS_PTR_BYTE_OFFSET(ep->rx.buf,
-                                                            ep->rx.length),
-                                &recv_length);
     if (ucs_unlikely(status != UCS_OK)) {
         uct_tcp_ep_handle_recv_err(ep, status);
         return 0;
@@ -1305,6 +1644,20 @@ static inline unsigned uct_tcp_ep_recv(uct_tcp_ep_t *ep, size_t recv_length)
     return 1;
 }
 
+static inline unsigned uct_tcp_ep_recv(uct_tcp_ep_t *ep, size_t recv_length)
+{
+    ucs_status_t status;
+
+    if (ucs_unlikely(recv_length == 0)) {
+        return 1;
+    }
+
+    status = ucs_socket_recv_nb(ep->fd, UCS_PTR_BYTE_OFFSET(ep->rx.buf,
+                                                            ep->rx.length),
+                                &recv_length);
+    return uct_tcp_ep_recv_complete(ep, status, recv_length);
+}
+
 static inline void uct_tcp_ep_check_tx_completion(uct_tcp_ep_t *ep)
 {
     if (ucs_likely(!uct_tcp_ep_ctx_buf_need_progress(&ep->tx))) {
@@ -1314,10 +1667,51 @@ static inline void uct_tcp_ep_check_tx_completion(uct_tcp_ep_t *ep)
     }
 }
 
-/* Forward declaration - the function depends on AM send
+static ucs_status_t uct_tcp_ep_cork_flush(uct_tcp_ep_t *ep)
+{
+    ssize_t offset;
+
+    ucs_assert(ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED);
+
+    ep->flags &= ~UCT_TCP_EP_FLAG_CORKED;
+    offset     = uct_tcp_ep_send(ep);
+    if (ucs_unlikely(offset < 0)) {
+        return (ucs_status_t)offset;
+    }
+
+    ucs_trace_data("ep %p fd %d sent aggregated %zu/%zu bytes", ep, ep->fd,
+                   ep->tx.offset, ep->tx.length);
+
+    uct_tcp_ep_check_tx_completion(ep);
+    return UCS_OK;
+}
+
+static unsigned uct_tcp_ep_progress_cork(void *arg)
+{
+    uct_tcp_ep_t *ep = (uct_tcp_ep_t*)arg;
+
+    ep->flags &= ~UCT_TCP_EP_FLAG_CORK_PROGRESS;
+
+    /* The aggregated AMs could be already sent by another operation */
+    if (!(ep->flags & UCT_TCP_EP_FLAG_CORKED) ||
+        (ep->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED)) {
+        return 0;
+    }
+
+    uct_tcp_ep_cork_flush(ep);
+    return 1;
+}
+
+/* Forward declarations - the functions depend on AM send
  * functions implemented below */
 static void uct_tcp_ep_post_put_ack(uct_tcp_ep_t *ep);
 
+static void uct_tcp_ep_post_get_resp(uct_tcp_ep_t *ep);
+
+static void
+uct_tcp_ep_handle_get_req(uct_tcp_ep_t *ep,
+                          const uct_tcp_ep_get_req_hdr_t *get_req);
+
 static unsigned uct_tcp_ep_progress_data_tx(void *arg)
 {
     uct_tcp_ep_t *ep = (uct_tcp_ep_t*)arg;
@@ -1327,8 +1721,9 @@ static unsigned uct_tcp_ep_progress_data_tx(void *arg)
     ucs_trace_func("ep=%p", ep);
 
     if (uct_tcp_ep_ctx_buf_need_progress(&ep->tx)) {
-        offset = (!(ep->flags & UCT_TCP_EP_FLAG_ZCOPY_TX) ?
-                  uct_tcp_ep_send(ep) : uct_tcp_ep_sendv(ep));
+        ep->flags &= ~UCT_TCP_EP_FLAG_CORKED;
+        offset     = (!(ep->flags & UCT_TCP_EP_FLAG_ZCOPY_TX) ?
+                      uct_tcp_ep_send(ep) : uct_tcp_ep_sendv(ep));
         if (ucs_unlikely(offset < 0)) {
             return 1;
         }
@@ -1341,6 +1736,10 @@ static unsigned uct_tcp_ep_progress_data_tx(void *arg)
         uct_tcp_ep_check_tx_completion(ep);
     }
 
+    if (!ucs_queue_is_empty(&ep->get_resp_q)) {
+        uct_tcp_ep_post_get_resp(ep);
+    }
+
     if (ep->flags & UCT_TCP_EP_FLAG_PUT_RX_SENDING_ACK) {
         uct_tcp_ep_post_put_ack(ep);
     }
@@ -1373,31 +1772,52 @@ static inline ucs_status_t
 uct_tcp_ep_put_rx_advance(uct_tcp_ep_t *ep, uct_tcp_ep_put_req_hdr_t *put_req,
                           size_t recv_length)
 {
-    ucs_assert(!(ep->flags & UCT_TCP_EP_FLAG_PUT_RX_SENDING_ACK));
+    uct_tcp_ep_put_ack_hdr_t get_ack;
+
+    ucs_assert((ep->flags & (UCT_TCP_EP_FLAG_GET_RX |
+                             UCT_TCP_EP_FLAG_AM_RX)) ||
+               !(ep->flags & UCT_TCP_EP_FLAG_PUT_RX_SENDING_ACK));
     ucs_assert(recv_length <= put_req->length);
     put_req->addr   += recv_length;
     put_req->length -= recv_length;
 
-    if (!put_req->length) {
+    if (put_req->length) {
+        return UCS_INPROGRESS;
+    }
+
+    if (ep->flags & UCT_TCP_EP_FLAG_AM_RX) {
+        /* The AM is passed to the user by uct_tcp_ep_am_rx_desc_progress() */
+        return UCS_OK;
+    }
+
+    if (!(ep->flags & UCT_TCP_EP_FLAG_GET_RX)) {
         uct_tcp_ep_post_put_ack(ep);
+    }
 
-        /* EP's ctx_caps doesn't have UCT_TCP_EP_FLAG_PUT_RX flag
-         * set in case of entire PUT payload was received through
-         * AM protocol */
-        if (ep->flags & UCT_TCP_EP_FLAG_PUT_RX) {
-            ep->flags &= ~UCT_TCP_EP_FLAG_PUT_RX;
-            uct_tcp_ep_ctx_reset(&ep->rx);
-        }
+    /* The header can be located in the RX buffer, which is released below */
+    get_ack.sn = put_req->sn;
 
-        return UCS_OK;
+    /* EP's ctx_caps doesn't have UCT_TCP_EP_FLAG_PUT_RX flag
+     * set in case of entire PUT payload was received through
+     * AM protocol */
+    if (ep->flags & UCT_TCP_EP_FLAG_PUT_RX) {
+        ep->flags &= ~UCT_TCP_EP_FLAG_PUT_RX;
+        uct_tcp_ep_ctx_reset(&ep->rx);
     }
 
-    return UCS_INPROGRESS;
+    if (ep->flags & UCT_TCP_EP_FLAG_GET_RX) {
+        /* The response acknowledges the GET operation the same way as PUT
+         * ACK, since the peer handled all data sent before the request */
+        ep->flags &= ~UCT_TCP_EP_FLAG_GET_RX;
+        uct_tcp_ep_handle_put_ack(ep, &get_ack);
+    }
+
+    return UCS_OK;
 }
 
-static inline void uct_tcp_ep_handle_put_req(uct_tcp_ep_t *ep,
-                                             uct_tcp_ep_put_req_hdr_t *put_req,
-                                             size_t extra_recvd_length)
+static inline void uct_tcp_ep_put_rx_start(uct_tcp_ep_t *ep,
+                                           uct_tcp_ep_put_req_hdr_t *put_req,
+                                           size_t extra_recvd_length)
 {
     size_t copied_length;
     ucs_status_t status;
@@ -1409,13 +1829,6 @@ static inline void uct_tcp_ep_handle_put_req(uct_tcp_ep_t *ep,
            UCS_PTR_BYTE_OFFSET(ep->rx.buf, ep->rx.offset),
            copied_length);
     ep->rx.offset += copied_length;
-    ep->rx.put_sn  = put_req->sn;
-
-    /* Remove the flag that indicates that EP is sending PUT RX ACK in order
-     * to not ack the uncompleted PUT RX operation for which PUT REQ is being
-     * handled here. ACK for both operations will be sent after the completion
-     * of the last received PUT operation */
-    ep->flags &= ~UCT_TCP_EP_FLAG_PUT_RX_SENDING_ACK;
 
     status = uct_tcp_ep_put_rx_advance(ep, put_req, copied_length);
     if (status == UCS_OK) {
@@ -1429,45 +1842,153 @@ static inline void uct_tcp_ep_handle_put_req(uct_tcp_ep_t *ep,
     ep->flags |= UCT_TCP_EP_FLAG_PUT_RX;
 }
 
-static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
+static inline void uct_tcp_ep_handle_put_req(uct_tcp_ep_t *ep,
+                                             uct_tcp_ep_put_req_hdr_t *put_req,
+                                             size_t extra_recvd_length)
 {
-    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
-                                            uct_tcp_iface_t);
-    unsigned handled       = 0;
-    uct_tcp_am_hdr_t *hdr;
-    size_t recv_length;
-    size_t recvd_length;
-    size_t remaining;
+    ep->rx.put_sn = put_req->sn;
 
-    ucs_trace_func("ep=%p", ep);
+    /* Remove the flag that indicates that EP is sending PUT RX ACK in order
+     * to not ack the uncompleted PUT RX operation for which PUT REQ is being
+     * handled here. ACK for both operations will be sent after the completion
+     * of the last received PUT operation */
+    ep->flags &= ~UCT_TCP_EP_FLAG_PUT_RX_SENDING_ACK;
 
-    if (!uct_tcp_ep_ctx_buf_need_progress(&ep->rx)) {
-        if (ucs_unlikely(uct_tcp_ep_ctx_buf_alloc(
-                                ep, &ep->rx, &iface->rx_mpool) != UCS_OK)) {
-            return 0;
-        }
+    uct_tcp_ep_put_rx_start(ep, put_req, extra_recvd_length);
+}
 
-        /* post the entire AM buffer */
-        recv_length = iface->config.rx_seg_size;
-    } else if (ep->rx.length < sizeof(*hdr)) {
-        ucs_assert((ep->rx.buf != NULL) && (ep->rx.offset == 0));
+static inline void
+uct_tcp_ep_handle_get_resp(uct_tcp_ep_t *ep, uct_tcp_ep_put_req_hdr_t *get_resp,
+                           size_t extra_recvd_length)
+{
+    /* GET response is received as PUT operation to the local buffer, but
+     * it completes the GET operation instead of sending PUT ACK */
+    ep->flags |= UCT_TCP_EP_FLAG_GET_RX;
+    uct_tcp_ep_put_rx_start(ep, get_resp, extra_recvd_length);
+}
+
+/* Continue receiving the large AM directly to the descriptor which is passed
+ * to the user, instead of the RX buffer */
+static void uct_tcp_ep_am_rx_desc_start(uct_tcp_iface_t *iface,
+                                        uct_tcp_ep_t *ep,
+                                        const uct_tcp_am_hdr_t *hdr)
+{
+    uct_tcp_ep_am_rx_req_t *am_rx_req;
+    uct_tcp_rx_desc_t *desc;
+    size_t recvd_length;
+    uint32_t length;
+    uint8_t am_id;
+    void *data;
+
+    desc = ucs_mpool_get_inline(&iface->rx_desc_mpool);
+    if (ucs_unlikely(desc == NULL)) {
+        /* Receive the AM to the RX buffer */
+        return;
+    }
+
+    /* The header can be located in the RX buffer, which is reused below */
+    am_id              = hdr->am_id;
+    length             = hdr->length;
+    recvd_length       = ep->rx.length - ep->rx.offset - sizeof(*hdr);
+    desc->release_desc = &iface->release_desc;
+    data               = UCS_PTR_BYTE_OFFSET(desc + 1, iface->rx_headroom);
+    memcpy(data, hdr + 1, recvd_length);
+
+    uct_tcp_ep_ctx_rewind(&ep->rx);
+    am_rx_req                 = (uct_tcp_ep_am_rx_req_t*)ep->rx.buf;
+    am_rx_req->put_req.addr   = (uintptr_t)UCS_PTR_BYTE_OFFSET(data,
+                                                               recvd_length);
+    am_rx_req->put_req.length = length - recvd_length;
+    am_rx_req->put_req.sn     = ep->rx.put_sn;
+    am_rx_req->desc           = desc;
+    am_rx_req->length         = length;
+    am_rx_req->am_id          = am_id;
+    ep->flags                |= UCT_TCP_EP_FLAG_PUT_RX | UCT_TCP_EP_FLAG_AM_RX;
+
+    ucs_trace_data("tcp_ep %p: receiving AM id %u length %u to desc %p, "
+                   "received %zu bytes", ep, am_id, length, desc,
+                   recvd_length);
+}
+
+/* Pass the AM received to the descriptor to the user */
+static unsigned uct_tcp_ep_am_rx_desc_progress(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface            = ucs_derived_of(ep->super.super.iface,
+                                                       uct_tcp_iface_t);
+    uct_tcp_ep_am_rx_req_t *am_rx_req = (uct_tcp_ep_am_rx_req_t*)ep->rx.buf;
+    uct_tcp_rx_desc_t *desc;
+    ucs_status_t status;
+    uint32_t length;
+    uint8_t am_id;
+    void *data;
+
+    if (!(ep->flags & UCT_TCP_EP_FLAG_AM_RX) ||
+        (am_rx_req->put_req.length != 0)) {
+        return 0;
+    }
+
+    desc       = am_rx_req->desc;
+    length     = am_rx_req->length;
+    am_id      = am_rx_req->am_id;
+    ep->flags &= ~(UCT_TCP_EP_FLAG_PUT_RX | UCT_TCP_EP_FLAG_AM_RX);
+    uct_tcp_ep_ctx_reset(&ep->rx);
+
+    data = UCS_PTR_BYTE_OFFSET(desc + 1, iface->rx_headroom);
+    uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_RECV, am_id, data,
+                       length, "RECV: ep %p fd %d received %u bytes to desc %p",
+                       ep, ep->fd, length, desc);
+    status = uct_iface_invoke_am(&iface->super, am_id, data, length,
+                                 UCT_CB_PARAM_FLAG_DESC);
+    if (status != UCS_INPROGRESS) {
+        ucs_mpool_put_inline(desc);
+    }
+
+    return 1;
+}
+
+static inline ucs_status_t
+uct_tcp_ep_am_rx_prepare(uct_tcp_ep_t *ep, size_t *recv_length_p)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_am_hdr_t *hdr;
+    size_t recvd_length;
+    ucs_status_t status;
+
+    if (!uct_tcp_ep_ctx_buf_need_progress(&ep->rx)) {
+        status = uct_tcp_ep_ctx_buf_alloc(ep, &ep->rx, &iface->rx_mpool);
+        if (ucs_unlikely(status != UCS_OK)) {
+            return status;
+        }
+
+        /* post the entire AM buffer */
+        *recv_length_p = iface->config.rx_seg_size;
+    } else if (ep->rx.length < sizeof(*hdr)) {
+        ucs_assert((ep->rx.buf != NULL) && (ep->rx.offset == 0));
 
         /* do partial receive of the remaining part of the hdr
          * and post the entire AM buffer */
-        recv_length = iface->config.rx_seg_size - ep->rx.length;
+        *recv_length_p = iface->config.rx_seg_size - ep->rx.length;
     } else {
         ucs_assert((ep->rx.buf != NULL) &&
                    ((ep->rx.length - ep->rx.offset) >= sizeof(*hdr)));
 
         /* do partial receive of the remaining user data */
-        hdr          = UCS_PTR_BYTE_OFFSET(ep->rx.buf, ep->rx.offset);
-        recvd_length = ep->rx.length - ep->rx.offset - sizeof(*hdr);
-        recv_length  = ucs_max(0, (ssize_t)(hdr->length - recvd_length));
+        hdr            = UCS_PTR_BYTE_OFFSET(ep->rx.buf, ep->rx.offset);
+        recvd_length   = ep->rx.length - ep->rx.offset - sizeof(*hdr);
+        *recv_length_p = ucs_max(0, (ssize_t)(hdr->length - recvd_length));
     }
 
-    if (!uct_tcp_ep_recv(ep, recv_length)) {
-        goto out;
-    }
+    return UCS_OK;
+}
+
+static unsigned uct_tcp_ep_am_rx_parse(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    unsigned handled       = 0;
+    uct_tcp_am_hdr_t *hdr;
+    size_t remaining;
 
     /* Parse received active messages */
     while (uct_tcp_ep_ctx_buf_need_progress(&ep->rx)) {
@@ -1489,6 +2010,11 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
                     (iface->config.rx_seg_size - sizeof(*hdr)));
 
         if (remaining < (sizeof(*hdr) + hdr->length)) {
+            if ((hdr->length >= iface->config.rx_desc_thresh) &&
+                (hdr->am_id < UCT_AM_ID_MAX)) {
+                uct_tcp_ep_am_rx_desc_start(iface, ep, hdr);
+            }
+
             handled++;
             goto out;
         }
@@ -1524,6 +2050,20 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
             ucs_assert(hdr->length == sizeof(uint32_t));
             uct_tcp_ep_handle_put_ack(ep, (uct_tcp_ep_put_ack_hdr_t*)(hdr + 1));
             handled++;
+        } else if (hdr->am_id == UCT_TCP_EP_GET_REQ_AM_ID) {
+            ucs_assert(hdr->length == sizeof(uct_tcp_ep_get_req_hdr_t));
+            uct_tcp_ep_handle_get_req(ep, (uct_tcp_ep_get_req_hdr_t*)(hdr + 1));
+            handled++;
+        } else if (hdr->am_id == UCT_TCP_EP_GET_RESP_AM_ID) {
+            ucs_assert(hdr->length == sizeof(uct_tcp_ep_put_req_hdr_t));
+            uct_tcp_ep_handle_get_resp(ep, (uct_tcp_ep_put_req_hdr_t*)(hdr + 1),
+                                       ep->rx.length - ep->rx.offset);
+            handled++;
+            if (ep->flags & UCT_TCP_EP_FLAG_PUT_RX) {
+                /* GET response payload is received directly to the user's
+                 * buffer, and the EP RX buffer keeps the header */
+                goto out;
+            }
         } else if (hdr->am_id == UCT_TCP_EP_KEEPALIVE_AM_ID) {
             /* just ignore keepalive requests */
             handled++;
@@ -1545,6 +2085,23 @@ out:
     return handled;
 }
 
+static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
+{
+    size_t recv_length;
+
+    ucs_trace_func("ep=%p", ep);
+
+    if (ucs_unlikely(uct_tcp_ep_am_rx_prepare(ep, &recv_length) != UCS_OK)) {
+        return 0;
+    }
+
+    if (!uct_tcp_ep_recv(ep, recv_length)) {
+        return 0;
+    }
+
+    return uct_tcp_ep_am_rx_parse(ep);
+}
+
 static inline ucs_status_t
 uct_tcp_ep_am_prepare(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
                       uint8_t am_id, uct_tcp_am_hdr_t **hdr)
@@ -1576,6 +2133,23 @@ err_no_res:
     return UCS_ERR_NO_RESOURCE;
 }
 
+static unsigned uct_tcp_ep_put_rx_complete(uct_tcp_ep_t *ep,
+                                           ucs_status_t status,
+                                           size_t recv_length)
+{
+    if (ucs_unlikely(status != UCS_OK)) {
+        uct_tcp_ep_handle_recv_err(ep, status);
+        return 0;
+    }
+
+    ucs_assertv(recv_length, "ep=%p", ep);
+
+    uct_tcp_ep_put_rx_advance(ep, (uct_tcp_ep_put_req_hdr_t*)ep->rx.buf,
+                              recv_length);
+
+    return 1;
+}
+
 static unsigned uct_tcp_ep_progress_put_rx(uct_tcp_ep_t *ep)
 {
     uct_tcp_ep_put_req_hdr_t *put_req;
@@ -1586,15 +2160,11 @@ static unsigned uct_tcp_ep_progress_put_rx(uct_tcp_ep_t *ep)
     recv_length = put_req->length;
     status      = ucs_socket_recv_nb(ep->fd, (void*)(uintptr_t)put_req->addr,
                                      &recv_length);
-    if (ucs_unlikely(status != UCS_OK)) {
-        uct_tcp_ep_handle_recv_err(ep, status);
+    if (!uct_tcp_ep_put_rx_complete(ep, status, recv_length)) {
         return 0;
     }
 
-    ucs_assertv(recv_length, "ep=%p", ep);
-
-    uct_tcp_ep_put_rx_advance(ep, put_req, recv_length);
-
+    uct_tcp_ep_am_rx_desc_progress(ep);
     return 1;
 }
 
@@ -1609,6 +2179,168 @@ static unsigned uct_tcp_ep_progress_data_rx(void *arg)
     }
 }
 
+/* Returns the buffer where the next received data of the EP has to be placed,
+ * or NULL if the EP does not receive data now */
+void *uct_tcp_ep_rx_uring_buf(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_put_req_hdr_t *put_req;
+
+    if ((uct_tcp_ep_cm_state[ep->conn_state].rx_progress !=
+         uct_tcp_ep_progress_data_rx) ||
+        (ep->rx.buf == NULL)) {
+        return NULL;
+    }
+
+    if (ep->flags & UCT_TCP_EP_FLAG_PUT_RX) {
+        put_req = (uct_tcp_ep_put_req_hdr_t*)ep->rx.buf;
+        return (void*)(uintptr_t)put_req->addr;
+    }
+
+    return UCS_PTR_BYTE_OFFSET(ep->rx.buf, ep->rx.length);
+}
+
+int uct_tcp_ep_post_rx_uring(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_put_req_hdr_t *put_req;
+    size_t recv_length;
+
+    if ((uct_tcp_ep_cm_state[ep->conn_state].rx_progress !=
+         uct_tcp_ep_progress_data_rx) ||
+        (ep->flags & UCT_TCP_EP_FLAG_RX_URING) ||
+        uct_tcp_uring_is_full(&iface->uring)) {
+        return 0;
+    }
+
+    if (ep->flags & UCT_TCP_EP_FLAG_PUT_RX) {
+        put_req     = (uct_tcp_ep_put_req_hdr_t*)ep->rx.buf;
+        recv_length = put_req->length;
+    } else if (ucs_unlikely(uct_tcp_ep_am_rx_prepare(ep, &recv_length) !=
+                            UCS_OK)) {
+        /* Nothing to receive to, but the event was handled */
+        return 1;
+    } else if (recv_length == 0) {
+        return 0;
+    }
+
+    uct_tcp_uring_post_recv(&iface->uring, ep, uct_tcp_ep_rx_uring_buf(ep),
+                            recv_length);
+    return 1;
+}
+
+unsigned uct_tcp_ep_rx_uring_complete(uct_tcp_ep_t *ep, size_t recv_length)
+{
+    if (ep->flags & UCT_TCP_EP_FLAG_PUT_RX) {
+        return uct_tcp_ep_put_rx_complete(ep, UCS_OK, recv_length);
+    }
+
+    uct_tcp_ep_recv_complete(ep, UCS_OK, recv_length);
+    return 0;
+}
+
+unsigned uct_tcp_ep_progress_rx_uring(uct_tcp_ep_t *ep, int result)
+{
+    ucs_status_t status;
+
+    if (ucs_unlikely(result <= 0)) {
+        status = ucs_socket_handle_io_error(ep->fd, "recv", result, -result);
+        uct_tcp_ep_handle_recv_err(ep, status);
+        return 0;
+    }
+
+    if (ep->flags & UCT_TCP_EP_FLAG_PUT_RX) {
+        /* The data was placed by uct_tcp_ep_rx_uring_complete(), and the
+         * large AM is passed to the user only here, since the user's callback
+         * could destroy the other EPs */
+        return uct_tcp_ep_am_rx_desc_progress(ep);
+    }
+
+    return uct_tcp_ep_am_rx_parse(ep);
+}
+
+#ifdef UCT_TCP_MSG_ZEROCOPY
+static unsigned
+uct_tcp_ep_msg_zcopy_notified(uct_tcp_ep_t *ep,
+                              const struct sock_extended_err *serr)
+{
+    /* The notification reports the range of completed sends, and TCP
+     * completes the sends in order */
+    uint32_t comp_sn = serr->ee_data + 1;
+
+    ucs_trace("tcp_ep %p: MSG_ZEROCOPY sends [%u..%u] completed%s", ep,
+              serr->ee_info, serr->ee_data,
+              (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) ?
+              ", the data was copied" : "");
+
+    if (!UCS_CIRCULAR_COMPARE32(comp_sn, >, ep->msg_zcopy.comp_sn)) {
+        /* The sends were purged */
+        return 0;
+    }
+
+    ucs_assertv(UCS_CIRCULAR_COMPARE32(serr->ee_info, <=,
+                                       ep->msg_zcopy.comp_sn),
+                "ep=%p first_sn=%u comp_sn=%u", ep, serr->ee_info,
+                ep->msg_zcopy.comp_sn);
+
+    uct_tcp_ep_msg_zcopy_set_comp_sn(ep, comp_sn);
+    uct_tcp_ep_msg_zcopy_dispatch(ep, UCS_OK);
+    return 1;
+}
+#endif
+
+unsigned uct_tcp_ep_progress_msg_zcopy(uct_tcp_ep_t *ep)
+{
+    unsigned count = 0;
+#ifdef UCT_TCP_MSG_ZEROCOPY
+    char control[CMSG_SPACE(sizeof(struct sock_extended_err))];
+    struct sock_extended_err *serr;
+    struct cmsghdr *cmsg;
+    struct msghdr msg;
+    ssize_t ret;
+
+    for (;;) {
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control    = control;
+        msg.msg_controllen = sizeof(control);
+
+        ret = recvmsg(ep->fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+        if (ret < 0) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK) &&
+                (errno != EINTR)) {
+                ucs_debug("tcp_ep %p: recvmsg(fd=%d, MSG_ERRQUEUE) failed: %m",
+                          ep, ep->fd);
+            }
+            break;
+        }
+
+        cmsg = CMSG_FIRSTHDR(&msg);
+        if ((cmsg == NULL) ||
+            !(((cmsg->cmsg_level == SOL_IP) &&
+               (cmsg->cmsg_type == IP_RECVERR)) ||
+              ((cmsg->cmsg_level == SOL_IPV6) &&
+               (cmsg->cmsg_type == IPV6_RECVERR)))) {
+            ucs_debug("tcp_ep %p: unexpected message on error queue of fd %d",
+                      ep, ep->fd);
+            continue;
+        }
+
+        serr = (struct sock_extended_err*)CMSG_DATA(cmsg);
+        if ((serr->ee_errno != 0) ||
+            (serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY)) {
+            ucs_debug("tcp_ep %p: unexpected error on fd %d: errno %u "
+                      "origin %u", ep, ep->fd, serr->ee_errno,
+                      serr->ee_origin);
+            continue;
+        }
+
+        count += uct_tcp_ep_msg_zcopy_notified(ep, serr);
+    }
+#endif
+
+    return count;
+}
+
 static unsigned uct_tcp_ep_progress_magic_number_rx(void *arg)
 {
     uct_tcp_ep_t *ep       = (uct_tcp_ep_t*)arg;
@@ -1712,6 +2444,61 @@ uct_tcp_ep_am_send(uct_tcp_ep_t *ep, const uct_tcp_am_hdr_t *hdr)
     return UCS_OK;
 }
 
+/* Prepare the TX buffer for short and bcopy AMs, which are appended to the
+ * aggregated AMs if the EP is corked */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+uct_tcp_ep_am_prepare_copy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
+                           uint8_t am_id, uct_tcp_am_hdr_t **hdr)
+{
+    if (ucs_likely(!(ep->flags & UCT_TCP_EP_FLAG_CORKED) ||
+                   (ep->flags & UCT_TCP_EP_FLAG_FENCE_STRIPES) ||
+                   (ep->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED))) {
+        return uct_tcp_ep_am_prepare(iface, ep, am_id, hdr);
+    }
+
+    ucs_assertv((ep->tx.offset == 0) &&
+                (ep->tx.length < iface->config.cork_bytes) &&
+                !(ep->flags & UCT_TCP_EP_FLAG_ZCOPY_TX), "ep=%p", ep);
+
+    *hdr          = UCS_PTR_BYTE_OFFSET(ep->tx.buf, ep->tx.length);
+    (*hdr)->am_id = am_id;
+    return UCS_OK;
+}
+
+/* Send the AM prepared by uct_tcp_ep_am_prepare_copy(), or keep it in the TX
+ * buffer to be sent with the next AMs if the aggregation is enabled */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+uct_tcp_ep_am_send_copy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
+                        const uct_tcp_am_hdr_t *hdr)
+{
+    size_t length;
+
+    if (ucs_likely(iface->config.cork_bytes == 0)) {
+        return uct_tcp_ep_am_send(ep, hdr);
+    }
+
+    length              = sizeof(*hdr) + hdr->length;
+    ep->tx.length      += length;
+    iface->outstanding += length;
+
+    uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, hdr->am_id,
+                       hdr + 1, hdr->length, "SEND: ep %p fd %d aggregated "
+                       "%zu bytes", ep, ep->fd, ep->tx.length);
+
+    if (ep->tx.length >= iface->config.cork_bytes) {
+        return uct_tcp_ep_cork_flush(ep);
+    }
+
+    ep->flags |= UCT_TCP_EP_FLAG_CORKED;
+    if (!(ep->flags & UCT_TCP_EP_FLAG_CORK_PROGRESS)) {
+        ep->flags |= UCT_TCP_EP_FLAG_CORK_PROGRESS;
+        ucs_callbackq_add_oneshot(&iface->super.worker->super.progress_q, ep,
+                                  uct_tcp_ep_progress_cork, ep);
+    }
+
+    return UCS_OK;
+}
+
 static const void*
 uct_tcp_ep_am_sendv_get_trace_payload(uct_tcp_am_hdr_t *hdr,
                                       const void *header,
@@ -1732,7 +2519,7 @@ uct_tcp_ep_am_sendv_get_trace_payload(uct_tcp_am_hdr_t *hdr,
 static inline ucs_status_t
 uct_tcp_ep_am_sendv(uct_tcp_ep_t *ep, int short_sendv, uct_tcp_am_hdr_t *hdr,
                     size_t send_limit, const void *header,
-                    struct iovec *iov, size_t iov_cnt)
+                    struct iovec *iov, size_t iov_cnt, size_t copy_iov_cnt)
 {
     uct_tcp_iface_t UCS_V_UNUSED *iface = ucs_derived_of(ep->super.super.iface,
                                                          uct_tcp_iface_t);
@@ -1744,7 +2531,8 @@ uct_tcp_ep_am_sendv(uct_tcp_ep_t *ep, int short_sendv, uct_tcp_am_hdr_t *hdr,
     ucs_assertv((ep->tx.length <= send_limit) &&
                 (iov_cnt > 0), "ep=%p", ep);
 
-    status = ucs_socket_sendv_nb(ep->fd, iov, iov_cnt, &sent_length);
+    status = uct_tcp_ep_sendv_iov(ep, iov, iov_cnt, copy_iov_cnt,
+                                  &sent_length);
     if (ucs_unlikely((status != UCS_OK) && (status != UCS_ERR_NO_PROGRESS))) {
         return uct_tcp_ep_handle_send_err(ep, status);
     }
@@ -1782,6 +2570,13 @@ static void uct_tcp_ep_post_put_ack(uct_tcp_ep_t *ep)
     uct_tcp_ep_put_ack_hdr_t *put_ack;
     ucs_status_t status;
 
+    if (!ucs_queue_is_empty(&ep->get_resp_q)) {
+        /* PUT ACK mustn't overtake the GET responses, since the peer
+         * completes the GET operations sent before the PUT upon the ACK */
+        ep->flags |= UCT_TCP_EP_FLAG_PUT_RX_SENDING_ACK;
+        return;
+    }
+
     /* Make sure that we are sending nothing through this EP at the moment.
      * This check is needed to avoid mixing AM/PUT data sent from this EP
      * and this PUT ACK message */
@@ -1819,7 +2614,7 @@ uct_tcp_ep_am_short_sendv(uct_tcp_ep_t *ep, uct_tcp_iface_t *iface,
     size_t offset;
 
     status = uct_tcp_ep_am_sendv(ep, 1, hdr, iface->config.tx_seg_size, &header, iov,
-                                 iov_cnt);
+                                 iov_cnt, iov_cnt);
     if (ucs_unlikely(status != UCS_OK)) {
         return status;
     }
@@ -1852,7 +2647,7 @@ ucs_status_t uct_tcp_ep_am_short(uct_ep_h uct_ep, uint8_t am_id, uint64_t header
                      "am_short");
     UCT_CHECK_AM_ID(am_id);
 
-    status = uct_tcp_ep_am_prepare(iface, ep, am_id, &hdr);
+    status = uct_tcp_ep_am_prepare_copy(iface, ep, am_id, &hdr);
     if (status != UCS_OK) {
         return status;
     }
@@ -1863,10 +2658,11 @@ ucs_status_t uct_tcp_ep_am_short(uct_ep_h uct_ep, uint8_t am_id, uint64_t header
      * can be released inside `uct_tcp_ep_am_send` call */
     hdr->length = payload_length = length + sizeof(header);
 
-    if (length <= iface->config.sendv_thresh) {
+    if ((length <= iface->config.sendv_thresh) ||
+        (iface->config.cork_bytes != 0)) {
         uct_am_short_fill_data(hdr + 1, header, payload, length,
                                UCS_ARCH_MEMCPY_NT_NONE);
-        status = uct_tcp_ep_am_send(ep, hdr);
+        status = uct_tcp_ep_am_send_copy(iface, ep, hdr);
     } else {
         iov[0].iov_base = hdr;
         iov[0].iov_len  = sizeof(*hdr);
@@ -1943,7 +2739,7 @@ ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
 
     UCT_CHECK_AM_ID(am_id);
 
-    status = uct_tcp_ep_am_prepare(iface, ep, am_id, &hdr);
+    status = uct_tcp_ep_am_prepare_copy(iface, ep, am_id, &hdr);
     if (status != UCS_OK) {
         return status;
     }
@@ -1954,7 +2750,7 @@ ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
      * can be released inside `uct_tcp_ep_am_send` call */
     hdr->length = payload_length = pack_cb(hdr + 1, arg);
 
-    status = uct_tcp_ep_am_send(ep, hdr);
+    status = uct_tcp_ep_am_send_copy(iface, ep, hdr);
     if (ucs_unlikely(status != UCS_OK)) {
         return status;
     }
@@ -1967,12 +2763,13 @@ ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
 static inline ucs_status_t
 uct_tcp_ep_prepare_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep, uint8_t am_id,
                          const void *header, unsigned header_length,
-                         const uct_iov_t *iov, size_t iovcnt, const char *name,
-                         size_t *zcopy_payload_p, uct_tcp_ep_zcopy_tx_t **ctx_p)
+                         const uct_iov_t *iov, size_t iovcnt,
+                         ucs_iov_iter_t *uct_iov_iter, size_t max_length,
+                         const char *name, size_t *zcopy_payload_p,
+                         uct_tcp_ep_zcopy_tx_t **ctx_p)
 {
     uct_tcp_am_hdr_t *hdr = NULL;
     size_t io_vec_cnt;
-    ucs_iov_iter_t uct_iov_iter;
     uct_tcp_ep_zcopy_tx_t *ctx;
     ucs_status_t status;
 
@@ -2002,13 +2799,20 @@ uct_tcp_ep_prepare_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep, uint8_t am_id
         ctx->iov_cnt++;
     }
 
-    /* User-defined payload */
-    ucs_iov_iter_init(&uct_iov_iter);
+    /* User-defined payload, starting from the position of the iterator */
     io_vec_cnt       = iovcnt;
     *zcopy_payload_p = uct_iov_to_iovec(&ctx->iov[ctx->iov_cnt], &io_vec_cnt,
-                                        iov, iovcnt, SIZE_MAX, &uct_iov_iter);
+                                        iov, iovcnt, max_length, uct_iov_iter);
     *ctx_p           = ctx;
-    ctx->iov_cnt    += io_vec_cnt;
+
+    /* Send the headers by copy, and the payload with MSG_ZEROCOPY if it is
+     * large enough */
+    ctx->copy_iov_cnt = ctx->iov_cnt;
+    ctx->iov_cnt     += io_vec_cnt;
+    if ((*zcopy_payload_p == 0) ||
+        (*zcopy_payload_p < iface->config.zcopy.msg_thresh)) {
+        ctx->copy_iov_cnt = ctx->iov_cnt;
+    }
 
     return UCS_OK;
 }
@@ -2022,6 +2826,7 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
     uct_tcp_iface_t *iface     = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
     uct_tcp_ep_zcopy_tx_t *ctx = NULL;
     size_t payload_length      = 0;
+    ucs_iov_iter_t iov_iter;
     ucs_status_t status;
 
     UCT_CHECK_LENGTH(header_length + uct_iov_total_length(iov, iovcnt), 0,
@@ -2029,9 +2834,10 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
                      "am_zcopy");
     UCT_CHECK_AM_ID(am_id);
 
+    ucs_iov_iter_init(&iov_iter);
     status = uct_tcp_ep_prepare_zcopy(iface, ep, am_id, header, header_length,
-                                      iov, iovcnt, "am_zcopy", &payload_length,
-                                      &ctx);
+                                      iov, iovcnt, &iov_iter, SIZE_MAX,
+                                      "am_zcopy", &payload_length, &ctx);
     if (ucs_unlikely(status != UCS_OK)) {
         return status;
     }
@@ -2039,7 +2845,8 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
     ctx->super.length = payload_length + header_length;
 
     status = uct_tcp_ep_am_sendv(ep, 0, &ctx->super, iface->config.rx_seg_size,
-                                 header, ctx->iov, ctx->iov_cnt);
+                                 header, ctx->iov, ctx->iov_cnt,
+                                 ctx->copy_iov_cnt);
     if (ucs_unlikely(status != UCS_OK)) {
         return status;
     }
@@ -2052,7 +2859,9 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
         return UCS_INPROGRESS;
     }
 
-    return UCS_OK;
+    /* Complete in order with the previous operations, which may wait for
+     * MSG_ZEROCOPY notifications */
+    return uct_tcp_ep_msg_zcopy_comp_add(ep, comp);
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -2080,24 +2889,44 @@ uct_tcp_ep_put_comp_add(uct_tcp_ep_t *ep, uct_completion_t *comp, int wait_sn)
     return UCS_OK;
 }
 
-ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
-                                  size_t iovcnt, uint64_t remote_addr,
-                                  uct_rkey_t rkey, uct_completion_t *comp)
+/* Account the sent PUT or GET request, which is acknowledged by the peer */
+static UCS_F_ALWAYS_INLINE void
+uct_tcp_ep_put_sn_advance(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep)
+{
+    ep->tx.put_sn++;
+    /* PUT ACK confirms that all the data sent before was delivered, so no
+     * need to send a PUT operation from flush */
+    ep->flags &= ~UCT_TCP_EP_FLAG_NEED_FLUSH;
+
+    if (!(ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK)) {
+        /* Add UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK flag and increment iface
+         * outstanding operations counter in order to ensure returning
+         * UCS_INPROGRESS from flush functions and do progressing.
+         * UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK flag has to be removed upon PUT
+         * ACK message receiving if there are no other PUT operations in-flight */
+        ep->flags |= UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK;
+        uct_tcp_iface_outstanding_inc(iface);
+    }
+}
+
+/* Send the part of the IOVs from the position of the iterator, which is at
+ * most max_length bytes long, to remote_addr */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+uct_tcp_ep_put_zcopy_common(uct_tcp_ep_t *ep, const uct_iov_t *iov,
+                            size_t iovcnt, ucs_iov_iter_t *iov_iter,
+                            size_t max_length, uint64_t remote_addr,
+                            uct_completion_t *comp)
 {
-    uct_tcp_ep_t *ep                 = ucs_derived_of(uct_ep, uct_tcp_ep_t);
-    uct_tcp_iface_t *iface           = ucs_derived_of(uct_ep->iface,
+    uct_tcp_iface_t *iface           = ucs_derived_of(ep->super.super.iface,
                                                       uct_tcp_iface_t);
     uct_tcp_ep_zcopy_tx_t *ctx       = NULL;
     uct_tcp_ep_put_req_hdr_t put_req = {0}; /* Suppress Cppcheck false-positive */
     ucs_status_t status;
 
-    UCT_CHECK_LENGTH(sizeof(put_req) + uct_iov_total_length(iov, iovcnt), 0,
-                     UCT_TCP_EP_PUT_ZCOPY_MAX - sizeof(uct_tcp_am_hdr_t),
-                     "put_zcopy");
-
     status = uct_tcp_ep_prepare_zcopy(iface, ep, UCT_TCP_EP_PUT_REQ_AM_ID,
                                       &put_req, sizeof(put_req),
-                                      iov, iovcnt, "put_zcopy",
+                                      iov, iovcnt, iov_iter, max_length,
+                                      "put_zcopy",
                                       /* Set a payload length directly to the
                                        * TX length, since PUT Zcopy doesn't
                                        * set the payload length to TCP AM hdr */
@@ -2112,23 +2941,13 @@ ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
     put_req.sn        = ep->tx.put_sn + 1;
 
     status = uct_tcp_ep_am_sendv(ep, 0, &ctx->super, UCT_TCP_EP_PUT_ZCOPY_MAX,
-                                 &put_req, ctx->iov, ctx->iov_cnt);
+                                 &put_req, ctx->iov, ctx->iov_cnt,
+                                 ctx->copy_iov_cnt);
     if (ucs_unlikely(status != UCS_OK)) {
         return status;
     }
 
-    ep->tx.put_sn++;
-
-    if (!(ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK)) {
-        /* Add UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK flag and increment iface
-         * outstanding operations counter in order to ensure returning
-         * UCS_INPROGRESS from flush functions and do progressing.
-         * UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK flag has to be removed upon PUT
-         * ACK message receiving if there are no other PUT operations in-flight */
-        ep->flags |= UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK;
-        uct_tcp_iface_outstanding_inc(iface);
-    }
-
+    uct_tcp_ep_put_sn_advance(iface, ep);
     UCT_TL_EP_STAT_OP(&ep->super, PUT, ZCOPY, put_req.length);
 
     status = uct_tcp_ep_put_comp_add(ep, comp, put_req.sn);
@@ -2144,6 +2963,330 @@ ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
     return UCS_INPROGRESS;
 }
 
+static int uct_tcp_ep_stripe_is_ready(uct_tcp_ep_t *stripe)
+{
+    return (stripe->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
+           uct_tcp_ep_ctx_buf_empty(&stripe->tx);
+}
+
+static void uct_tcp_ep_stripe_comp_cb(uct_completion_t *self)
+{
+    uct_tcp_ep_stripe_completion_t *stripe_comp =
+            ucs_derived_of(self, uct_tcp_ep_stripe_completion_t);
+
+    uct_invoke_completion(stripe_comp->comp, self->status);
+    ucs_mpool_put_inline(stripe_comp);
+}
+
+/* Get a completion which is passed to all parts of an operation done over
+ * the EP and its stripe EPs, the number of the parts is set when all of them
+ * are started */
+static ucs_status_t
+uct_tcp_ep_stripe_comp_get(uct_tcp_ep_t *ep, uct_completion_t *comp,
+                           uct_tcp_ep_stripe_completion_t **stripe_comp_p)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_stripe_completion_t *stripe_comp;
+
+    if (comp == NULL) {
+        *stripe_comp_p = NULL;
+        return UCS_OK;
+    }
+
+    stripe_comp = ucs_mpool_get_inline(&iface->tx_mpool);
+    if (ucs_unlikely(stripe_comp == NULL)) {
+        ucs_error("tcp_ep %p: unable to allocate stripe completion from mpool",
+                  ep);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    stripe_comp->super.func   = uct_tcp_ep_stripe_comp_cb;
+    stripe_comp->super.count  = 1;
+    stripe_comp->super.status = UCS_OK;
+    stripe_comp->comp         = comp;
+    *stripe_comp_p            = stripe_comp;
+    return UCS_OK;
+}
+
+static UCS_F_ALWAYS_INLINE uct_completion_t *
+uct_tcp_ep_stripe_comp_super(uct_tcp_ep_stripe_completion_t *stripe_comp)
+{
+    return (stripe_comp != NULL) ? &stripe_comp->super : NULL;
+}
+
+/* Complete the user's completion when the started parts are completed, or
+ * release the completion if no part was started */
+static ucs_status_t
+uct_tcp_ep_stripe_comp_started(uct_tcp_ep_stripe_completion_t *stripe_comp,
+                               unsigned count, ucs_status_t status)
+{
+    ucs_assert(status != UCS_INPROGRESS);
+
+    if (count == 0) {
+        if (stripe_comp != NULL) {
+            ucs_mpool_put_inline(stripe_comp);
+        }
+        return status;
+    }
+
+    if (stripe_comp != NULL) {
+        uct_completion_update_status(&stripe_comp->super, status);
+        stripe_comp->super.count = count;
+    }
+
+    return UCS_INPROGRESS;
+}
+
+/* Split PUT operation to parts which are sent to the consecutive remote
+ * addresses over the EP and its stripe EPs, which are ready to send. Every
+ * part is acknowledged on its connection, so the completion is invoked when
+ * all parts are delivered. */
+static ucs_status_t
+uct_tcp_ep_put_zcopy_striped(uct_tcp_ep_t *ep, const uct_iov_t *iov,
+                             size_t iovcnt, size_t length,
+                             uint64_t remote_addr, uct_completion_t *comp)
+{
+    unsigned count = 1;
+    uct_tcp_ep_stripe_completion_t *stripe_comp;
+    uct_completion_t *part_comp;
+    size_t offset, chunk_length;
+    ucs_iov_iter_t iov_iter;
+    uct_tcp_ep_t *stripe;
+    ucs_status_t status;
+
+    ucs_iov_iter_init(&iov_iter);
+
+    if (!(ep->flags & UCT_TCP_EP_FLAG_FENCE_PRIMARY)) {
+        ucs_list_for_each(stripe, &ep->stripe.list, list) {
+            count += uct_tcp_ep_stripe_is_ready(stripe);
+        }
+    }
+
+    if (count == 1) {
+        return uct_tcp_ep_put_zcopy_common(ep, iov, iovcnt, &iov_iter,
+                                           SIZE_MAX, remote_addr, comp);
+    }
+
+    status = uct_tcp_ep_stripe_comp_get(ep, comp, &stripe_comp);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return status;
+    }
+
+    part_comp    = uct_tcp_ep_stripe_comp_super(stripe_comp);
+    chunk_length = ucs_div_round_up(length, count);
+    status       = uct_tcp_ep_put_zcopy_common(ep, iov, iovcnt, &iov_iter,
+                                               chunk_length, remote_addr,
+                                               part_comp);
+    if (status != UCS_INPROGRESS) {
+        /* No resources to send the first part */
+        return uct_tcp_ep_stripe_comp_started(stripe_comp, 0, status);
+    }
+
+    count  = 1;
+    offset = chunk_length;
+    ucs_list_for_each(stripe, &ep->stripe.list, list) {
+        if (offset >= length) {
+            break;
+        }
+
+        if (!uct_tcp_ep_stripe_is_ready(stripe)) {
+            continue;
+        }
+
+        status = uct_tcp_ep_put_zcopy_common(stripe, iov, iovcnt, &iov_iter,
+                                             chunk_length,
+                                             remote_addr + offset, part_comp);
+        if (ucs_unlikely(status != UCS_INPROGRESS)) {
+            ucs_assert(UCS_STATUS_IS_ERR(status));
+            break;
+        }
+
+        ++count;
+        offset += chunk_length;
+    }
+
+    return uct_tcp_ep_stripe_comp_started(stripe_comp, count,
+                                          (offset >= length) ? UCS_OK :
+                                                               status);
+}
+
+ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep       = ucs_derived_of(uct_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
+    size_t length          = uct_iov_total_length(iov, iovcnt);
+    ucs_iov_iter_t iov_iter;
+
+    UCT_CHECK_LENGTH(sizeof(uct_tcp_ep_put_req_hdr_t) + length, 0,
+                     UCT_TCP_EP_PUT_ZCOPY_MAX - sizeof(uct_tcp_am_hdr_t),
+                     "put_zcopy");
+
+    if (ucs_unlikely(!ucs_list_is_empty(&ep->stripe.list)) &&
+        (length >= iface->config.stripe.thresh)) {
+        return uct_tcp_ep_put_zcopy_striped(ep, iov, iovcnt, length,
+                                            remote_addr, comp);
+    }
+
+    ucs_iov_iter_init(&iov_iter);
+    return uct_tcp_ep_put_zcopy_common(ep, iov, iovcnt, &iov_iter, SIZE_MAX,
+                                       remote_addr, comp);
+}
+
+ucs_status_t uct_tcp_ep_get_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep       = ucs_derived_of(uct_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
+    size_t length          = uct_iov_total_length(iov, iovcnt);
+    uct_tcp_am_hdr_t *hdr  = NULL;
+    uct_tcp_ep_get_req_hdr_t *get_req;
+    ucs_status_t status;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, 1ul, "get_zcopy");
+    UCT_CHECK_LENGTH(sizeof(uct_tcp_ep_put_req_hdr_t) + length, 0,
+                     UCT_TCP_EP_PUT_ZCOPY_MAX - sizeof(uct_tcp_am_hdr_t),
+                     "get_zcopy");
+
+    status = uct_tcp_ep_am_prepare(iface, ep, UCT_TCP_EP_GET_REQ_AM_ID, &hdr);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return status;
+    }
+
+    ucs_assertv(hdr != NULL, "ep=%p", ep);
+    hdr->length        = sizeof(*get_req);
+    get_req            = (uct_tcp_ep_get_req_hdr_t*)(hdr + 1);
+    get_req->addr      = remote_addr;
+    get_req->length    = length;
+    get_req->resp_addr = (uintptr_t)((iovcnt > 0) ? iov[0].buffer : NULL);
+    get_req->sn        = ep->tx.put_sn + 1;
+
+    status = uct_tcp_ep_am_send(ep, hdr);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return status;
+    }
+
+    /* The response is sent after all data sent before the request is
+     * handled by the peer, so it completes the GET operation and the
+     * preceding operations as PUT ACK */
+    uct_tcp_ep_put_sn_advance(iface, ep);
+    UCT_TL_EP_STAT_OP(&ep->super, GET, ZCOPY, length);
+
+    status = uct_tcp_ep_put_comp_add(ep, comp, ep->tx.put_sn);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return status;
+    }
+
+    return UCS_INPROGRESS;
+}
+
+/* Send the data requested by the peer from the local memory, the response
+ * is received by the peer to the buffer passed to GET Zcopy */
+static ucs_status_t
+uct_tcp_ep_send_get_resp(uct_tcp_ep_t *ep,
+                         const uct_tcp_ep_get_req_hdr_t *get_req)
+{
+    uct_tcp_iface_t *iface            = ucs_derived_of(ep->super.super.iface,
+                                                       uct_tcp_iface_t);
+    uct_tcp_ep_zcopy_tx_t *ctx        = NULL;
+    uct_tcp_ep_put_req_hdr_t get_resp = {0};
+    ucs_iov_iter_t iov_iter;
+    ucs_status_t status;
+    uct_iov_t iov;
+
+    iov.buffer = (void*)(uintptr_t)get_req->addr;
+    iov.length = get_req->length;
+    iov.memh   = UCT_MEM_HANDLE_NULL;
+    iov.stride = 0;
+    iov.count  = 1;
+
+    ucs_iov_iter_init(&iov_iter);
+    status = uct_tcp_ep_prepare_zcopy(iface, ep, UCT_TCP_EP_GET_RESP_AM_ID,
+                                      &get_resp, sizeof(get_resp), &iov, 1,
+                                      &iov_iter, SIZE_MAX, "get_resp",
+                                      &ep->tx.length, &ctx);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return status;
+    }
+
+    ctx->super.length = sizeof(get_resp);
+    get_resp.addr     = get_req->resp_addr;
+    get_resp.length   = ep->tx.length;
+    get_resp.sn       = get_req->sn;
+
+    status = uct_tcp_ep_am_sendv(ep, 0, &ctx->super, UCT_TCP_EP_PUT_ZCOPY_MAX,
+                                 &get_resp, ctx->iov, ctx->iov_cnt,
+                                 ctx->copy_iov_cnt);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return status;
+    }
+
+    if (uct_tcp_ep_ctx_buf_need_progress(&ep->tx)) {
+        uct_tcp_ep_set_outstanding_zcopy(iface, ep, ctx, &get_resp,
+                                         sizeof(get_resp), NULL);
+    }
+
+    return UCS_OK;
+}
+
+static void uct_tcp_ep_post_get_resp(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_get_resp_t *get_resp;
+    ucs_status_t status;
+
+    while (!ucs_queue_is_empty(&ep->get_resp_q)) {
+        get_resp = ucs_queue_head_elem_non_empty(&ep->get_resp_q,
+                                                 uct_tcp_ep_get_resp_t, elem);
+        status   = uct_tcp_ep_send_get_resp(ep, &get_resp->get_req);
+        if (status != UCS_OK) {
+            /* The request is released when the failed EP is purged */
+            if (status != UCS_ERR_NO_RESOURCE) {
+                ucs_error("tcp_ep %p: failed to send GET response: %s", ep,
+                          ucs_status_string(status));
+            }
+            return;
+        }
+
+        ucs_queue_pull_non_empty(&ep->get_resp_q);
+        ucs_mpool_put_inline(get_resp);
+    }
+}
+
+static void
+uct_tcp_ep_handle_get_req(uct_tcp_ep_t *ep,
+                          const uct_tcp_ep_get_req_hdr_t *get_req)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_get_resp_t *get_resp;
+    ucs_status_t status;
+
+    if (ucs_queue_is_empty(&ep->get_resp_q)) {
+        status = uct_tcp_ep_send_get_resp(ep, get_req);
+        if (status != UCS_ERR_NO_RESOURCE) {
+            if (status != UCS_OK) {
+                ucs_error("tcp_ep %p: failed to send GET response: %s", ep,
+                          ucs_status_string(status));
+            }
+            return;
+        }
+    }
+
+    /* Keep the request to send the response from TX progress, in order with
+     * the other requests */
+    get_resp = ucs_mpool_get_inline(&iface->tx_mpool);
+    if (ucs_unlikely(get_resp == NULL)) {
+        ucs_error("tcp_ep %p: unable to allocate GET response from mpool", ep);
+        return;
+    }
+
+    get_resp->get_req = *get_req;
+    ucs_queue_push(&ep->get_resp_q, &get_resp->elem);
+}
+
 ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req,
                                     unsigned flags)
 {
@@ -2185,10 +3328,11 @@ void uct_tcp_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
                             uct_tcp_ep_pending_purge_cb, &purge_arg);
 }
 
-ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
-                              uct_completion_t *comp)
+static ucs_status_t
+uct_tcp_ep_flush_common(uct_tcp_ep_t *ep, unsigned flags,
+                        uct_completion_t *comp)
 {
-    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    ucs_iov_iter_t iov_iter;
     ucs_status_t status;
 
     if (ucs_unlikely(flags & UCT_FLUSH_FLAG_CANCEL)) {
@@ -2202,14 +3346,15 @@ ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
     }
 
     if (ep->flags & UCT_TCP_EP_FLAG_NEED_FLUSH) {
-        status = uct_tcp_ep_put_zcopy(&ep->super.super, NULL, 0, 0, 0,
-                                      NULL);
+        ucs_iov_iter_init(&iov_iter);
+        status = uct_tcp_ep_put_zcopy_common(ep, NULL, 0, &iov_iter, SIZE_MAX,
+                                             0, NULL);
         ucs_assert(status != UCS_ERR_NO_RESOURCE);
         if (ucs_unlikely(UCS_STATUS_IS_ERR(status))) {
             return status;
         }
 
-        ep->flags &= ~UCT_TCP_EP_FLAG_NEED_FLUSH;
+        ucs_assert(!(ep->flags & UCT_TCP_EP_FLAG_NEED_FLUSH));
         ucs_assert(ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK);
     }
 
@@ -2223,10 +3368,103 @@ ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
         return UCS_INPROGRESS;
     }
 
+    status = uct_tcp_ep_msg_zcopy_comp_add(ep, comp);
+    if (status != UCS_OK) {
+        if (status == UCS_INPROGRESS) {
+            UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
+        }
+        return status;
+    }
+
     UCT_TL_EP_STAT_FLUSH(&ep->super);
     return UCS_OK;
 }
 
+/* Stripe EPs send only PUT operations, so they are flushed by waiting for
+ * the ACK of the last PUT operation, which doesn't need TX resources */
+static ucs_status_t
+uct_tcp_ep_flush_stripe(uct_tcp_ep_t *stripe, uct_completion_t *comp)
+{
+    ucs_status_t status;
+
+    if (!(stripe->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK)) {
+        return uct_tcp_ep_msg_zcopy_comp_add(stripe, comp);
+    }
+
+    status = uct_tcp_ep_put_comp_add(stripe, comp, stripe->tx.put_sn);
+    return (status == UCS_OK) ? UCS_INPROGRESS : status;
+}
+
+ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
+                              uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_tcp_ep_stripe_completion_t *stripe_comp;
+    uct_completion_t *part_comp;
+    unsigned count;
+    uct_tcp_ep_t *stripe;
+    ucs_status_t status;
+
+    if (ucs_likely(ucs_list_is_empty(&ep->stripe.list))) {
+        return uct_tcp_ep_flush_common(ep, flags, comp);
+    }
+
+    status = uct_tcp_ep_stripe_comp_get(ep, comp, &stripe_comp);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return status;
+    }
+
+    part_comp = uct_tcp_ep_stripe_comp_super(stripe_comp);
+    status    = uct_tcp_ep_flush_common(ep, flags, part_comp);
+    if (UCS_STATUS_IS_ERR(status)) {
+        return uct_tcp_ep_stripe_comp_started(stripe_comp, 0, status);
+    }
+
+    count = (status == UCS_INPROGRESS);
+    ucs_list_for_each(stripe, &ep->stripe.list, list) {
+        if (ucs_unlikely(flags & UCT_FLUSH_FLAG_CANCEL)) {
+            uct_tcp_ep_purge(stripe, UCS_ERR_CANCELED);
+            continue;
+        }
+
+        status = uct_tcp_ep_flush_stripe(stripe, part_comp);
+        if (status == UCS_INPROGRESS) {
+            ++count;
+        } else if (ucs_unlikely(UCS_STATUS_IS_ERR(status))) {
+            break;
+        }
+    }
+
+    return uct_tcp_ep_stripe_comp_started(stripe_comp, count,
+                                          UCS_STATUS_IS_ERR(status) ?
+                                          status : UCS_OK);
+}
+
+ucs_status_t uct_tcp_ep_fence(uct_ep_h tl_ep, unsigned flags)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+
+    if (ucs_unlikely(!ucs_list_is_empty(&ep->stripe.list))) {
+        /* The operations sent before the fence over the stripe EPs may be
+         * delivered after the operations sent after the fence */
+        if (uct_tcp_ep_stripes_put_in_progress(ep)) {
+            ep->flags |= UCT_TCP_EP_FLAG_FENCE_STRIPES;
+        }
+
+        /* PUT operations after the fence mustn't be striped until the data
+         * sent before the fence over the EP was delivered */
+        if (ep->flags & (UCT_TCP_EP_FLAG_NEED_FLUSH |
+                         UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK)) {
+            ep->flags              |= UCT_TCP_EP_FLAG_FENCE_PRIMARY;
+            ep->stripe.fence_put_sn = ep->tx.put_sn +
+                                      !!(ep->flags &
+                                         UCT_TCP_EP_FLAG_NEED_FLUSH);
+        }
+    }
+
+    return uct_base_ep_fence(tl_ep, flags);
+}
+
 ucs_status_t
 uct_tcp_ep_check(uct_ep_h tl_ep, unsigned flags, uct_completion_t *comp)
 {
@@ -45,6 +45,28 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "Threshold for switching from send() to sendmsg() for short active messages",
    ucs_offsetof(uct_tcp_iface_config_t, sendv_thresh), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"CORK_BYTES", "0",
+   "Maximal total size of short and bcopy active messages which are aggregated\n"
+   "in the endpoint TX buffer and sent by a single system call. The aggregated\n"
+   "messages are sent when the size is reached, from the next progress call,\n"
+   "or before another operation is started on the endpoint.\n"
+   "0 - disable aggregation, every active message is sent immediately.",
+   ucs_offsetof(uct_tcp_iface_config_t, cork_bytes), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"RX_DESC_THRESH", "inf",
+   "Minimum payload size of an active message which is received directly to a\n"
+   "dedicated descriptor when it arrives in several parts. The descriptor is\n"
+   "passed to the user, who can keep it instead of copying the message data.",
+   ucs_offsetof(uct_tcp_iface_config_t, rx_desc_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"MSG_ZEROCOPY_THRESH", "inf",
+   "Minimum payload size of AM and PUT Zcopy operations which is sent with\n"
+   "MSG_ZEROCOPY flag, to avoid copying the data to the socket buffer. The\n"
+   "operation is completed when the kernel notifies that the data was sent.\n"
+   "\"inf\" disables zero-copy send.",
+   ucs_offsetof(uct_tcp_iface_config_t, msg_zcopy_thresh),
+   UCS_CONFIG_TYPE_MEMUNITS},
+
   {"PREFER_DEFAULT", "y",
    "Give higher priority to the default network interface on the host",
    ucs_offsetof(uct_tcp_iface_config_t, prefer_default), UCS_CONFIG_TYPE_BOOL},
@@ -53,6 +75,24 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "Enable PUT Zcopy support",
    ucs_offsetof(uct_tcp_iface_config_t, put_enable), UCS_CONFIG_TYPE_BOOL},
 
+  {"GET_ENABLE", "y",
+   "Enable GET Zcopy support. The target of the operation sends the requested\n"
+   "data from its progress.",
+   ucs_offsetof(uct_tcp_iface_config_t, get_enable), UCS_CONFIG_TYPE_BOOL},
+
+  {"STRIPES", "1",
+   "Number of connections which an endpoint opens to a peer interface. PUT\n"
+   "Zcopy operations are split to this number of parts which are sent over\n"
+   "the connections in parallel, while the other operations are always sent\n"
+   "over the first connection to keep their order.",
+   ucs_offsetof(uct_tcp_iface_config_t, stripes), UCS_CONFIG_TYPE_UINT},
+
+  {"STRIPE_THRESH", "256k",
+   "Minimum payload size of PUT Zcopy operation which is striped over the\n"
+   "connections of an endpoint",
+   ucs_offsetof(uct_tcp_iface_config_t, stripe_thresh),
+   UCS_CONFIG_TYPE_MEMUNITS},
+
   {"CONN_NB", "n",
    "Enable non-blocking connection establishment. It may improve startup "
    "time, but can lead to connection resets due to high load on TCP/IP stack",
@@ -117,6 +157,15 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    ucs_offsetof(uct_tcp_iface_config_t, ep_bind_src_addr),
                 UCS_CONFIG_TYPE_TERNARY},
 
+  {"IO_URING", "no",
+   "Receive the data of all sockets which are ready during a progress call by\n"
+   "a single io_uring system call, instead of a recv() call per socket.\n"
+   " - no  : use recv() system calls.\n"
+   " - try : use io_uring if it is supported by the kernel, otherwise fall back\n"
+   "         to recv() system calls.\n"
+   " - yes : use io_uring, fail if it is not supported by the kernel.",
+   ucs_offsetof(uct_tcp_iface_config_t, io_uring), UCS_CONFIG_TYPE_TERNARY},
+
   {NULL}
 };
 
@@ -345,6 +394,15 @@ static ucs_status_t uct_tcp_iface_query(uct_iface_h tl_iface,
             attr->cap.put.opt_zcopy_align  = 1;
             attr->cap.flags               |= UCT_IFACE_FLAG_PUT_ZCOPY;
         }
+
+        if (iface->config.get_enable) {
+            /* GET, the response is received to a contiguous buffer */
+            attr->cap.get.max_iov          = 1;
+            attr->cap.get.max_zcopy        = UCT_TCP_EP_PUT_ZCOPY_MAX -
+                                             UCT_TCP_EP_PUT_SERVICE_LENGTH;
+            attr->cap.get.opt_zcopy_align  = 1;
+            attr->cap.flags               |= UCT_IFACE_FLAG_GET_ZCOPY;
+        }
     }
 
     attr->bandwidth.dedicated = 0;
@@ -379,13 +437,26 @@ static void uct_tcp_iface_handle_events(void *callback_data,
                                         ucs_event_set_types_t events,
                                         void *arg)
 {
-    unsigned *count  = (unsigned*)arg;
-    uct_tcp_ep_t *ep = (uct_tcp_ep_t*)callback_data;
+    unsigned *count        = (unsigned*)arg;
+    uct_tcp_ep_t *ep       = (uct_tcp_ep_t*)callback_data;
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
 
     ucs_assertv(ep->conn_state != UCT_TCP_EP_CONN_STATE_CLOSED, "ep=%p", ep);
 
+    /* MSG_ZEROCOPY notifications are reported on the socket error queue.
+     * Handle them before receiving, which could destroy the EP */
+    if ((events & UCS_EVENT_SET_EVERR) &&
+        (iface->config.zcopy.msg_thresh != UCS_MEMUNITS_INF)) {
+        *count += uct_tcp_ep_progress_msg_zcopy(ep);
+    }
+
     if (events & UCS_EVENT_SET_EVREAD) {
-        *count += uct_tcp_ep_cm_state[ep->conn_state].rx_progress(ep);
+        /* The data is received by uct_tcp_uring_progress() */
+        if (!uct_tcp_uring_is_enabled(&iface->uring) ||
+            !uct_tcp_ep_post_rx_uring(ep)) {
+            *count += uct_tcp_ep_cm_state[ep->conn_state].rx_progress(ep);
+        }
     }
     if (events & UCS_EVENT_SET_EVWRITE) {
         *count += uct_tcp_ep_cm_state[ep->conn_state].tx_progress(ep);
@@ -405,6 +476,7 @@ unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
         status = ucs_event_set_wait(iface->event_set, &read_events,
                                     0, uct_tcp_iface_handle_events,
                                     (void *)&count);
+        count      += uct_tcp_uring_progress(&iface->uring);
         max_events -= read_events;
         ucs_trace_poll("iface=%p ucs_event_set_wait() returned %d: "
                        "read events=%u, total=%u",
@@ -471,6 +543,9 @@ uct_tcp_iface_connect_handler(int listen_fd, ucs_event_set_types_t events,
 ucs_status_t uct_tcp_iface_set_sockopt(uct_tcp_iface_t *iface, int fd,
                                        int set_nb)
 {
+#ifdef UCT_TCP_MSG_ZEROCOPY
+    const int enable = 1;
+#endif
     ucs_status_t status;
 
     if (set_nb) {
@@ -493,6 +568,16 @@ ucs_status_t uct_tcp_iface_set_sockopt(uct_tcp_iface_t *iface, int fd,
         return status;
     }
 
+#ifdef UCT_TCP_MSG_ZEROCOPY
+    if (iface->config.zcopy.msg_thresh != UCS_MEMUNITS_INF) {
+        status = ucs_socket_setopt(fd, SOL_SOCKET, SO_ZEROCOPY,
+                                   (const void*)&enable, sizeof(enable));
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
+#endif
+
     return ucs_tcp_base_set_syn_cnt(fd, iface->config.syn_cnt);
 }
 
@@ -502,10 +587,11 @@ static uct_iface_ops_t uct_tcp_iface_ops = {
     .ep_am_bcopy              = uct_tcp_ep_am_bcopy,
     .ep_am_zcopy              = uct_tcp_ep_am_zcopy,
     .ep_put_zcopy             = uct_tcp_ep_put_zcopy,
+    .ep_get_zcopy             = uct_tcp_ep_get_zcopy,
     .ep_pending_add           = uct_tcp_ep_pending_add,
     .ep_pending_purge         = uct_tcp_ep_pending_purge,
     .ep_flush                 = uct_tcp_ep_flush,
-    .ep_fence                 = uct_base_ep_fence,
+    .ep_fence                 = uct_tcp_ep_fence,
     .ep_check                 = uct_tcp_ep_check,
     .ep_create                = uct_tcp_ep_create,
     .ep_destroy               = uct_tcp_ep_destroy,
@@ -525,6 +611,43 @@ static uct_iface_ops_t uct_tcp_iface_ops = {
     .iface_is_reachable       = uct_base_iface_is_reachable
 };
 
+static size_t uct_tcp_iface_msg_zcopy_thresh(uct_tcp_iface_t *iface,
+                                             size_t thresh)
+{
+#ifdef UCT_TCP_MSG_ZEROCOPY
+    const int enable = 1;
+    ucs_status_t status;
+    int fd, ret;
+
+    if (thresh == UCS_MEMUNITS_INF) {
+        return UCS_MEMUNITS_INF;
+    }
+
+    /* Check that the kernel supports zero-copy send on TCP sockets */
+    status = ucs_socket_create(iface->config.ifaddr.ss_family, SOCK_STREAM,
+                               &fd);
+    if (status != UCS_OK) {
+        return UCS_MEMUNITS_INF;
+    }
+
+    ret = setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable));
+    ucs_close_fd(&fd);
+    if (ret < 0) {
+        ucs_diag("tcp_iface %p: MSG_ZEROCOPY is not supported: %m", iface);
+        return UCS_MEMUNITS_INF;
+    }
+
+    return thresh;
+#else
+    if (thresh != UCS_MEMUNITS_INF) {
+        ucs_diag("tcp_iface %p: MSG_ZEROCOPY support is not compiled in",
+                 iface);
+    }
+
+    return UCS_MEMUNITS_INF;
+#endif
+}
+
 static ucs_status_t uct_tcp_iface_server_init(uct_tcp_iface_t *iface)
 {
     struct sockaddr_storage bind_addr = iface->config.ifaddr;
@@ -631,6 +754,11 @@ static ucs_mpool_ops_t uct_tcp_mpool_ops = {
     .obj_str       = NULL
 };
 
+static void uct_tcp_iface_release_desc(uct_recv_desc_t *self, void *desc)
+{
+    ucs_mpool_put((uct_tcp_rx_desc_t*)desc - 1);
+}
+
 static uct_iface_internal_ops_t uct_tcp_iface_internal_ops = {
     .iface_estimate_perf   = uct_base_iface_estimate_perf,
     .iface_vfs_refresh     = (uct_iface_vfs_refresh_func_t)ucs_empty_function,
@@ -638,7 +766,8 @@ static uct_iface_internal_ops_t uct_tcp_iface_internal_ops = {
     .ep_invalidate         = (uct_ep_invalidate_func_t)ucs_empty_function_return_unsupported,
     .ep_connect_to_ep_v2   = uct_tcp_ep_connect_to_ep_v2,
     .iface_is_reachable_v2 = uct_tcp_iface_is_reachable_v2,
-    .ep_is_connected       = uct_tcp_ep_is_connected
+    .ep_is_connected       = uct_tcp_ep_is_connected,
+    .iface_am_bcast_bcopy  = (uct_iface_am_bcast_bcopy_func_t)ucs_empty_function_return_unsupported
 };
 
 static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
@@ -651,6 +780,7 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     ucs_status_t status;
     int i;
     ucs_mpool_params_t mp_params;
+    unsigned uring_entries;
 
     UCT_CHECK_PARAM(params->field_mask & UCT_IFACE_PARAM_FIELD_OPEN_MODE,
                     "UCT_IFACE_PARAM_FIELD_OPEN_MODE is not defined");
@@ -705,6 +835,16 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         return UCS_ERR_INVALID_PARAM;
     }
 
+    if (config->cork_bytes == UCS_MEMUNITS_INF) {
+        ucs_error("the size of aggregated active messages must be finite");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if (config->stripes == 0) {
+        ucs_error("the number of connections per endpoint must be at least 1");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
     if (config->max_conn_retries > UINT8_MAX) {
         ucs_error("unsupported value was specified (%u) for the maximal "
                   "connection retries, expected lower than %u",
@@ -716,6 +856,15 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
                                      self->config.zcopy.hdr_offset;
     self->config.prefer_default    = config->prefer_default;
     self->config.put_enable        = config->put_enable;
+    self->config.get_enable        = config->get_enable;
+    self->config.cork_bytes        = config->cork_bytes;
+    self->config.rx_desc_thresh    = config->rx_desc_thresh;
+    self->rx_headroom              = (params->field_mask &
+                                      UCT_IFACE_PARAM_FIELD_RX_HEADROOM) ?
+                                     params->rx_headroom : 0;
+    self->release_desc.cb          = uct_tcp_iface_release_desc;
+    self->config.stripe.count      = config->put_enable ? config->stripes : 1;
+    self->config.stripe.thresh     = config->stripe_thresh;
     self->config.conn_nb           = config->conn_nb;
     self->config.max_poll          = config->max_poll;
     self->config.max_conn_retries  = config->max_conn_retries;
@@ -756,7 +905,10 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     uct_iface_mpool_config_copy(&mp_params, &config->tx_mpool);
     mp_params.elems_per_chunk = (config->tx_mpool.bufs_grow == 0) ?
                                 32 : config->tx_mpool.bufs_grow;
-    mp_params.elem_size       = self->config.tx_seg_size;
+    /* An aggregated message is added to the TX buffer while the size of the
+     * messages before it is less than the aggregation limit */
+    mp_params.elem_size       = self->config.tx_seg_size +
+                                self->config.cork_bytes;
     mp_params.ops             = &uct_tcp_mpool_ops;
     mp_params.name            = "uct_tcp_iface_tx_buf_mp";
     status = ucs_mpool_init(&mp_params, &self->tx_mpool);
@@ -776,6 +928,19 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         goto err_cleanup_tx_mpool;
     }
 
+    ucs_mpool_params_reset(&mp_params);
+    uct_iface_mpool_config_copy(&mp_params, &config->rx_mpool);
+    mp_params.elems_per_chunk = (config->rx_mpool.bufs_grow == 0) ?
+                                32 : config->rx_mpool.bufs_grow;
+    mp_params.elem_size       = sizeof(uct_tcp_rx_desc_t) + self->rx_headroom +
+                                self->config.rx_seg_size;
+    mp_params.ops             = &uct_tcp_mpool_ops;
+    mp_params.name            = "uct_tcp_iface_rx_desc_mp";
+    status = ucs_mpool_init(&mp_params, &self->rx_desc_mpool);
+    if (status != UCS_OK) {
+        goto err_cleanup_rx_mpool;
+    }
+
     for (i = 0; i < tcp_md->config.af_prio_count; i++) {
         status = ucs_netif_get_addr(self->if_name,
                                     tcp_md->config.af_prio_list[i],
@@ -787,7 +952,7 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     }
 
     if (status != UCS_OK) {
-        goto err_cleanup_rx_mpool;
+        goto err_cleanup_rx_desc_mpool;
     }
 
     status = ucs_sockaddr_sizeof((struct sockaddr*)&self->config.ifaddr,
@@ -796,6 +961,9 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         return status;
     }
 
+    self->config.zcopy.msg_thresh =
+            uct_tcp_iface_msg_zcopy_thresh(self, config->msg_zcopy_thresh);
+
     ucs_list_head_init(&self->ep_list);
     ucs_conn_match_init(&self->conn_match_ctx, self->config.sockaddr_len,
                         UCT_TCP_CM_CONN_SN_MAX, &uct_tcp_cm_conn_match_ops);
@@ -805,18 +973,41 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     status = ucs_event_set_create(&self->event_set);
     if (status != UCS_OK) {
         status = UCS_ERR_IO_ERROR;
-        goto err_cleanup_rx_mpool;
+        goto err_cleanup_rx_desc_mpool;
+    }
+
+    self->uring.fd       = -1;
+    self->uring.rx_count = 0;
+    if (config->io_uring != UCS_NO) {
+        /* Receive operations are posted for the events of a single wait */
+        uring_entries = ucs_min(self->config.max_poll,
+                                ucs_sys_event_set_max_wait_events);
+        status        = uct_tcp_uring_init(&self->uring,
+                                           ucs_max(uring_entries, 1));
+        if (status != UCS_OK) {
+            if (config->io_uring == UCS_YES) {
+                ucs_error("tcp_iface %p: failed to create io_uring", self);
+                goto err_cleanup_event_set;
+            }
+
+            ucs_diag("tcp_iface %p: io_uring is not supported, using recv()",
+                     self);
+        }
     }
 
     status = uct_tcp_iface_listener_init(self);
     if (status != UCS_OK) {
-        goto err_cleanup_event_set;
+        goto err_cleanup_uring;
     }
 
     return UCS_OK;
 
+err_cleanup_uring:
+    uct_tcp_uring_cleanup(&self->uring);
 err_cleanup_event_set:
     ucs_event_set_cleanup(self->event_set);
+err_cleanup_rx_desc_mpool:
+    ucs_mpool_cleanup(&self->rx_desc_mpool, 1);
 err_cleanup_rx_mpool:
     ucs_mpool_cleanup(&self->rx_mpool, 1);
 err_cleanup_tx_mpool:
@@ -886,10 +1077,12 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_iface_t)
     ucs_conn_match_cleanup(&self->conn_match_ctx);
     UCS_PTR_MAP_DESTROY(tcp_ep, &self->ep_ptr_map);
 
+    ucs_mpool_cleanup(&self->rx_desc_mpool, 1);
     ucs_mpool_cleanup(&self->rx_mpool, 1);
     ucs_mpool_cleanup(&self->tx_mpool, 1);
 
     ucs_close_fd(&self->listen_fd);
+    uct_tcp_uring_cleanup(&self->uring);
     ucs_event_set_cleanup(self->event_set);
 }
 
@@ -0,0 +1,339 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2024. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "tcp.h"
+
+#include <ucs/arch/cpu.h>
+#include <ucs/debug/memtrack_int.h>
+#include <sys/mman.h>
+
+#ifdef UCT_TCP_IO_URING
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+
+/* User data of the operations which complete without side effects */
+#define UCT_TCP_URING_USER_DATA_NOP UINT64_MAX
+
+
+static void uct_tcp_uring_unmap(uct_tcp_uring_t *uring)
+{
+    if (uring->sqes != NULL) {
+        munmap(uring->sqes, uring->sqes_size);
+    }
+
+    if (uring->cq_ring != NULL) {
+        munmap(uring->cq_ring, uring->cq_ring_size);
+    }
+
+    if (uring->sq_ring != NULL) {
+        munmap(uring->sq_ring, uring->sq_ring_size);
+    }
+}
+
+static void uct_tcp_uring_rx_remove(uct_tcp_uring_rx_t *rx)
+{
+    ucs_assert(rx->ep->flags & UCT_TCP_EP_FLAG_RX_URING);
+    rx->ep->flags &= ~UCT_TCP_EP_FLAG_RX_URING;
+    rx->ep         = NULL;
+}
+
+#ifdef UCT_TCP_IO_URING
+
+static void *uct_tcp_uring_mmap(int fd, size_t size, off_t offset,
+                                const char *name)
+{
+    void *ptr;
+
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+               fd, offset);
+    if (ptr == MAP_FAILED) {
+        ucs_error("failed to map io_uring %s (fd=%d size=%zu): %m", name, fd,
+                  size);
+        return NULL;
+    }
+
+    return ptr;
+}
+
+ucs_status_t uct_tcp_uring_init(uct_tcp_uring_t *uring, unsigned entries)
+{
+    struct io_uring_params params = {};
+    ucs_status_t status;
+    int ret;
+
+    memset(uring, 0, sizeof(*uring));
+    uring->fd = -1;
+
+    ret = syscall(__NR_io_uring_setup, entries, &params);
+    if (ret < 0) {
+        ucs_diag("io_uring_setup(entries=%u) failed: %m", entries);
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    uring->fd           = ret;
+    uring->entries      = params.sq_entries;
+    uring->sq_ring_size = params.sq_off.array +
+                          (params.sq_entries * sizeof(unsigned));
+    uring->cq_ring_size = params.cq_off.cqes +
+                          (params.cq_entries * sizeof(struct io_uring_cqe));
+    uring->sqes_size    = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    uring->sq_ring = uct_tcp_uring_mmap(uring->fd, uring->sq_ring_size,
+                                        IORING_OFF_SQ_RING, "sq ring");
+    if (uring->sq_ring == NULL) {
+        status = UCS_ERR_IO_ERROR;
+        goto err;
+    }
+
+    uring->cq_ring = uct_tcp_uring_mmap(uring->fd, uring->cq_ring_size,
+                                        IORING_OFF_CQ_RING, "cq ring");
+    if (uring->cq_ring == NULL) {
+        status = UCS_ERR_IO_ERROR;
+        goto err;
+    }
+
+    uring->sqes = uct_tcp_uring_mmap(uring->fd, uring->sqes_size,
+                                     IORING_OFF_SQES, "sqes");
+    if (uring->sqes == NULL) {
+        status = UCS_ERR_IO_ERROR;
+        goto err;
+    }
+
+    uring->rx = ucs_calloc(uring->entries, sizeof(*uring->rx),
+                           "tcp_uring_rx");
+    if (uring->rx == NULL) {
+        ucs_error("failed to allocate io_uring receive operations");
+        status = UCS_ERR_NO_MEMORY;
+        goto err;
+    }
+
+    uring->sq_tail  = UCS_PTR_BYTE_OFFSET(uring->sq_ring, params.sq_off.tail);
+    uring->sq_array = UCS_PTR_BYTE_OFFSET(uring->sq_ring, params.sq_off.array);
+    uring->sq_mask  = *(unsigned*)UCS_PTR_BYTE_OFFSET(uring->sq_ring,
+                                                      params.sq_off.ring_mask);
+    uring->cq_head  = UCS_PTR_BYTE_OFFSET(uring->cq_ring, params.cq_off.head);
+    uring->cq_tail  = UCS_PTR_BYTE_OFFSET(uring->cq_ring, params.cq_off.tail);
+    uring->cq_mask  = *(unsigned*)UCS_PTR_BYTE_OFFSET(uring->cq_ring,
+                                                      params.cq_off.ring_mask);
+    uring->cqes     = UCS_PTR_BYTE_OFFSET(uring->cq_ring, params.cq_off.cqes);
+
+    ucs_debug("created io_uring fd %d with %u entries", uring->fd,
+              uring->entries);
+    return UCS_OK;
+
+err:
+    uct_tcp_uring_unmap(uring);
+    ucs_close_fd(&uring->fd);
+    return status;
+}
+
+void uct_tcp_uring_post_recv(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep,
+                             void *buf, size_t length)
+{
+    uct_tcp_uring_rx_t *rx = &uring->rx[uring->rx_count];
+
+    ucs_assert(!uct_tcp_uring_is_full(uring));
+    ucs_assert(!(ep->flags & UCT_TCP_EP_FLAG_RX_URING));
+
+    rx->ep     = ep;
+    rx->buf    = buf;
+    rx->length = length;
+    rx->result = -EAGAIN;
+    ++uring->rx_count;
+    ep->flags |= UCT_TCP_EP_FLAG_RX_URING;
+}
+
+static void uct_tcp_uring_prep_sqe(uct_tcp_uring_t *uring, unsigned index,
+                                   uct_tcp_uring_rx_t *rx)
+{
+    struct io_uring_sqe *sqe = (struct io_uring_sqe*)uring->sqes + index;
+
+    memset(sqe, 0, sizeof(*sqe));
+    if (rx == NULL) {
+        sqe->opcode    = IORING_OP_NOP;
+        sqe->user_data = UCT_TCP_URING_USER_DATA_NOP;
+        return;
+    }
+
+    sqe->opcode    = IORING_OP_RECV;
+    sqe->fd        = rx->ep->fd;
+    sqe->addr      = (uintptr_t)rx->buf;
+    sqe->len       = ucs_min(rx->length, UINT_MAX);
+    /* Complete with -EAGAIN instead of waiting for the data, so the receive
+     * always completes during the io_uring_enter() call */
+    sqe->msg_flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+    sqe->user_data = rx - uring->rx;
+}
+
+static void uct_tcp_uring_submit(uct_tcp_uring_t *uring)
+{
+    unsigned tail = *uring->sq_tail;
+    unsigned count = 0;
+    struct io_uring_cqe *cqe;
+    uct_tcp_uring_rx_t *rx;
+    unsigned head, index;
+    int ret;
+
+    /* The EPs could be destroyed, or stop receiving data to the posted
+     * buffers, while the events of other EPs were handled */
+    for (rx = uring->rx; rx < (uring->rx + uring->rx_count); ++rx) {
+        if ((rx->ep != NULL) && (rx->ep->fd != -1) &&
+            (rx->buf == uct_tcp_ep_rx_uring_buf(rx->ep))) {
+            index                  = (tail + count++) & uring->sq_mask;
+            uring->sq_array[index] = index;
+            uct_tcp_uring_prep_sqe(uring, index, rx);
+        }
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    ucs_memory_cpu_store_fence();
+    *uring->sq_tail = tail + count;
+
+    /* Wait for all receive operations, since they never block */
+    ret = syscall(__NR_io_uring_enter, uring->fd, count, count,
+                  IORING_ENTER_GETEVENTS, NULL, 0);
+    if (ucs_unlikely(ret != count)) {
+        ucs_error("io_uring_enter(fd=%d count=%u) returned %d: %m", uring->fd,
+                  count, ret);
+        /* The operations which were not submitted stay on the submission
+         * queue, so make them complete without side effects */
+        for (ret = ucs_max(ret, 0); ret < count; ++ret) {
+            uct_tcp_uring_prep_sqe(uring, (tail + ret) & uring->sq_mask,
+                                   NULL);
+        }
+    }
+
+    head = *uring->cq_head;
+    while (head != *(volatile unsigned*)uring->cq_tail) {
+        ucs_memory_cpu_load_fence();
+        cqe = (struct io_uring_cqe*)uring->cqes + (head & uring->cq_mask);
+        if (cqe->user_data != UCT_TCP_URING_USER_DATA_NOP) {
+            ucs_assertv(cqe->user_data < uring->rx_count,
+                        "user_data=%llu rx_count=%u", cqe->user_data,
+                        uring->rx_count);
+            uring->rx[cqe->user_data].result = cqe->res;
+        }
+        ++head;
+    }
+
+    ucs_memory_cpu_store_fence();
+    *uring->cq_head = head;
+}
+
+unsigned uct_tcp_uring_progress(uct_tcp_uring_t *uring)
+{
+    unsigned count = 0;
+    uct_tcp_uring_rx_t *rx;
+    uct_tcp_ep_t *ep;
+
+    if (uring->rx_count == 0) {
+        return 0;
+    }
+
+    uct_tcp_uring_submit(uring);
+
+    /* Account the received data of all EPs before handling it, since the
+     * handlers could move the RX context of another EP, which is moved only
+     * if it contains data */
+    for (rx = uring->rx; rx < (uring->rx + uring->rx_count); ++rx) {
+        if (rx->ep == NULL) {
+            continue;
+        }
+
+        if (rx->buf != uct_tcp_ep_rx_uring_buf(rx->ep)) {
+            /* The receive operation was not submitted */
+            uct_tcp_uring_rx_remove(rx);
+            continue;
+        }
+
+        if (rx->result > 0) {
+            count  += uct_tcp_ep_rx_uring_complete(rx->ep, rx->result);
+            rx->buf = uct_tcp_ep_rx_uring_buf(rx->ep);
+            if (rx->buf == NULL) {
+                /* Nothing left to handle, e.g. PUT operation completed */
+                uct_tcp_uring_rx_remove(rx);
+            }
+        }
+    }
+
+    /* The EPs may be destroyed, or their RX contexts may be moved, by the
+     * callbacks of the previous receive operations */
+    for (rx = uring->rx; rx < (uring->rx + uring->rx_count); ++rx) {
+        ep = rx->ep;
+        if (ep == NULL) {
+            continue;
+        }
+
+        uct_tcp_uring_rx_remove(rx);
+        if (rx->buf == uct_tcp_ep_rx_uring_buf(ep)) {
+            count += uct_tcp_ep_progress_rx_uring(ep, rx->result);
+        }
+    }
+
+    uring->rx_count = 0;
+    return count;
+}
+
+#else
+
+ucs_status_t uct_tcp_uring_init(uct_tcp_uring_t *uring, unsigned entries)
+{
+    memset(uring, 0, sizeof(*uring));
+    uring->fd = -1;
+    ucs_diag("io_uring support is not compiled in");
+    return UCS_ERR_UNSUPPORTED;
+}
+
+void uct_tcp_uring_post_recv(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep,
+                             void *buf, size_t length)
+{
+    ucs_fatal("io_uring support is not compiled in");
+}
+
+unsigned uct_tcp_uring_progress(uct_tcp_uring_t *uring)
+{
+    return 0;
+}
+
+#endif
+
+void uct_tcp_uring_cleanup(uct_tcp_uring_t *uring)
+{
+    if (!uct_tcp_uring_is_enabled(uring)) {
+        return;
+    }
+
+    ucs_free(uring->rx);
+    uct_tcp_uring_unmap(uring);
+    ucs_close_fd(&uring->fd);
+}
+
+void uct_tcp_uring_remove_ep(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep)
+{
+    uct_tcp_uring_rx_t *rx;
+
+    if (!(ep->flags & UCT_TCP_EP_FLAG_RX_URING)) {
+        return;
+    }
+
+    for (rx = uring->rx; rx < (uring->rx + uring->rx_count); ++rx) {
+        if (rx->ep == ep) {
+            uct_tcp_uring_rx_remove(rx);
+            return;
+        }
+    }
+
+    ucs_fatal("uring %p: ep %p is not found", uring, ep);
+}
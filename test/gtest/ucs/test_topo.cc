@@ -11,6 +11,8 @@ extern "C" {
 #include <ucs/sys/topo/base/topo.h>
 }
 
+#include <sys/mman.h>
+
 class test_topo : public ucs::test {
 };
 
@@ -151,3 +153,50 @@ UCS_TEST_F(test_topo, numa_distance) {
         }
     }
 }
+
+UCS_TEST_F(test_topo, numa_node_of_cpuset) {
+    ucs_cpu_set_t cpuset;
+    int cpu;
+
+    UCS_CPU_ZERO(&cpuset);
+    EXPECT_EQ(UCS_NUMA_NODE_UNDEFINED, ucs_numa_node_of_cpuset(&cpuset));
+
+    for (cpu = 0; cpu < (int)ucs_numa_num_configured_cpus(); ++cpu) {
+        UCS_CPU_ZERO(&cpuset);
+        UCS_CPU_SET(cpu, &cpuset);
+        EXPECT_EQ(ucs_numa_node_of_cpu(cpu), ucs_numa_node_of_cpuset(&cpuset))
+                << "cpu " << cpu;
+    }
+
+    /* all CPUs of the same node */
+    UCS_CPU_ZERO(&cpuset);
+    for (cpu = 0; cpu < (int)ucs_numa_num_configured_cpus(); ++cpu) {
+        if (ucs_numa_node_of_cpu(cpu) == ucs_numa_node_of_cpu(0)) {
+            UCS_CPU_SET(cpu, &cpuset);
+        }
+    }
+    EXPECT_EQ(ucs_numa_node_of_cpu(0), ucs_numa_node_of_cpuset(&cpuset));
+}
+
+UCS_TEST_F(test_topo, numa_mem_set_node) {
+    size_t length = ucs_get_page_size();
+    ucs_status_t status;
+    void *address;
+
+    address = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(MAP_FAILED, address);
+
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucs_numa_mem_set_node(address, length, UCS_NUMA_NODE_UNDEFINED));
+
+    status = ucs_numa_mem_set_node(address, length, ucs_numa_node_of_cpu(0));
+    if (status == UCS_OK) {
+        memset(address, 0, length);
+    } else {
+        UCS_TEST_MESSAGE << "setting memory NUMA node is not supported: "
+                         << ucs_status_string(status);
+    }
+
+    munmap(address, length);
+}
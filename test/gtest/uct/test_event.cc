@@ -108,6 +108,42 @@ public:
         return ucs_time_to_sec(ucs_get_time() - start_time);
     }
 
+    /* Measure the average time from sending an active message to an armed
+     * receiver until its event fd becomes readable */
+    void test_wakeup_latency()
+    {
+        static const unsigned count = 10000 / ucs::test_time_multiplier();
+        ucs_time_t total_time       = 0;
+        ucs_time_t start_time;
+
+        uct_iface_set_am_handler(m_e2->iface(), 0, count_am_handler, NULL, 0);
+
+        for (unsigned i = 0; i < count; ++i) {
+            arm(m_e2, UCT_EVENT_RECV);
+
+            start_time = ucs_get_time();
+            send_am_data(0, false);
+            EXPECT_TRUE(m_async_event_ctx.wait_for_event(*m_e2, 60));
+            total_time += ucs_get_time() - start_time;
+
+            while (m_am_recv_count < m_am_send_count) {
+                progress();
+            }
+        }
+
+        UCS_TEST_MESSAGE << "wakeup latency: "
+                         << ucs_time_to_usec(total_time) / count << " usec";
+
+        m_e1->flush();
+    }
+
+    static ucs_status_t count_am_handler(void *arg, void *data, size_t length,
+                                         unsigned flags)
+    {
+        ++m_am_recv_count;
+        return UCS_OK;
+    }
+
 protected:
     static unsigned m_am_recv_count;
 
@@ -211,4 +247,36 @@ UCS_TEST_SKIP_COND_P(test_uct_event, sig_am,
     test_recv_am(UCT_EVENT_RECV_SIG, UCT_SEND_FLAG_SIGNALED);
 }
 
+UCS_TEST_SKIP_COND_P(test_uct_event, wakeup_latency,
+                     !check_caps(UCT_IFACE_FLAG_CB_SYNC |
+                                 UCT_IFACE_FLAG_AM_BCOPY) ||
+                     !check_event_caps(UCT_IFACE_FLAG_EVENT_RECV |
+                                       UCT_IFACE_FLAG_EVENT_FD))
+{
+    test_wakeup_latency();
+}
+
 UCT_INSTANTIATE_NO_SELF_TEST_CASE(test_uct_event);
+
+
+class test_uct_event_mm_futex : public test_uct_event {
+public:
+    void init()
+    {
+        modify_config("MM_WAKEUP", "futex");
+        test_uct_event::init();
+    }
+};
+
+UCS_TEST_P(test_uct_event_mm_futex, am)
+{
+    test_recv_am(UCT_EVENT_RECV, 0);
+}
+
+UCS_TEST_P(test_uct_event_mm_futex, wakeup_latency)
+{
+    test_wakeup_latency();
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_uct_event_mm_futex, posix)
+_UCT_INSTANTIATE_TEST_CASE(test_uct_event_mm_futex, sysv)
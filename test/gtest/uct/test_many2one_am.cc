@@ -98,6 +98,126 @@ public:
         }
     }
 
+    void create_senders(ucs::ptr_vector<mapped_buffer> &buffers,
+                        size_t buffer_size)
+    {
+        for (unsigned i = 0; i < NUM_SENDERS; ++i) {
+            entity *sender = create_entity(0);
+            mapped_buffer *buffer = new mapped_buffer(buffer_size, 0, *sender);
+            sender->connect(0, *m_receiver, i);
+            m_entities.push_back(sender);
+            buffers.push_back(buffer);
+        }
+    }
+
+    void test_am_bcopy()
+    {
+        const unsigned num_sends = 1000 / ucs::test_time_multiplier();
+        ucs_status_t status;
+
+        ucs::ptr_vector<mapped_buffer> buffers;
+        create_senders(buffers, m_receiver->iface_attr().cap.am.max_bcopy);
+
+        m_am_count = 0;
+
+        status = uct_iface_set_am_handler(m_receiver->iface(), AM_ID,
+                                          am_handler, (void*)this, 0);
+        ASSERT_UCS_OK(status);
+
+        for (unsigned i = 0; i < num_sends; ++i) {
+            unsigned sender_num = ucs::rand() % NUM_SENDERS;
+
+            mapped_buffer& buffer = buffers.at(sender_num);
+            buffer.pattern_fill(i);
+
+            ssize_t packed_len;
+            for (;;) {
+                const entity& sender = ent(sender_num + 1);
+                packed_len = uct_ep_am_bcopy(sender.ep(0), AM_ID,
+                                             mapped_buffer::pack,
+                                             (void*)&buffer, 0);
+                if (packed_len != UCS_ERR_NO_RESOURCE) {
+                    break;
+                }
+                sender.progress();
+                m_receiver->progress();
+            }
+            if (packed_len < 0) {
+                ASSERT_UCS_OK((ucs_status_t)packed_len);
+            }
+        }
+
+        while (m_am_count < num_sends) {
+            progress();
+        }
+
+        status = uct_iface_set_am_handler(m_receiver->iface(), AM_ID,
+                                          NULL, NULL, 0);
+        ASSERT_UCS_OK(status);
+
+        check_backlog();
+
+        for (unsigned i = 0; i < NUM_SENDERS; ++i) {
+            ent(i + 1).flush();
+        }
+
+        buffers.clear();
+    }
+
+    static ucs_status_t
+    count_am_handler(void *arg, void *data, size_t length, unsigned flags)
+    {
+        test_many2one_am *self = reinterpret_cast<test_many2one_am*>(arg);
+        ++self->m_am_count;
+        return UCS_OK;
+    }
+
+    /* Measure the message rate of short active messages sent by all senders
+     * in a round-robin order to the same receiver */
+    void test_am_short_rate()
+    {
+        const unsigned num_sends = 10000 / ucs::test_time_multiplier();
+        const uint64_t hdr       = 0xdeadbeef;
+        ucs::ptr_vector<mapped_buffer> buffers;
+        ucs_time_t start_time;
+        ucs_status_t status;
+        double elapsed;
+
+        create_senders(buffers, sizeof(uint64_t));
+
+        m_am_count = 0;
+        status     = uct_iface_set_am_handler(m_receiver->iface(), AM_ID,
+                                              count_am_handler, (void*)this,
+                                              0);
+        ASSERT_UCS_OK(status);
+
+        start_time = ucs_get_time();
+        for (unsigned i = 0; i < num_sends; ++i) {
+            const entity &sender = ent((i % NUM_SENDERS) + 1);
+            while (uct_ep_am_short(sender.ep(0), AM_ID, hdr, NULL, 0) ==
+                   UCS_ERR_NO_RESOURCE) {
+                sender.progress();
+                m_receiver->progress();
+            }
+        }
+
+        while (m_am_count < num_sends) {
+            progress();
+        }
+
+        elapsed = ucs_time_to_sec(ucs_get_time() - start_time);
+        UCS_TEST_MESSAGE << NUM_SENDERS << " senders: "
+                         << (num_sends / elapsed) / 1e6 << " Mmsg/s";
+
+        status = uct_iface_set_am_handler(m_receiver->iface(), AM_ID, NULL,
+                                          NULL, 0);
+        ASSERT_UCS_OK(status);
+
+        for (unsigned i = 0; i < NUM_SENDERS; ++i) {
+            ent(i + 1).flush();
+        }
+    }
+
     static const size_t NUM_SENDERS = 10;
 
 protected:
@@ -111,63 +231,38 @@ UCS_TEST_SKIP_COND_P(test_many2one_am, am_bcopy,
                      !check_caps(UCT_IFACE_FLAG_AM_BCOPY |
                                  UCT_IFACE_FLAG_CB_SYNC))
 {
-    const unsigned num_sends = 1000 / ucs::test_time_multiplier();
-    ucs_status_t status;
-
-    ucs::ptr_vector<mapped_buffer> buffers;
-    for (unsigned i = 0; i < NUM_SENDERS; ++i) {
-        entity *sender = create_entity(0);
-        mapped_buffer *buffer = new mapped_buffer(
-                            sender->iface_attr().cap.am.max_bcopy, 0, *sender);
-        sender->connect(0, *m_receiver, i);
-        m_entities.push_back(sender);
-        buffers.push_back(buffer);
-    }
-
-    m_am_count = 0;
-
-    status = uct_iface_set_am_handler(m_receiver->iface(), AM_ID, am_handler,
-                                      (void*)this, 0);
-    ASSERT_UCS_OK(status);
+    test_am_bcopy();
+}
 
-    for (unsigned i = 0; i < num_sends; ++i) {
-        unsigned sender_num = ucs::rand() % NUM_SENDERS;
+UCS_TEST_SKIP_COND_P(test_many2one_am, am_short_rate,
+                     !check_caps(UCT_IFACE_FLAG_AM_SHORT |
+                                 UCT_IFACE_FLAG_CB_SYNC))
+{
+    test_am_short_rate();
+}
 
-        mapped_buffer& buffer = buffers.at(sender_num);
-        buffer.pattern_fill(i);
+UCT_INSTANTIATE_NO_SELF_TEST_CASE(test_many2one_am)
 
-        ssize_t packed_len;
-        for (;;) {
-            const entity& sender = ent(sender_num + 1);
-            packed_len = uct_ep_am_bcopy(sender.ep(0), AM_ID,
-                                         mapped_buffer::pack,
-                                         (void*)&buffer, 0);
-            if (packed_len != UCS_ERR_NO_RESOURCE) {
-                break;
-            }
-            sender.progress();
-            m_receiver->progress();
-        }
-        if (packed_len < 0) {
-            ASSERT_UCS_OK((ucs_status_t)packed_len);
-        }
-    }
 
-    while (m_am_count < num_sends) {
-        progress();
+class test_many2one_am_fifo_lanes : public test_many2one_am {
+public:
+    void init()
+    {
+        modify_config("MM_FIFO_LANES", ucs::to_string(NUM_LANES));
+        test_many2one_am::init();
     }
 
-    status = uct_iface_set_am_handler(m_receiver->iface(), AM_ID,
-                                      NULL, NULL, 0);
-    ASSERT_UCS_OK(status);
-
-    check_backlog();
+    static const unsigned NUM_LANES = 4;
+};
 
-    for (unsigned i = 0; i < NUM_SENDERS; ++i) {
-        ent(i + 1).flush();
-    }
+UCS_TEST_P(test_many2one_am_fifo_lanes, am_bcopy)
+{
+    test_am_bcopy();
+}
 
-    buffers.clear();
+UCS_TEST_P(test_many2one_am_fifo_lanes, am_short_rate)
+{
+    test_am_short_rate();
 }
 
-UCT_INSTANTIATE_NO_SELF_TEST_CASE(test_many2one_am)
+UCT_INSTANTIATE_MM_TEST_CASE(test_many2one_am_fifo_lanes)
@@ -7,6 +7,7 @@
 extern "C" {
 #include <uct/api/uct.h>
 #include <uct/sm/mm/base/mm_md.h>
+#include <uct/sm/mm/base/mm_iface.h>
 #include <ucs/time/time.h>
 }
 #include "uct_p2p_test.h"
@@ -19,17 +20,21 @@ public:
 
     struct mm_resource : public resource {
         std::string  shm_dir;
+        bool         use_memfd;
 
-        mm_resource(const resource& res, const std::string& shm_dir = "") :
+        mm_resource(const resource& res, const std::string& shm_dir = "",
+                    bool use_memfd = false) :
             resource(res.component, res.component_name, res.md_name,
                      res.local_cpus, res.tl_name, res.dev_name, res.dev_type),
-            shm_dir(shm_dir)
+            shm_dir(shm_dir), use_memfd(use_memfd)
         {
         }
 
         virtual std::string name() const {
             std::string name = resource::name();
-            if (!shm_dir.empty()) {
+            if (use_memfd) {
+                name += ",memfd";
+            } else if (!shm_dir.empty()) {
                 name += ",dir=" + shm_dir;
             }
             return name;
@@ -74,10 +79,13 @@ public:
                                     std::vector<mm_resource> &variants) {
         variants.push_back(mm_resource(res, "."       ));
         variants.push_back(mm_resource(res, "/dev/shm"));
+        variants.push_back(mm_resource(res, "/dev/shm", true));
     }
 
     void set_posix_config() {
         set_config("POSIX_DIR=" + GetParam()->shm_dir);
+        set_config(std::string("POSIX_USE_MEMFD=") +
+                   (GetParam()->use_memfd ? "y" : "n"));
     }
 
     virtual void init() {
@@ -187,10 +195,108 @@ public:
         test_rkey(ptr, memh, size);
     }
 
+    uct_mm_iface_t *mm_iface(entity *e) {
+        return ucs_derived_of(e->iface(), uct_mm_iface_t);
+    }
+
+    static size_t pack_cb(void *dest, void *arg) {
+        uint64_t *sn = (uint64_t*)arg;
+
+        for (unsigned i = 0; i < bcopy_length / sizeof(*sn); ++i) {
+            ((uint64_t*)dest)[i] = *sn;
+        }
+        return bcopy_length;
+    }
+
+    static ucs_status_t check_am_handler(void *arg, void *data, size_t length,
+                                         unsigned flags) {
+        uint64_t *recv_count = (uint64_t*)arg;
+
+        EXPECT_EQ(bcopy_length, length);
+        for (unsigned i = 0; i < length / sizeof(*recv_count); ++i) {
+            EXPECT_EQ(*recv_count, ((uint64_t*)data)[i]) << "offset " << i;
+        }
+        ++(*recv_count);
+        return UCS_OK;
+    }
+
+    void send_recv_bcopy(unsigned count) {
+        uint64_t recv_count = 0;
+        ssize_t packed_len;
+
+        uct_iface_set_am_handler(m_e2->iface(), 0, check_am_handler,
+                                 &recv_count, 0);
+
+        for (uint64_t sn = 0; sn < count; ++sn) {
+            do {
+                packed_len = uct_ep_am_bcopy(m_e1->ep(0), 0, pack_cb, &sn, 0);
+                progress();
+            } while (packed_len == UCS_ERR_NO_RESOURCE);
+            ASSERT_EQ((ssize_t)bcopy_length, packed_len);
+        }
+
+        while (recv_count < count) {
+            progress();
+        }
+
+        uct_iface_set_am_handler(m_e2->iface(), 0, NULL, NULL, 0);
+    }
+
+    typedef struct {
+        std::string data;
+        unsigned    flags;
+        unsigned    count;
+    } zcopy_recv_t;
+
+    static ucs_status_t zcopy_am_handler(void *arg, void *data, size_t length,
+                                         unsigned flags) {
+        zcopy_recv_t *recv = (zcopy_recv_t*)arg;
+
+        recv->data.assign((char*)data, (char*)data + length);
+        recv->flags = flags;
+        ++recv->count;
+        return UCS_OK;
+    }
+
+    /* Send a zero-copy active message and wait until it is received and the
+     * send is completed */
+    void send_recv_zcopy(const mapped_buffer &sendbuf, const void *header,
+                         unsigned header_length, zcopy_recv_t &recv) {
+        uct_completion_t comp;
+        ucs_status_t status;
+
+        comp.func   = (uct_completion_callback_t)ucs_empty_function;
+        comp.count  = 1;
+        comp.status = UCS_OK;
+        recv.count  = 0;
+
+        uct_iface_set_am_handler(m_e2->iface(), 0, zcopy_am_handler, &recv,
+                                 0);
+
+        do {
+            status = uct_ep_am_zcopy(m_e1->ep(0), 0, header, header_length,
+                                     sendbuf.iov(), 1, 0, &comp);
+            progress();
+        } while (status == UCS_ERR_NO_RESOURCE);
+        ASSERT_EQ(UCS_INPROGRESS, status);
+
+        while ((recv.count == 0) || (comp.count != 0)) {
+            progress();
+        }
+
+        EXPECT_UCS_OK(comp.status);
+        uct_iface_set_am_handler(m_e2->iface(), 0, NULL, NULL, 0);
+    }
+
+    static const size_t bcopy_length = 256;
+
 protected:
+
     entity *m_e1, *m_e2;
 };
 
+const size_t test_uct_mm::bcopy_length;
+
 UCS_TEST_SKIP_COND_P(test_uct_mm, open_for_posix,
                      check_caps(UCT_IFACE_FLAG_AM_SHORT | UCT_IFACE_FLAG_CB_SYNC))
 {
@@ -269,4 +375,348 @@ UCS_TEST_SKIP_COND_P(test_uct_mm, reg,
     ASSERT_UCS_OK(status);
 }
 
+UCS_TEST_SKIP_COND_P(test_uct_mm, attach_cache_reconnect,
+                     !check_caps(UCT_IFACE_FLAG_AM_BCOPY))
+{
+    uct_mm_iface_t *iface = mm_iface(m_e1);
+
+    send_recv_bcopy(100);
+
+    unsigned long misses   = iface->rseg_cache.misses;
+    unsigned long hits     = iface->rseg_cache.hits;
+    unsigned long num_segs = iface->rseg_cache.num_segs;
+
+    /* Reconnecting to the same peer should not attach its segments again */
+    m_e1->destroy_ep(0);
+    EXPECT_EQ(num_segs, iface->rseg_cache.num_segs);
+    m_e1->connect(0, *m_e2, 0);
+
+    send_recv_bcopy(100);
+    EXPECT_EQ(misses, iface->rseg_cache.misses);
+    EXPECT_GT(iface->rseg_cache.hits, hits);
+}
+
+UCS_TEST_P(test_uct_mm, numa_node)
+{
+    ucs_sys_cpuset_t sys_cpuset;
+    ucs_cpu_set_t cpuset;
+
+    /* the interface is placed on the node of the CPUs the test runs on */
+    ASSERT_EQ(0, ucs_sys_getaffinity(&sys_cpuset));
+    ucs_sys_cpuset_copy(&cpuset, &sys_cpuset);
+    EXPECT_EQ(ucs_numa_node_of_cpuset(&cpuset),
+              m_e1->iface_attr().numa_node);
+}
+
 UCT_INSTANTIATE_MM_TEST_CASE(test_uct_mm)
+
+
+class test_uct_mm_zcopy : public test_uct_mm {
+public:
+    virtual void init() {
+        /* Large enough descriptors for 64KB messages */
+        modify_config("MM_AM_ZCOPY", "y");
+        modify_config("MM_SEG_SIZE", "65600");
+        test_uct_mm::init();
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_uct_mm_zcopy, am_zcopy,
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY))
+{
+    const size_t length   = ucs_min(64 * UCS_KBYTE,
+                                    m_e1->iface_attr().cap.am.max_zcopy);
+    uct_mm_iface_t *iface = mm_iface(m_e2);
+    uint64_t header       = 0xbeef;
+    mapped_buffer sendbuf(length, 0x1234, *m_e1);
+    zcopy_recv_t recv;
+
+    /* Without a header, the payload is passed in place */
+    send_recv_zcopy(sendbuf, NULL, 0, recv);
+    EXPECT_FALSE(recv.flags & UCT_CB_PARAM_FLAG_DESC);
+    EXPECT_EQ(std::string((char*)sendbuf.ptr(), length), recv.data);
+
+    unsigned long misses = iface->rseg_cache.misses;
+    unsigned long hits   = iface->rseg_cache.hits;
+
+    /* With a header, it is copied after the header, and the sender's segment
+     * remains attached by the receiver */
+    send_recv_zcopy(sendbuf, &header, sizeof(header), recv);
+    EXPECT_EQ(std::string((char*)&header, sizeof(header)) +
+              std::string((char*)sendbuf.ptr(), length), recv.data);
+    EXPECT_EQ(misses, iface->rseg_cache.misses);
+    EXPECT_GT(iface->rseg_cache.hits, hits);
+}
+
+UCT_INSTANTIATE_MM_TEST_CASE(test_uct_mm_zcopy)
+
+
+class test_uct_mm_attach_limit : public test_uct_mm {
+public:
+    virtual void init() {
+        /* Small receive descriptor chunks, so there are many segments */
+        modify_config("MM_RX_BUFS_GROW", "8");
+        modify_config("MM_ATTACH_MAX_SEGS", ucs::to_string(max_segs));
+        test_uct_mm::init();
+    }
+
+protected:
+    static const unsigned max_segs = 4;
+};
+
+const unsigned test_uct_mm_attach_limit::max_segs;
+
+UCS_TEST_SKIP_COND_P(test_uct_mm_attach_limit, evict,
+                     !check_caps(UCT_IFACE_FLAG_AM_BCOPY))
+{
+    uct_mm_iface_t *iface = mm_iface(m_e1);
+
+    send_recv_bcopy(2000 / ucs::test_time_multiplier());
+
+    EXPECT_LE(iface->rseg_cache.num_segs, max_segs);
+    EXPECT_GT(iface->rseg_cache.evictions, 0ul);
+    UCS_TEST_MESSAGE << "hits: " << iface->rseg_cache.hits
+                     << " misses: " << iface->rseg_cache.misses
+                     << " evictions: " << iface->rseg_cache.evictions;
+}
+
+UCT_INSTANTIATE_MM_TEST_CASE(test_uct_mm_attach_limit)
+
+
+class test_uct_mm_batch : public test_uct_mm {
+public:
+    virtual void init() {
+        /* Small FIFO, so most of the sends are pending */
+        modify_config("MM_FIFO_SIZE", "64");
+        modify_config("MM_BATCH_SIZE", "16");
+        test_uct_mm::init();
+    }
+
+    typedef struct {
+        uct_pending_req_t uct;
+        uct_ep_h          ep;
+        uint64_t          sn;
+    } pending_send_t;
+
+    static ucs_status_t pending_send_cb(uct_pending_req_t *self) {
+        pending_send_t *req = ucs_container_of(self, pending_send_t, uct);
+
+        return uct_ep_am_short(req->ep, 0, req->sn, NULL, 0);
+    }
+
+    static ucs_status_t short_am_handler(void *arg, void *data, size_t length,
+                                         unsigned flags) {
+        uint64_t *recv_count = (uint64_t*)arg;
+
+        EXPECT_EQ(sizeof(uint64_t), length);
+        EXPECT_EQ(*recv_count, *(uint64_t*)data);
+        ++(*recv_count);
+        return UCS_OK;
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_uct_mm_batch, pending_am_short,
+                     !check_caps(UCT_IFACE_FLAG_AM_SHORT |
+                                 UCT_IFACE_FLAG_PENDING))
+{
+    const unsigned num_pending = 1000;
+    std::vector<pending_send_t> reqs(num_pending);
+    uint64_t recv_count        = 0;
+    uint64_t sn                = 0;
+    ucs_status_t status;
+
+    uct_iface_set_am_handler(m_e2->iface(), 0, short_am_handler, &recv_count,
+                             0);
+
+    /* fill the remote FIFO, without progressing the receiver */
+    while ((status = uct_ep_am_short(m_e1->ep(0), 0, sn, NULL, 0)) ==
+           UCS_OK) {
+        ++sn;
+    }
+    ASSERT_EQ(UCS_ERR_NO_RESOURCE, status);
+
+    /* the rest is sent from the pending queue, in batches */
+    for (unsigned i = 0; i < num_pending; ++i) {
+        reqs[i].uct.func = pending_send_cb;
+        reqs[i].ep       = m_e1->ep(0);
+        reqs[i].sn       = sn++;
+        status           = uct_ep_pending_add(m_e1->ep(0), &reqs[i].uct, 0);
+        ASSERT_UCS_OK(status);
+    }
+
+    wait_for_value(&recv_count, sn, true);
+    EXPECT_EQ(sn, recv_count);
+    EXPECT_TRUE(ucs_list_is_empty(&mm_iface(m_e1)->batch_eps));
+
+    uct_iface_set_am_handler(m_e2->iface(), 0, NULL, NULL, 0);
+}
+
+UCT_INSTANTIATE_MM_TEST_CASE(test_uct_mm_batch)
+
+
+class test_uct_mm_bcast : public test_uct_mm {
+public:
+    virtual void init() {
+        /* Small FIFO, so the sender has to wait for the receivers */
+        modify_config("MM_BCAST_FIFO_SIZE", "16");
+        test_uct_mm::init();
+
+        /* m_e2 and the additional receivers have endpoints to m_e1, so they
+         * receive its broadcast messages */
+        for (unsigned i = 0; i < num_receivers - 1; ++i) {
+            entity *e = uct_test::create_entity(0);
+            m_entities.push_back(e);
+            e->connect(0, *m_e1, 1 + i);
+            m_e1->connect(1 + i, *e, 0);
+        }
+
+        m_recv_count.resize(num_receivers, 0);
+        for (unsigned i = 0; i < num_receivers; ++i) {
+            uct_iface_set_am_handler(receiver(i)->iface(), 0, bcast_am_handler,
+                                     &m_recv_count[i], 0);
+        }
+    }
+
+    virtual void cleanup() {
+        for (unsigned i = 0; i < num_receivers; ++i) {
+            uct_iface_set_am_handler(receiver(i)->iface(), 0, NULL, NULL, 0);
+        }
+        test_uct_mm::cleanup();
+    }
+
+    entity *receiver(unsigned index) {
+        return (index == 0) ? m_e2 : &m_entities.at(1 + index);
+    }
+
+    typedef struct {
+        uint64_t sn;
+        size_t   length;
+    } bcast_arg_t;
+
+    static size_t bcast_pack_cb(void *dest, void *arg) {
+        bcast_arg_t *bcast_arg = (bcast_arg_t*)arg;
+
+        memset(dest, 0, bcast_arg->length);
+        *(uint64_t*)dest = bcast_arg->sn;
+        return bcast_arg->length;
+    }
+
+    static ucs_status_t bcast_am_handler(void *arg, void *data, size_t length,
+                                         unsigned flags) {
+        uint64_t *recv_count = (uint64_t*)arg;
+
+        EXPECT_EQ(*recv_count, *(uint64_t*)data);
+        ++(*recv_count);
+        return UCS_OK;
+    }
+
+    uint64_t min_recv_count() const {
+        return *std::min_element(m_recv_count.begin(), m_recv_count.end());
+    }
+
+    void wait_for_receivers(uint64_t count) {
+        ucs_time_t deadline = ucs::get_deadline();
+
+        while ((min_recv_count() < count) && (ucs_get_time() < deadline)) {
+            progress();
+        }
+        ASSERT_EQ(count, min_recv_count());
+    }
+
+    /* Send the messages with a single broadcast each */
+    void send_bcast(uint64_t count, size_t length) {
+        bcast_arg_t arg = {min_recv_count(), length};
+        uint64_t end    = arg.sn + count;
+        ssize_t ret;
+
+        while (arg.sn < end) {
+            ret = uct_iface_am_bcast_bcopy(m_e1->iface(), 0, bcast_pack_cb,
+                                           &arg, 0);
+            if (ret == UCS_ERR_NO_RESOURCE) {
+                progress();
+                continue;
+            }
+
+            ASSERT_EQ((ssize_t)length, ret);
+            ++arg.sn;
+        }
+
+        wait_for_receivers(end);
+    }
+
+    /* Send the same messages to every receiver over its own endpoint */
+    void send_p2p(uint64_t count, size_t length) {
+        bcast_arg_t arg = {min_recv_count(), length};
+        uint64_t end    = arg.sn + count;
+        unsigned i      = 0;
+        ssize_t ret;
+
+        while (arg.sn < end) {
+            ret = uct_ep_am_bcopy(m_e1->ep(i), 0, bcast_pack_cb, &arg, 0);
+            if (ret == UCS_ERR_NO_RESOURCE) {
+                progress();
+                continue;
+            }
+
+            ASSERT_EQ((ssize_t)length, ret);
+            if (++i == num_receivers) {
+                i = 0;
+                ++arg.sn;
+            }
+        }
+
+        wait_for_receivers(end);
+    }
+
+protected:
+    static const unsigned num_receivers = 4;
+    std::vector<uint64_t> m_recv_count;
+};
+
+const unsigned test_uct_mm_bcast::num_receivers;
+
+UCS_TEST_SKIP_COND_P(test_uct_mm_bcast, send_recv,
+                     !check_caps(UCT_IFACE_FLAG_AM_BCAST))
+{
+    /* many more messages than the FIFO size, all received in order */
+    send_bcast(1000 / ucs::test_time_multiplier(), sizeof(uint64_t));
+    send_bcast(100 / ucs::test_time_multiplier(),
+               m_e1->iface_attr().cap.am.max_bcopy);
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm_bcast, unsubscribe,
+                     !check_caps(UCT_IFACE_FLAG_AM_BCAST))
+{
+    send_bcast(100, sizeof(uint64_t));
+
+    /* a receiver without endpoints to the sender does not hold it back */
+    receiver(num_receivers - 1)->destroy_ep(0);
+    m_recv_count.resize(num_receivers - 1);
+    send_bcast(100, sizeof(uint64_t));
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm_bcast, compare_p2p,
+                     !check_caps(UCT_IFACE_FLAG_AM_BCAST |
+                                 UCT_IFACE_FLAG_AM_BCOPY))
+{
+    const uint64_t count = 10000 / ucs::test_time_multiplier();
+    const size_t length  = ucs_min(4 * UCS_KBYTE,
+                                   m_e1->iface_attr().cap.am.max_bcopy);
+    ucs_time_t start_time;
+    double bcast_time, p2p_time;
+
+    start_time = ucs_get_time();
+    send_bcast(count, length);
+    bcast_time = ucs_time_to_usec(ucs_get_time() - start_time);
+
+    start_time = ucs_get_time();
+    send_p2p(count, length);
+    p2p_time   = ucs_time_to_usec(ucs_get_time() - start_time);
+
+    UCS_TEST_MESSAGE << num_receivers << " receivers, " << length
+                     << " bytes: broadcast " << (bcast_time / count)
+                     << " usec, point-to-point " << (p2p_time / count)
+                     << " usec per message";
+}
+
+UCT_INSTANTIATE_MM_TEST_CASE(test_uct_mm_bcast)
@@ -6,6 +6,10 @@
 
 #include "uct_p2p_test.h"
 
+extern "C" {
+#include <uct/tcp/tcp.h>
+}
+
 #include <string>
 #include <vector>
 
@@ -620,6 +624,310 @@ UCS_TEST_SKIP_COND_P(uct_p2p_am_test, am_zcopy,
 
 UCT_INSTANTIATE_TEST_CASE(uct_p2p_am_test)
 
+
+class uct_p2p_am_tcp_uring : public uct_p2p_am_test {
+public:
+    virtual void init() {
+        modify_config("TCP_IO_URING", "try");
+        uct_p2p_am_test::init();
+
+        uct_tcp_iface_t *iface = ucs_derived_of(receiver().iface(),
+                                                uct_tcp_iface_t);
+        if (!uct_tcp_uring_is_enabled(&iface->uring)) {
+            UCS_TEST_SKIP_R("io_uring is not supported");
+        }
+    }
+
+    void test_xfer_lengths(send_func_t send, size_t max_length) {
+        for (size_t length = sizeof(uint64_t); length <= max_length;
+             length = (length * 2) + 1) {
+            test_xfer(send, length, TEST_UCT_FLAG_DIR_SEND_TO_RECV,
+                      UCS_MEMORY_TYPE_HOST);
+        }
+    }
+};
+
+UCS_TEST_P(uct_p2p_am_tcp_uring, am_bcopy) {
+    test_xfer_lengths(static_cast<send_func_t>(&uct_p2p_am_test::am_bcopy),
+                      sender().iface_attr().cap.am.max_bcopy);
+}
+
+UCS_TEST_P(uct_p2p_am_tcp_uring, am_zcopy) {
+    test_xfer_lengths(static_cast<send_func_t>(&uct_p2p_am_test::am_zcopy),
+                      sender().iface_attr().cap.am.max_zcopy);
+}
+
+_UCT_INSTANTIATE_TEST_CASE(uct_p2p_am_tcp_uring, tcp)
+
+class uct_p2p_am_tcp_msg_zcopy : public uct_p2p_am_test {
+public:
+    static const size_t MSG_ZCOPY_THRESH = UCS_KBYTE;
+
+    typedef struct {
+        uct_completion_t      uct;
+        std::vector<size_t>   *order;
+        size_t                index;
+        mapped_buffer         *sendbuf;
+    } ordered_comp_t;
+
+    virtual void init() {
+        modify_config("TCP_MSG_ZEROCOPY_THRESH",
+                      ucs::to_string(MSG_ZCOPY_THRESH));
+        uct_p2p_am_test::init();
+
+        uct_tcp_iface_t *iface = ucs_derived_of(sender().iface(),
+                                                uct_tcp_iface_t);
+        if (iface->config.zcopy.msg_thresh == UCS_MEMUNITS_INF) {
+            UCS_TEST_SKIP_R("MSG_ZEROCOPY is not supported");
+        }
+    }
+
+    static void ordered_comp_cb(uct_completion_t *self) {
+        ordered_comp_t *comp = ucs_container_of(self, ordered_comp_t, uct);
+
+        EXPECT_UCS_OK(self->status);
+        comp->order->push_back(comp->index);
+        /* The data must not be used by the kernel anymore */
+        comp->sendbuf->pattern_fill(SEED2);
+    }
+};
+
+UCS_TEST_P(uct_p2p_am_tcp_msg_zcopy, am_zcopy) {
+    for (size_t length = MSG_ZCOPY_THRESH / 2;
+         length <= sender().iface_attr().cap.am.max_zcopy;
+         length = (length * 2) + 1) {
+        test_xfer(static_cast<send_func_t>(&uct_p2p_am_test::am_zcopy),
+                  length, TEST_UCT_FLAG_DIR_SEND_TO_RECV, UCS_MEMORY_TYPE_HOST);
+    }
+}
+
+UCS_TEST_P(uct_p2p_am_tcp_msg_zcopy, completion_order) {
+    static const size_t num_ops = 32;
+    std::vector<ordered_comp_t> comps(num_ops);
+    std::vector<mapped_buffer*> sendbufs;
+    std::vector<size_t> order;
+    ucs_status_t status;
+
+    status = uct_iface_set_am_handler(receiver().iface(), AM_ID, am_handler,
+                                      this, 0);
+    ASSERT_UCS_OK(status);
+
+    m_am_count = 0;
+    for (size_t i = 0; i < num_ops; ++i) {
+        /* Mix operations which are sent with and without MSG_ZEROCOPY */
+        size_t length = (i % 3) ? sender().iface_attr().cap.am.max_zcopy :
+                                  (MSG_ZCOPY_THRESH / 2);
+        sendbufs.push_back(new mapped_buffer(length, SEED1, sender()));
+
+        comps[i].uct.func   = ordered_comp_cb;
+        comps[i].uct.count  = 1;
+        comps[i].uct.status = UCS_OK;
+        comps[i].order      = &order;
+        comps[i].index      = i;
+        comps[i].sendbuf    = sendbufs.back();
+
+        UCS_TEST_GET_BUFFER_IOV(iov, iovcnt, sendbufs.back()->ptr(), length,
+                                sendbufs.back()->memh(), 1);
+        do {
+            status = uct_ep_am_zcopy(sender_ep(), AM_ID, NULL, 0, iov, iovcnt,
+                                     0, &comps[i].uct);
+            if (status == UCS_ERR_NO_RESOURCE) {
+                progress();
+            }
+        } while (status == UCS_ERR_NO_RESOURCE);
+
+        if (status == UCS_OK) {
+            ordered_comp_cb(&comps[i].uct);
+        } else {
+            ASSERT_EQ(UCS_INPROGRESS, status);
+        }
+    }
+
+    flush();
+    wait_for_value(&m_am_count, (unsigned)num_ops, true);
+    EXPECT_EQ(num_ops, m_am_count);
+
+    ASSERT_EQ(num_ops, order.size());
+    for (size_t i = 0; i < num_ops; ++i) {
+        EXPECT_EQ(i, order[i]) << "at position " << i;
+    }
+
+    status = uct_iface_set_am_handler(receiver().iface(), AM_ID, NULL, NULL, 0);
+    ASSERT_UCS_OK(status);
+
+    for (size_t i = 0; i < num_ops; ++i) {
+        delete sendbufs[i];
+    }
+}
+
+_UCT_INSTANTIATE_TEST_CASE(uct_p2p_am_tcp_msg_zcopy, tcp)
+
+class uct_p2p_am_tcp_cork : public uct_p2p_am_test {
+public:
+    static const size_t CORK_BYTES = 16 * UCS_KBYTE;
+
+    virtual void init() {
+        modify_config("TCP_CORK_BYTES", ucs::to_string(CORK_BYTES));
+        uct_p2p_am_test::init();
+        m_sn = 0;
+    }
+
+    void test_xfer_lengths(send_func_t send, size_t max_length) {
+        for (size_t length = sizeof(uint64_t); length <= max_length;
+             length = (length * 2) + 1) {
+            test_xfer(send, length, TEST_UCT_FLAG_DIR_SEND_TO_RECV,
+                      UCS_MEMORY_TYPE_HOST);
+        }
+    }
+
+    static ucs_status_t
+    sn_am_handler(void *arg, void *data, size_t length, unsigned flags) {
+        uct_p2p_am_tcp_cork *self = reinterpret_cast<uct_p2p_am_tcp_cork*>(arg);
+
+        EXPECT_EQ(sizeof(uint64_t), length);
+        EXPECT_EQ(self->m_sn, *(uint64_t*)data);
+        ++self->m_sn;
+        return UCS_OK;
+    }
+
+protected:
+    bool sender_corked() {
+        return ucs_derived_of(sender_ep(), uct_tcp_ep_t)->flags &
+               UCT_TCP_EP_FLAG_CORKED;
+    }
+
+    uint64_t m_sn;
+};
+
+UCS_TEST_P(uct_p2p_am_tcp_cork, am_short) {
+    test_xfer_lengths(static_cast<send_func_t>(&uct_p2p_am_test::am_short),
+                      sender().iface_attr().cap.am.max_short);
+}
+
+UCS_TEST_P(uct_p2p_am_tcp_cork, am_bcopy) {
+    test_xfer_lengths(static_cast<send_func_t>(&uct_p2p_am_test::am_bcopy),
+                      sender().iface_attr().cap.am.max_bcopy);
+}
+
+UCS_TEST_P(uct_p2p_am_tcp_cork, order) {
+    static const uint64_t num_ops = 10000;
+    ucs_status_t status;
+    uint64_t sn;
+
+    status = uct_iface_set_am_handler(receiver().iface(), AM_ID, sn_am_handler,
+                                      this, 0);
+    ASSERT_UCS_OK(status);
+
+    /* Connect the EP */
+    sn = 0;
+    do {
+        status = uct_ep_am_short(sender_ep(), AM_ID, sn, NULL, 0);
+        progress();
+    } while (status == UCS_ERR_NO_RESOURCE);
+    ASSERT_UCS_OK(status);
+    ++sn;
+    flush();
+
+    /* Small AMs are aggregated until the limit is reached or progress */
+    status = uct_ep_am_short(sender_ep(), AM_ID, sn++, NULL, 0);
+    ASSERT_UCS_OK(status);
+    EXPECT_TRUE(sender_corked());
+    progress();
+    EXPECT_FALSE(sender_corked());
+
+    while (sn < num_ops) {
+        status = uct_ep_am_short(sender_ep(), AM_ID, sn, NULL, 0);
+        if (status == UCS_ERR_NO_RESOURCE) {
+            progress();
+            continue;
+        }
+
+        ASSERT_UCS_OK(status);
+        ++sn;
+    }
+
+    flush();
+    wait_for_value(&m_sn, num_ops, true);
+    EXPECT_EQ(num_ops, m_sn);
+
+    status = uct_iface_set_am_handler(receiver().iface(), AM_ID, NULL, NULL, 0);
+    ASSERT_UCS_OK(status);
+}
+
+_UCT_INSTANTIATE_TEST_CASE(uct_p2p_am_tcp_cork, tcp)
+
+class uct_p2p_am_tcp_rx_desc : public uct_p2p_am_test {
+public:
+    static const size_t RX_DESC_THRESH = UCS_KBYTE;
+
+    virtual void init() {
+        modify_config("TCP_RX_DESC_THRESH", ucs::to_string(RX_DESC_THRESH));
+        uct_p2p_am_test::init();
+        m_desc_count = 0;
+    }
+
+    static ucs_status_t
+    desc_am_handler(void *arg, void *data, size_t length, unsigned flags) {
+        uct_p2p_am_tcp_rx_desc *self =
+                reinterpret_cast<uct_p2p_am_tcp_rx_desc*>(arg);
+
+        mem_buffer::pattern_check(data, length, SEED1);
+        if (flags & UCT_CB_PARAM_FLAG_DESC) {
+            EXPECT_GE(length, RX_DESC_THRESH);
+            ++self->m_desc_count;
+        }
+
+        ++self->m_am_count;
+        return UCS_OK;
+    }
+
+protected:
+    unsigned m_desc_count;
+};
+
+UCS_TEST_P(uct_p2p_am_tcp_rx_desc, am_bcopy_keep_data) {
+    set_keep_data(true);
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_am_test::am_bcopy),
+                    sizeof(uint64_t), sender().iface_attr().cap.am.max_bcopy,
+                    TEST_UCT_FLAG_DIR_SEND_TO_RECV);
+}
+
+UCS_TEST_P(uct_p2p_am_tcp_rx_desc, am_zcopy) {
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_am_test::am_zcopy),
+                    sizeof(uint64_t), sender().iface_attr().cap.am.max_zcopy,
+                    TEST_UCT_FLAG_DIR_SEND_TO_RECV);
+}
+
+UCS_TEST_P(uct_p2p_am_tcp_rx_desc, desc) {
+    static const unsigned num_ops = 64;
+    size_t length                 = sender().iface_attr().cap.am.max_bcopy;
+    mapped_buffer sendbuf(length, SEED1, sender());
+    mapped_buffer recvbuf(0, 0, sender()); /* dummy */
+    ucs_status_t status;
+
+    m_am_count = 0;
+    status     = uct_iface_set_am_handler(receiver().iface(), AM_ID,
+                                          desc_am_handler, this, 0);
+    ASSERT_UCS_OK(status);
+
+    for (unsigned i = 0; i < num_ops; ++i) {
+        blocking_send(static_cast<send_func_t>(&uct_p2p_am_test::am_bcopy),
+                      sender_ep(), sendbuf, recvbuf, false);
+    }
+
+    flush();
+    wait_for_value(&m_am_count, num_ops, true);
+    EXPECT_EQ(num_ops, m_am_count);
+    /* The small socket buffers used by the tests make the large messages
+     * arrive in several parts */
+    EXPECT_GT(m_desc_count, 0u);
+
+    status = uct_iface_set_am_handler(receiver().iface(), AM_ID, NULL, NULL, 0);
+    ASSERT_UCS_OK(status);
+}
+
+_UCT_INSTANTIATE_TEST_CASE(uct_p2p_am_tcp_rx_desc, tcp)
+
 const unsigned uct_p2p_am_misc::RX_MAX_BUFS  = 1024; /* due to hard coded 'grow'
                                                         parameter in uct_ib_iface_recv_mpool_init */
 const unsigned uct_p2p_am_misc::RX_QUEUE_LEN = 64;
@@ -6,6 +6,9 @@
 
 #include "test_p2p_rma.h"
 
+#include <uct/sm/scopy/base/scopy_iface.h>
+#include <uct/tcp/tcp.h>
+
 #include <functional>
 
 
@@ -165,3 +168,352 @@ UCS_TEST_SKIP_COND_P(test_p2p_rma_madvise, madvise,
 }
 
 UCT_INSTANTIATE_TEST_CASE(test_p2p_rma_madvise)
+
+class test_p2p_rma_scopy_mt : public uct_p2p_rma_test {
+public:
+    virtual void init() {
+        /* Split most of the operations between the copy threads */
+        modify_config("SCOPY_MT_THREADS", "3");
+        modify_config("SCOPY_MT_THRESH", "64k");
+        uct_p2p_rma_test::init();
+    }
+
+    void test_xfer_lengths(send_func_t send, unsigned flags) {
+        /* below and above the threshold, and not divisible by the number of
+         * threads */
+        static const size_t lengths[] = {4 * UCS_KBYTE, 64 * UCS_KBYTE,
+                                         UCS_MBYTE + 7, 16 * UCS_MBYTE + 1};
+
+        for (size_t length : lengths) {
+            test_xfer(send, length, flags, UCS_MEMORY_TYPE_HOST);
+        }
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_p2p_rma_scopy_mt, put_zcopy,
+                     !check_caps(UCT_IFACE_FLAG_PUT_ZCOPY)) {
+    test_xfer_lengths(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                      TEST_UCT_FLAG_SEND_ZCOPY);
+}
+
+UCS_TEST_SKIP_COND_P(test_p2p_rma_scopy_mt, get_zcopy,
+                     !check_caps(UCT_IFACE_FLAG_GET_ZCOPY)) {
+    test_xfer_lengths(static_cast<send_func_t>(&uct_p2p_rma_test::get_zcopy),
+                      TEST_UCT_FLAG_RECV_ZCOPY);
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_p2p_rma_scopy_mt, cma)
+
+
+class test_p2p_rma_scopy_batch : public uct_p2p_rma_test {
+public:
+    static void completion_cb(uct_completion_t *self) {
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_p2p_rma_scopy_batch, get_zcopy,
+                     !check_caps(UCT_IFACE_FLAG_GET_ZCOPY))
+{
+    const unsigned num_ops = 100;
+    const size_t max_iov   = sender().iface_attr().cap.get.max_iov;
+    ucs::ptr_vector<mapped_buffer> sendbufs, recvbufs;
+    uct_completion_t comp  = {completion_cb, (int)num_ops, UCS_OK};
+    ucs_status_t status;
+
+    /* post all the operations before progressing, so consecutive ones are
+     * copied together */
+    for (unsigned i = 0; i < num_ops; ++i) {
+        size_t length = 1 + (ucs::rand() % (4 * UCS_KBYTE));
+        sendbufs.push_back(new mapped_buffer(length, SEED1, sender()));
+        recvbufs.push_back(new mapped_buffer(length, SEED2 + i, receiver()));
+
+        UCS_TEST_GET_BUFFER_IOV(iov, iovcnt, sendbufs.at(i).ptr(), length,
+                                sendbufs.at(i).memh(), 1 + (i % max_iov));
+        status = uct_ep_get_zcopy(sender_ep(), iov, iovcnt,
+                                  recvbufs.at(i).addr(), recvbufs.at(i).rkey(),
+                                  &comp);
+        ASSERT_UCS_STATUS_EQ(UCS_INPROGRESS, status);
+    }
+
+    wait_for_value(&comp.count, 0, true);
+    ASSERT_EQ(0, comp.count);
+    EXPECT_UCS_OK(comp.status);
+
+    for (unsigned i = 0; i < num_ops; ++i) {
+        sendbufs.at(i).pattern_check(SEED2 + i);
+    }
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_p2p_rma_scopy_batch, cma)
+
+
+class test_p2p_rma_scopy_autotune : public uct_p2p_rma_test {
+public:
+    virtual void init() {
+        modify_config("SCOPY_AUTOTUNE", "y");
+        modify_config("SCOPY_AUTOTUNE_SEG_SIZE_MIN", "4k");
+        modify_config("SCOPY_AUTOTUNE_SEG_SIZE_MAX", "256k");
+        modify_config("SCOPY_SEG_SIZE", "16k");
+        modify_config("SCOPY_TX_QUOTA", "2");
+        uct_p2p_rma_test::init();
+    }
+
+    void test_xfer_autotune(send_func_t send, unsigned flags) {
+        uct_scopy_iface_t *iface = ucs_derived_of(sender().iface(),
+                                                  uct_scopy_iface_t);
+
+        /* enough full segments to change the segment size several times */
+        for (unsigned i = 0; i < 8; ++i) {
+            test_xfer(send, 4 * UCS_MBYTE + i, flags, UCS_MEMORY_TYPE_HOST);
+
+            EXPECT_GE(iface->config.seg_size, 4 * UCS_KBYTE);
+            EXPECT_LE(iface->config.seg_size, 256 * UCS_KBYTE);
+            EXPECT_GE(iface->config.tx_quota, 2u);
+            EXPECT_LE(iface->config.tx_quota, 8u);
+        }
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_p2p_rma_scopy_autotune, put_zcopy,
+                     !check_caps(UCT_IFACE_FLAG_PUT_ZCOPY)) {
+    test_xfer_autotune(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                       TEST_UCT_FLAG_SEND_ZCOPY);
+}
+
+UCS_TEST_SKIP_COND_P(test_p2p_rma_scopy_autotune, get_zcopy,
+                     !check_caps(UCT_IFACE_FLAG_GET_ZCOPY)) {
+    test_xfer_autotune(static_cast<send_func_t>(&uct_p2p_rma_test::get_zcopy),
+                       TEST_UCT_FLAG_RECV_ZCOPY);
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_p2p_rma_scopy_autotune, cma)
+_UCT_INSTANTIATE_TEST_CASE(test_p2p_rma_scopy_autotune, knem)
+
+
+class test_p2p_rma_tcp_uring : public uct_p2p_rma_test {
+public:
+    virtual void init() {
+        modify_config("TCP_IO_URING", "try");
+        uct_p2p_rma_test::init();
+
+        uct_tcp_iface_t *iface = ucs_derived_of(receiver().iface(),
+                                                uct_tcp_iface_t);
+        if (!uct_tcp_uring_is_enabled(&iface->uring)) {
+            UCS_TEST_SKIP_R("io_uring is not supported");
+        }
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_p2p_rma_tcp_uring, put_zcopy,
+                     !check_caps(UCT_IFACE_FLAG_PUT_ZCOPY)) {
+    /* large enough to be received by many operations */
+    static const size_t lengths[] = {1, 4 * UCS_KBYTE, UCS_MBYTE + 7,
+                                     16 * UCS_MBYTE + 1};
+
+    for (size_t length : lengths) {
+        test_xfer(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                  length, TEST_UCT_FLAG_SEND_ZCOPY, UCS_MEMORY_TYPE_HOST);
+    }
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_p2p_rma_tcp_uring, tcp)
+
+
+class test_p2p_rma_tcp_msg_zcopy : public uct_p2p_rma_test {
+public:
+    virtual void init() {
+        modify_config("TCP_MSG_ZEROCOPY_THRESH", "4k");
+        uct_p2p_rma_test::init();
+
+        uct_tcp_iface_t *iface = ucs_derived_of(sender().iface(),
+                                                uct_tcp_iface_t);
+        if (iface->config.zcopy.msg_thresh == UCS_MEMUNITS_INF) {
+            UCS_TEST_SKIP_R("MSG_ZEROCOPY is not supported");
+        }
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_p2p_rma_tcp_msg_zcopy, put_zcopy,
+                     !check_caps(UCT_IFACE_FLAG_PUT_ZCOPY)) {
+    /* below and above the threshold */
+    static const size_t lengths[] = {1, 4 * UCS_KBYTE, UCS_MBYTE + 7,
+                                     16 * UCS_MBYTE + 1};
+
+    for (size_t length : lengths) {
+        test_xfer(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                  length, TEST_UCT_FLAG_SEND_ZCOPY, UCS_MEMORY_TYPE_HOST);
+    }
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_p2p_rma_tcp_msg_zcopy, tcp)
+
+
+class test_p2p_rma_tcp_stripes : public uct_p2p_rma_test {
+public:
+    virtual void init() {
+        modify_config("TCP_STRIPES", "4");
+        modify_config("TCP_STRIPE_THRESH", "64k");
+        uct_p2p_rma_test::init();
+    }
+
+protected:
+    ucs_list_link_t *stripes() {
+        return &ucs_derived_of(sender_ep(), uct_tcp_ep_t)->stripe.list;
+    }
+
+    bool stripes_connected() {
+        uct_tcp_ep_t *stripe;
+
+        ucs_list_for_each(stripe, stripes(), list) {
+            if (stripe->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void wait_for_stripes() {
+        ucs_time_t deadline = ucs::get_deadline();
+
+        while (!stripes_connected() && (ucs_get_time() < deadline)) {
+            progress();
+        }
+
+        ASSERT_TRUE(stripes_connected());
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_p2p_rma_tcp_stripes, put_zcopy,
+                     !check_caps(UCT_IFACE_FLAG_PUT_ZCOPY)) {
+    /* below and above the threshold */
+    static const size_t lengths[] = {1, 64 * UCS_KBYTE - 1, 64 * UCS_KBYTE,
+                                     UCS_MBYTE + 7, 16 * UCS_MBYTE + 1};
+
+    /* the first connection is not a stripe */
+    EXPECT_EQ(3ul, ucs_list_length(stripes()));
+
+    for (size_t length : lengths) {
+        test_xfer(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                  length, TEST_UCT_FLAG_SEND_ZCOPY, UCS_MEMORY_TYPE_HOST);
+    }
+}
+
+UCS_TEST_SKIP_COND_P(test_p2p_rma_tcp_stripes, fence,
+                     !check_caps(UCT_IFACE_FLAG_PUT_ZCOPY)) {
+    static const size_t length      = 4 * UCS_MBYTE;
+    static const size_t tail_length = 64;
+    mapped_buffer sendbuf(length, SEED1, sender());
+    mapped_buffer tailbuf(tail_length, SEED2, sender());
+    mapped_buffer recvbuf(length, 0, receiver());
+    uct_completion_t comp;
+    ucs_status_t status;
+
+    wait_for_stripes();
+
+    for (int i = 0; i < 10; ++i) {
+        recvbuf.memset(0);
+        comp.func   = (uct_completion_callback_t)ucs_empty_function;
+        comp.count  = 2;
+        comp.status = UCS_OK;
+
+        /* striped over all connections */
+        status = uct_ep_put_zcopy(sender_ep(), sendbuf.iov(), 1,
+                                  recvbuf.addr(), recvbuf.rkey(), &comp);
+        ASSERT_EQ(UCS_INPROGRESS, status);
+
+        ASSERT_UCS_OK(uct_ep_fence(sender_ep(), 0));
+
+        /* sent over the first connection, overwrites the data of the last
+         * part, which must be delivered before */
+        for (;;) {
+            status = uct_ep_put_zcopy(sender_ep(), tailbuf.iov(), 1,
+                                      recvbuf.addr() + length - tail_length,
+                                      recvbuf.rkey(), &comp);
+            if (status != UCS_ERR_NO_RESOURCE) {
+                break;
+            }
+
+            progress();
+        }
+
+        ASSERT_EQ(UCS_INPROGRESS, status);
+        wait_for_value(&comp.count, 0, true);
+        ASSERT_EQ(0, comp.count);
+        ASSERT_UCS_OK(comp.status);
+
+        EXPECT_EQ(0, memcmp(recvbuf.ptr(), sendbuf.ptr(),
+                            length - tail_length));
+        EXPECT_EQ(0, memcmp(UCS_PTR_BYTE_OFFSET(recvbuf.ptr(),
+                                                length - tail_length),
+                            tailbuf.ptr(), tail_length));
+    }
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_p2p_rma_tcp_stripes, tcp)
+
+
+class test_p2p_rma_tcp_get : public uct_p2p_rma_test {
+protected:
+    ucs_status_t post(ucs_status_t (*func)(uct_ep_h, const uct_iov_t*, size_t,
+                                           uint64_t, uct_rkey_t,
+                                           uct_completion_t*),
+                      const mapped_buffer &localbuf,
+                      const mapped_buffer &remotebuf, uct_completion_t *comp)
+    {
+        ucs_status_t status;
+
+        for (;;) {
+            status = func(sender_ep(), localbuf.iov(), 1, remotebuf.addr(),
+                          remotebuf.rkey(), comp);
+            if (status != UCS_ERR_NO_RESOURCE) {
+                return status;
+            }
+
+            progress();
+        }
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_p2p_rma_tcp_get, put_get,
+                     !check_caps(UCT_IFACE_FLAG_PUT_ZCOPY |
+                                 UCT_IFACE_FLAG_GET_ZCOPY)) {
+    /* the response is sent by one or many send operations */
+    static const size_t lengths[] = {1, 4 * UCS_KBYTE, UCS_MBYTE + 7,
+                                     16 * UCS_MBYTE + 1};
+
+    for (size_t length : lengths) {
+        mapped_buffer sendbuf(length, SEED1, sender());
+        mapped_buffer getbuf(length, 0, sender());
+        mapped_buffer recvbuf(length, SEED2, receiver());
+        uct_completion_t put_comp, get_comp;
+        ucs_status_t status;
+
+        put_comp.func   = (uct_completion_callback_t)ucs_empty_function;
+        put_comp.count  = 2;
+        put_comp.status = UCS_OK;
+        get_comp        = put_comp;
+        get_comp.count  = 1;
+
+        /* GET response is sent after the data of the preceding PUT is
+         * placed, and the ACK of the following PUT mustn't complete the
+         * GET before the response is received */
+        status = post(uct_ep_put_zcopy, sendbuf, recvbuf, &put_comp);
+        ASSERT_EQ(UCS_INPROGRESS, status);
+        status = post(uct_ep_get_zcopy, getbuf, recvbuf, &get_comp);
+        ASSERT_EQ(UCS_INPROGRESS, status);
+        status = post(uct_ep_put_zcopy, sendbuf, recvbuf, &put_comp);
+        ASSERT_EQ(UCS_INPROGRESS, status);
+
+        wait_for_value(&get_comp.count, 0, true);
+        ASSERT_EQ(0, get_comp.count);
+        ASSERT_UCS_OK(get_comp.status);
+        getbuf.pattern_check(SEED1);
+
+        wait_for_value(&put_comp.count, 0, true);
+        ASSERT_EQ(0, put_comp.count);
+        ASSERT_UCS_OK(put_comp.status);
+    }
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_p2p_rma_tcp_get, tcp)